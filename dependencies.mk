@@ -30,7 +30,8 @@ TEST_DEPENDENCIES = \
 # Linux dependencies
 LINUX_DEPENDENCIES = 
 
-LINUX_TEST_DEPENDENCIES =
+LINUX_TEST_DEPENDENCIES = \
+  LIBPTHREAD
 
 ifeq ($(PLATFORM),Linux)
   DEPENDENCIES             += $(LINUX_DEPENDENCIES)
@@ -41,7 +42,8 @@ endif
 # BSD dependencies
 BSD_DEPENDENCIES = 
 
-BSD_TEST_DEPENDENCIES =
+BSD_TEST_DEPENDENCIES = \
+  LIBPTHREAD
 
 ifeq ($(PLATFORM),BSD)
   DEPENDENCIES             += $(BSD_DEPENDENCIES)
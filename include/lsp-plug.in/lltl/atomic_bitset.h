@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_LLTL_ATOMIC_BITSET_H_
+#define LSP_PLUG_IN_LLTL_ATOMIC_BITSET_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        /**
+         * Set of bits which allows concurrent modification of bits from different threads.
+         * Each modification of the bit is performed as atomic operation on the word containing
+         * the bit, so the bitset can be used as a lock-free slot allocator with claim() and
+         * unset() methods.
+         *
+         * Methods that change the size of the bitset are not thread-safe and should be
+         * called when there is no concurrent access from another threads.
+         */
+        class LSP_LLTL_LIB_PUBLIC atomic_bitset
+        {
+            protected:
+                size_t          nSize;
+                size_t          nCapacity;
+                umword_t       *vData;
+
+            protected:
+                umword_t        valid_bits(size_t word) const;
+                ssize_t         claim_range(size_t first, size_t last);
+
+            public:
+                explicit        atomic_bitset();
+                atomic_bitset(const atomic_bitset &) = delete;
+                atomic_bitset(atomic_bitset &&) = delete;
+                ~atomic_bitset();
+
+                atomic_bitset &operator = (const atomic_bitset &) = delete;
+                atomic_bitset &operator = (atomic_bitset &&) = delete;
+
+            public:
+                inline bool     is_empty() const            { return nSize == 0;                    }
+                inline size_t   size() const                { return nSize;                         }
+                inline size_t   capacity() const            { return nCapacity * sizeof(umword_t);  }
+
+            public:
+                /**
+                 * Resize the bitset, thread-unsafe method
+                 * @param size new size of the bitset
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            resize(size_t size);
+
+                /**
+                 * Drop all data, thread-unsafe method
+                 */
+                void            flush();
+
+            public:
+                /**
+                 * Get the value of bit
+                 * @param index index of the bit
+                 * @return value of the bit, false if the index is out of range
+                 */
+                bool            get(size_t index) const;
+
+                /**
+                 * Atomically set the bit
+                 * @param index index of the bit
+                 * @return previous value of the bit
+                 */
+                bool            set(size_t index);
+
+                /**
+                 * Atomically set the value of the bit
+                 * @param index index of the bit
+                 * @param value value to set
+                 * @return previous value of the bit
+                 */
+                bool            set(size_t index, bool value);
+
+                /**
+                 * Atomically reset the bit
+                 * @param index index of the bit
+                 * @return previous value of the bit
+                 */
+                bool            unset(size_t index);
+
+                /**
+                 * Atomically toggle the bit
+                 * @param index index of the bit
+                 * @return previous value of the bit
+                 */
+                bool            toggle(size_t index);
+
+                /**
+                 * Try to atomically set the bit which is not set yet. Unlike set(),
+                 * returns true when the bit is owned by the caller after the call.
+                 * @param index index of the bit
+                 * @return true if the bit has been changed from 0 to 1 by this call,
+                 *   false if the bit was already set or the index is out of range
+                 */
+                inline bool     try_set(size_t index)       { return (index < nSize) && (!set(index)); }
+
+                /**
+                 * Set all bits, each word of the bitset is modified atomically
+                 */
+                void            set_all();
+
+                /**
+                 * Reset all bits, each word of the bitset is modified atomically
+                 */
+                void            unset_all();
+
+            public:
+                /**
+                 * Find first unset bit and atomically set it. Lock-free method.
+                 * @return index of the claimed bit or negative value if all bits are set
+                 */
+                inline ssize_t  claim()                     { return claim(0);                      }
+
+                /**
+                 * Find first unset bit starting with the hint and atomically set it.
+                 * The search wraps around the end of the bitset. Using different hints for
+                 * different threads reduces contention. Lock-free method.
+                 * @param hint index of the bit to start the search
+                 * @return index of the claimed bit or negative value if all bits are set
+                 */
+                ssize_t         claim(size_t hint);
+
+                /**
+                 * Get number of set bits. The result is not an atomic snapshot of the bitset
+                 * if the bitset is modified concurrently.
+                 * @return number of set bits
+                 */
+                size_t          count() const;
+        };
+
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_ATOMIC_BITSET_H_ */
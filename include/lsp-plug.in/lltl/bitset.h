@@ -37,6 +37,11 @@ namespace lsp
                 size_t          nCapacity;
                 umword_t       *vData;
 
+            protected:
+                inline size_t   words() const               { return (nSize + UMWORD_BITS - 1) / UMWORD_BITS; }
+                void            trim();
+                ssize_t         find(size_t index, umword_t invert) const;
+
             public:
                 explicit        bitset();
                 bitset(const bitset &) = delete;
@@ -73,6 +78,69 @@ namespace lsp
                 bool            toggle(size_t index);
                 size_t          toggle(size_t index, size_t count);
 
+            public:
+                /**
+                 * Perform bitwise AND with another bitset: this = this & src.
+                 * Bits missing in the source bitset are considered to be zero.
+                 * @param src source bitset
+                 */
+                void            bitwise_and(const bitset *src);
+
+                /**
+                 * Perform bitwise OR with another bitset: this = this | src.
+                 * Bits of the source bitset beyond the size of this bitset are ignored.
+                 * @param src source bitset
+                 */
+                void            bitwise_or(const bitset *src);
+
+                /**
+                 * Perform bitwise XOR with another bitset: this = this ^ src.
+                 * Bits of the source bitset beyond the size of this bitset are ignored.
+                 * @param src source bitset
+                 */
+                void            bitwise_xor(const bitset *src);
+
+                /**
+                 * Clear all bits which are set in another bitset: this = this & ~src.
+                 * Bits of the source bitset beyond the size of this bitset are ignored.
+                 * @param src source bitset
+                 */
+                void            bitwise_andnot(const bitset *src);
+
+            public:
+                /**
+                 * Get number of set bits
+                 * @return number of set bits
+                 */
+                size_t          count() const;
+
+                /**
+                 * Find first set bit. All set bits can be enumerated in the following way:
+                 *   for (ssize_t i = bs.find_first(); i >= 0; i = bs.find_next(i)) { ... }
+                 * @return index of the first set bit or negative value if there are no set bits
+                 */
+                inline ssize_t  find_first() const                  { return find(0, 0);                    }
+
+                /**
+                 * Find next set bit after the specified index
+                 * @param index index of the bit to start search after
+                 * @return index of the next set bit or negative value if there are no set bits
+                 */
+                inline ssize_t  find_next(size_t index) const       { return find(index + 1, 0);            }
+
+                /**
+                 * Find first unset bit
+                 * @return index of the first unset bit or negative value if all bits are set
+                 */
+                inline ssize_t  find_first_unset() const            { return find(0, UMWORD_MAX);           }
+
+                /**
+                 * Find next unset bit after the specified index
+                 * @param index index of the bit to start search after
+                 * @return index of the next unset bit or negative value if there are no unset bits
+                 */
+                inline ssize_t  find_next_unset(size_t index) const { return find(index + 1, UMWORD_MAX);   }
+
             public:
                 void            swap(bitset *dst);
         };
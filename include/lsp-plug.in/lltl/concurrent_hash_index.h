@@ -0,0 +1,318 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_LLTL_CONCURRENT_HASH_INDEX_H_
+#define LSP_PLUG_IN_LLTL_CONCURRENT_HASH_INDEX_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/lltl/hash_index.h>
+#include <lsp-plug.in/common/atomic.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static constexpr size_t raw_concurrent_hash_stripes     = 0x10;
+        static constexpr size_t raw_concurrent_hash_readers     = 0x10;
+        static constexpr size_t raw_concurrent_hash_padding     = 0x40;
+
+        struct LSP_LLTL_LIB_PUBLIC raw_concurrent_hash_index
+        {
+            public:
+                typedef raw_hash_index::node_t node_t;
+
+                typedef struct garbage_t
+                {
+                    garbage_t  *next;       // Next retired object
+                } garbage_t;
+
+                typedef struct chain_t
+                {
+                    garbage_t   gc;         // Garbage collection link, should be first
+                    size_t      size;       // Number of items in chain
+                    node_t      nodes[];    // Nodes of the chain
+                } chain_t;
+
+                typedef struct table_t
+                {
+                    garbage_t   gc;         // Garbage collection link, should be first
+                    size_t      cap;        // Capacity in bins
+                    chain_t    *bins[];     // Immutable chains of items
+                } table_t;
+
+                typedef struct counter_t
+                {
+                    uatomic_t   value;      // Number of active readers
+                    uint8_t     pad[raw_concurrent_hash_padding - sizeof(uatomic_t)];
+                } counter_t;
+
+            public:
+                table_t        *table;      // Current table
+                uatomic_t       size;       // Overall size of the index
+                uatomic_t       epoch;      // Current reclamation epoch
+                atomic_t        locks[raw_concurrent_hash_stripes];     // Writer locks
+                atomic_t        gc_lock;    // Garbage collector lock
+                garbage_t      *retired;    // Objects retired by writers
+                garbage_t      *collected;  // Objects retired in current epoch
+                garbage_t      *pending;    // Objects waiting for readers of previous epoch
+                counter_t       readers[2][raw_concurrent_hash_readers];  // Reader counters for each epoch
+                size_t          ksize;      // Size of key object
+                hash_iface      hash;       // Hash interface
+                compare_iface   cmp;        // Compare interface
+
+            protected:
+                counter_t      *read_lock();
+                static void     read_unlock(counter_t *counter);
+                void            lock(size_t hash);
+                void            unlock(size_t hash);
+                void            lock_all();
+                void            unlock_all();
+                size_t          active_readers(size_t parity);
+                void            retire(void *ptr);
+                table_t        *acquire_table();
+                bool            grow();
+
+                static table_t *alloc_table(size_t cap);
+                static chain_t *alloc_chain(size_t count);
+                static raw_pair_t  *item_at(chain_t *chain, size_t index);
+                static size_t  &hash_at(chain_t *chain, size_t index);
+                static void     append(chain_t *chain, size_t hash, const raw_pair_t *item);
+                static void     free_list(garbage_t *list);
+
+                ssize_t         index_of(chain_t *chain, const void *key, size_t hash);
+                raw_pair_t     *find(const void *key, size_t hash);
+                bool            copy_chain(chain_t **dst, chain_t *src, size_t skip, size_t extra);
+
+            public:
+                void            init();
+                void            flush();
+                void            clear();
+                void            gc();
+                void           *get(const void *key, void *dfl);
+                void           *key(const void *key, void *dfl);
+                bool            contains(const void *key);
+                bool            put(const void *key, void *value, void **ov);
+                bool            replace(const void *key, void *value, void **ov);
+                bool            create(const void *key, void *value);
+                bool            remove(const void *key, void **ov);
+                bool            keys(raw_parray *k);
+                bool            values(raw_parray *v);
+                bool            items(raw_parray *k, raw_parray *v);
+        };
+
+
+        /**
+         * Concurrent implementation of key-value hash mapping.
+         * Keys and values should be manually managed.
+         *
+         * Items are stored in immutable chains of nodes with the same layout as in hash_index.
+         * Readers are lock-free and never block: they announce themselves in the per-epoch
+         * counters and walk the chain of the bin. Writers lock only the stripe the key belongs
+         * to, build the modified copy of the chain and publish it, so writers of different
+         * stripes do not contend. Replaced chains are reclaimed by the epoch-based garbage
+         * collector after all readers that could observe them have left.
+         */
+        template <class K, class V>
+        class concurrent_hash_index
+        {
+            private:
+                mutable raw_concurrent_hash_index  v;
+
+                inline static K *kcast(void *ptr)       { return static_cast<K *>(ptr);             }
+                inline static V *vcast(void *ptr)       { return static_cast<V *>(ptr);             }
+                inline static void **pvcast(V **ptr)    { return reinterpret_cast<void **>(ptr);    }
+
+            public:
+                explicit inline concurrent_hash_index()
+                {
+                    hash_spec<K>        hash;
+                    compare_spec<K>     cmp;
+
+                    v.init();
+                    v.ksize         = sizeof(K);
+                    v.hash          = hash;
+                    v.cmp           = cmp;
+                }
+
+                explicit inline concurrent_hash_index(hash_iface hash, compare_iface cmp)
+                {
+                    v.init();
+                    v.ksize         = sizeof(K);
+                    v.hash          = hash;
+                    v.cmp           = cmp;
+                }
+
+                concurrent_hash_index(const concurrent_hash_index & src) = delete;
+                concurrent_hash_index(concurrent_hash_index && src) = delete;
+                concurrent_hash_index & operator = (const concurrent_hash_index & src) = delete;
+                concurrent_hash_index & operator = (concurrent_hash_index && src) = delete;
+
+                ~concurrent_hash_index()                                { v.flush();                                                    }
+
+            public:
+                /**
+                 * Get number of stored elements in collection.
+                 * Thread-safe method.
+                 * @return number of stored elements in collection
+                 */
+                inline size_t       size() const                        { return atomic_load(&v.size);                                  }
+
+                /**
+                 * Check whether collection is empty.
+                 * Thread-safe method.
+                 * @return true if collection does not contain any element
+                 */
+                inline bool         is_empty() const                    { return atomic_load(&v.size) <= 0;                             }
+
+            public:
+                /**
+                 * Remove all items from collection.
+                 * Thread-safe method. Caller is responsible for destroying keys and values.
+                 */
+                inline void clear()                                     { v.clear();                                                    }
+
+                /**
+                 * Destroy all data including the garbage.
+                 * Thread-unsafe method. Should be called when there is no concurrent access from another threads.
+                 */
+                inline void flush()                                     { v.flush();                                                    }
+
+                /**
+                 * Try to reclaim memory retired by writers. Writers call this method automatically,
+                 * so explicit call is required only to release memory when there are no writes.
+                 * Thread-safe and non-blocking method: it does nothing if another thread collects
+                 * the garbage or readers of the previous epoch are still active.
+                 */
+                inline void gc()                                        { v.gc();                                                       }
+
+            public:
+                /**
+                 * Check that value associated with key exists (same to contains).
+                 * Lock-free method.
+                 * @param key key
+                 * @return true if value exists
+                 */
+                inline bool exists(const K *key) const                  { return v.contains(key);                                       }
+
+                /**
+                 * Check that value associated with key exists (same to exists).
+                 * Lock-free method.
+                 * @param key key
+                 * @return true if value exists
+                 */
+                inline bool contains(const K *key) const                { return v.contains(key);                                       }
+
+                /**
+                 * Get pointer to the key in the storage.
+                 * Lock-free method.
+                 * @param key key to use
+                 * @return associated key in the storage or NULL if not exists
+                 */
+                inline K *key(const K *key) const                       { return kcast(v.key(key, NULL));                               }
+
+                /**
+                 * Get value by key.
+                 * Lock-free method.
+                 * @param key key to use
+                 * @return associated value or NULL if not exists
+                 */
+                inline V *get(const K *key) const                       { return vcast(v.get(key, NULL));                               }
+
+                /**
+                 * Get value by key or return default value if the value in hash was not found.
+                 * Lock-free method.
+                 * @param key key to use
+                 * @param dfl default value to return if there is no such key in the hash
+                 * @return the associated value
+                 */
+                inline V *dget(const K *key, V *dfl) const              { return vcast(v.get(key, dfl));                                }
+
+            public:
+                /**
+                 * Put the value to the index.
+                 * Thread-safe method, locks the stripe of the key.
+                 * @param key key to use
+                 * @param value value to put
+                 * @param ov value removed from index
+                 * @return true on success, false if no allocation possible
+                 */
+                inline bool put(const K *key, V *value, V **ov)         { return v.put(key, value, pvcast(ov));                         }
+
+                /**
+                 * Create the entry, do nothing if there is already existing entry with such key.
+                 * Thread-safe method, locks the stripe of the key.
+                 * @param key key to use
+                 * @param value value to use
+                 * @return true if the entry has been created
+                 */
+                inline bool create(const K *key, V *value)              { return v.create(key, value);                                  }
+
+                /**
+                 * Replace the entry ONLY if it exists.
+                 * Thread-safe method, locks the stripe of the key.
+                 * @param key key to use
+                 * @param value value to use
+                 * @param ov value removed from hash
+                 * @return true if the entry has been replaced
+                 */
+                inline bool replace(const K *key, V *value, V **ov)     { return v.replace(key, value, pvcast(ov));                     }
+
+                /**
+                 * Remove the associated key.
+                 * Thread-safe method, locks the stripe of the key.
+                 * @param key the key to use for seacrh
+                 * @param ov value removed from hash
+                 * @return true if the data has been removed
+                 */
+                inline bool remove(const K *key, V **ov)                { return v.remove(key, pvcast(ov));                             }
+
+            public:
+                /**
+                 * Store all keys to destination array.
+                 * Lock-free method, the result is not an atomic snapshot of the collection.
+                 * @param vk array to store keys
+                 * @return true if all keys have been successfully stored
+                 */
+                inline bool keys(parray<K> *vk) const                   { return v.keys(vk->raw());                                     }
+
+                /**
+                 * Store all values to destination array.
+                 * Lock-free method, the result is not an atomic snapshot of the collection.
+                 * @param vv array to store values
+                 * @return true if all keys have been successfully stored
+                 */
+                inline bool values(parray<V> *vv) const                 { return v.values(vv->raw());                                   }
+
+                /**
+                 * Store all items to destination array.
+                 * Lock-free method, the result is not an atomic snapshot of the collection.
+                 * @param vk array to store keys
+                 * @param vv array to store values
+                 * @return true if all keys have been successfully stored
+                 */
+                inline bool items(parray<K> *vk, parray<V> *vv) const   { return v.items(vk->raw(), vv->raw());                         }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_CONCURRENT_HASH_INDEX_H_ */
@@ -45,6 +45,9 @@ namespace lsp
                 uint8_t    *vItems;
                 size_t      nCapacity;
                 size_t      nSizeOf;
+                size_t      nAlign;         // Alignment of heap storage, 0 for default
+                uint8_t    *vInline;        // Inline storage, NULL if not present
+                size_t      nInline;        // Capacity of inline storage
 
             public:
                 static const iter_vtbl_t    iterator_vtbl;
@@ -56,13 +59,19 @@ namespace lsp
                 static int  closure_cmp(const void *a, const void *b, void *c);
                 static int  raw_cmp(const void *a, const void *b, void *c);
 
+                bool        detach();
+                void        attach();
+
             public:
                 void        init(size_t n_sizeof);
+                void        init(size_t n_sizeof, size_t align);
+                void        init(size_t n_sizeof, uint8_t *buf, size_t capacity);
                 bool        grow(size_t capacity);
                 bool        truncate(size_t capacity);
                 void        flush();
+                uint8_t    *release();
 
-                void        swap(raw_darray *src);
+                bool        swap(raw_darray *src);
                 bool        xswap(size_t i1, size_t i2);
                 void        uswap(size_t i1, size_t i2);
                 ssize_t     index_of(const void *ptr);
@@ -96,6 +105,14 @@ namespace lsp
                 void        ssort(cmp_func_t f);
                 void        ssort(sort_closure_t *c);
 
+                void        pqsort(cmp_func_t f, executor_iface *executor);
+                void        pqsort(sort_closure_t *c, executor_iface *executor);
+
+                void        pssort(cmp_func_t f, executor_iface *executor);
+                void        pssort(sort_closure_t *c, executor_iface *executor);
+
+                bool        rsort(size_t offset, const radix_iface *key);
+
                 raw_iterator    iter();
                 raw_iterator    riter();
 
@@ -112,9 +129,10 @@ namespace lsp
         template <class T>
         class darray
         {
-            private:
+            protected:
                 mutable raw_darray    v;
 
+            private:
                 inline static T *cast(void *ptr)                                { return static_cast<T *>(ptr);         }
                 inline static const T *ccast(const void *ptr)                   { return static_cast<const T *>(ptr);   }
 
@@ -128,6 +146,20 @@ namespace lsp
                     v.vItems        = NULL;
                     v.nCapacity     = 0;
                     v.nSizeOf       = sizeof(T);
+                    v.nAlign        = 0;
+                    v.vInline       = NULL;
+                    v.nInline       = 0;
+                }
+
+                /**
+                 * Create array which keeps the data aligned in memory. The alignment
+                 * is preserved on any reallocation of the storage.
+                 * @param align alignment of the data in bytes, should be power of two,
+                 *   0 means the default alignment provided by the allocator
+                 */
+                explicit inline darray(size_t align)
+                {
+                    v.init(sizeof(T), align);
                 }
 
                 darray(const darray<T> & src) = delete;
@@ -142,6 +174,7 @@ namespace lsp
                 inline size_t size() const                                      { return v.nItems;                  }
                 inline size_t capacity() const                                  { return v.nCapacity;               }
                 inline bool is_empty() const                                    { return v.nItems <= 0;             }
+                inline size_t alignment() const                                 { return v.nAlign;                  }
 
             public:
                 // Whole collection manipulations
@@ -150,17 +183,9 @@ namespace lsp
                 inline void truncate()                                          { v.flush();                        }
                 inline bool truncate(size_t size)                               { return v.truncate(size);          }
                 inline bool reserve(size_t capacity)                            { return v.grow(capacity);          }
-                inline void swap(darray<T> &src)                                { v.swap(&src.v);                   }
-                inline void swap(darray<T> *src)                                { v.swap(&src->v);                  }
-                inline T   *release()
-                {
-                    T *ptr          = cast(v.vItems);
-                    v.nItems        = 0;
-                    v.vItems        = NULL;
-                    v.nCapacity     = 0;
-                    v.nSizeOf       = sizeof(T);
-                    return ptr;
-                }
+                inline bool swap(darray<T> &src)                                { return v.swap(&src.v);            }
+                inline bool swap(darray<T> *src)                                { return v.swap(&src->v);           }
+                inline T   *release()                                           { return cast(v.release());         }
 
             public:
                 // Accessing elements (non-const)
@@ -357,6 +382,105 @@ namespace lsp
                     v.ssort(&c);
                 }
 
+                /**
+                 * Perform sort of the array using the caller-provided pool of workers. Chunks of
+                 * the array are sorted simultaneously and then merged. Falls back to the sequential
+                 * qsort() if the executor is NULL or the array is small.
+                 * @param cmp comparison function
+                 * @param executor executor to run sorting tasks
+                 */
+                inline void pqsort(cmp_func_t cmp, executor_iface *executor)
+                {
+                    v.pqsort(reinterpret_cast<raw_darray::cmp_func_t>(cmp), executor);
+                }
+
+                inline void pqsort(compare_func_t cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                inline void pqsort(const compare_iface &cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp.compare;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                inline void pqsort(executor_iface *executor)
+                {
+                    compare_spec<T> spec;
+                    sort_closure_t c;
+                    c.compare       = spec.compare;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                /**
+                 * Perform stable sort of the array using the caller-provided pool of workers. Chunks of
+                 * the array are sorted simultaneously and then merged. Falls back to the sequential
+                 * ssort() if the executor is NULL or the array is small.
+                 * @param cmp comparison function
+                 * @param executor executor to run sorting tasks
+                 */
+                inline void pssort(cmp_func_t cmp, executor_iface *executor)
+                {
+                    v.pssort(reinterpret_cast<raw_darray::cmp_func_t>(cmp), executor);
+                }
+
+                inline void pssort(compare_func_t cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                inline void pssort(const compare_iface &cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp.compare;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                inline void pssort(executor_iface *executor)
+                {
+                    compare_spec<T> spec;
+                    sort_closure_t c;
+                    c.compare       = spec.compare;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                /**
+                 * Perform stable radix sort of elements, applicable only if the element
+                 * is a plain integer or floating-point number. Does not call any comparison
+                 * functions.
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool rsort()
+                {
+                    radix_spec<T> key;
+                    return v.rsort(0, &key);
+                }
+
+                /**
+                 * Perform stable radix sort of elements by the plain integer or
+                 * floating-point key stored in each element.
+                 * @param offset offset of the key field of type K in the element
+                 * @return true on success, false on invalid key or memory allocation error
+                 */
+                template <class K>
+                inline bool rsort(size_t offset)
+                {
+                    radix_spec<K> key;
+                    return v.rsort(offset, &key);
+                }
+
             public:
                 // Operators
                 inline T *operator[](size_t idx)                                { return get(idx);                  }
@@ -59,6 +59,10 @@ namespace lsp
                 size_t      nUnused;        // Number of unused chunks
                 size_t      nSizeOf;        // Size of one element stored in the deque
                 size_t      nChunkSize;     // Size of one chunk in elements
+                chunk_t   **vDir;           // Directory of used chunks, circular buffer
+                size_t      nDirCap;        // Capacity of the directory, power of two
+                size_t      nDirHead;       // Position of the head chunk in the directory
+                size_t      nDirSize;       // Number of chunks in the directory
 
             private:
                 chunk_t        *acquire_chunk();
@@ -71,6 +75,13 @@ namespace lsp
                 chunk_t        *preallocate_front(size_t count);
                 chunk_t        *preallocate_back(size_t count);
                 inline void     forward_copy(void *dst, const void *src, size_t count);
+                bool            dir_reserve(size_t count);
+                inline void     dir_push_back(chunk_t *chunk);
+                inline void     dir_push_front(chunk_t *chunk);
+                inline void     dir_pop_back();
+                inline void     dir_pop_front();
+                inline chunk_t *dir_at(size_t index) const;
+                chunk_t        *locate(size_t index, size_t *offset) const;
                 inline void     reverse_copy(void *dst, const void *src, size_t count);
 
             public:
@@ -66,6 +66,8 @@ namespace lsp
                 size_t          size;       // Overall size of the hash
                 size_t          cap;        // Capacity in bins
                 bin_t          *bins;       // Overall array of bins
+                node_t         *pool;       // List of free nodes
+                size_t          pooled;     // Number of free nodes
                 size_t          ksize;      // Size of key object
                 hash_iface      hash;       // Hash interface
                 compare_iface   cmp;        // Compare interface
@@ -73,19 +75,31 @@ namespace lsp
             protected:
                 void            destroy_bin(bin_t *bin);
                 bool            grow();
-                static bool     add_to_bin(bin_t *bin, node_t **free_list, size_t hash, const raw_pair_t *data);
-                static void     free_nodes(bin_t *bin, node_t **free_list, node_t *node);
+                node_t         *alloc_node();
+                void            free_node(node_t *node);
+                bool            alloc_nodes(size_t count);
+                void            destroy_pool();
+                size_t          used_nodes() const;
+                bool            add_to_bin(bin_t *bin, size_t hash, const raw_pair_t *data);
+                void            release_nodes(bin_t *bin, node_t *node);
+                bool            rehash(size_t ncap);
 
                 lookup_t        find_node(const void *key, size_t hash);
+                lookup_t        find_in_bin(const bin_t *bin, const void *key, size_t hash);
+                size_t          lookup_n(size_t n, const void * const *keys, lookup_t *found);
                 raw_pair_t     *create_item(const void *key, size_t hash);
 
             public:
                 void            flush();
                 void            clear();
                 void            swap(raw_hash_index *src);
+                bool            reserve(size_t count);
+                bool            shrink_to_fit();
                 void           *get(const void *key, void *dfl);
                 void           *key(const void *key, void *dfl);
                 void          **wbget(const void *key);
+                size_t          get_n(size_t n, const void * const *keys, void **values, void *dfl);
+                size_t          contains_n(size_t n, const void * const *keys, bool *found);
                 void          **put(const void *key, void *value, void **ov);
                 void          **replace(const void *key, void *value, void **ov);
                 void          **create(const void *key, void *value);
@@ -124,6 +138,7 @@ namespace lsp
                 inline static K **pkcast(void *ptr)     { return reinterpret_cast<K **>(ptr);       }
                 inline static void **pvcast(V **ptr)    { return reinterpret_cast<void **>(ptr);    }
                 inline static void **pkcast(K **ptr)    { return reinterpret_cast<void **>(ptr);    }
+                inline static const void * const *pkcast(const K * const *ptr)  { return reinterpret_cast<const void * const *>(ptr);   }
 
             public:
                 explicit inline hash_index()
@@ -133,6 +148,8 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.pool          = NULL;
+                    v.pooled        = 0;
                     v.ksize         = sizeof(K);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -143,6 +160,8 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.pool          = NULL;
+                    v.pooled        = 0;
                     v.ksize         = sizeof(K);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -201,6 +220,23 @@ namespace lsp
                  */
                 inline void swap(hash_index<K, V> *src)                 { v.swap(&src->v);                                               }
 
+                /**
+                 * Preallocate bins and nodes, so that inserting items into the collection until it
+                 * contains the specified number of items does not allocate memory. Nodes of removed
+                 * items are kept for reuse until the collection is flushed or shrunk.
+                 *
+                 * @param count number of items to reserve memory for
+                 * @return true on success
+                 */
+                inline bool reserve(size_t count)                       { return v.reserve(count);                                      }
+
+                /**
+                 * Reduce the number of bins to the minimum required for current number of items
+                 * and release all unused nodes.
+                 * @return true on success
+                 */
+                inline bool shrink_to_fit()                             { return v.shrink_to_fit();                                     }
+
             public:
                 /**
                  * Check that value associated with key exists (same to contains)
@@ -245,6 +281,39 @@ namespace lsp
                  */
                 inline V **wbget(const K *key)                          { return pvcast(v.wbget(key));                                  }
 
+                /**
+                 * Get values for the batch of keys. All keys are hashed first, and memory of the
+                 * target bins is prefetched before lookup, so memory access latencies of different
+                 * keys overlap instead of being serialized.
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param values array to store values, NULL is stored for keys that do not exist
+                 * @return number of keys found
+                 */
+                inline size_t get_n(size_t n, const K * const *keys, V **values) const
+                                                                        { return v.get_n(n, pkcast(keys), pvcast(values), NULL);        }
+
+                /**
+                 * Get values for the batch of keys or default value for keys that do not exist
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param values array to store values
+                 * @param dfl default value to store for keys that do not exist
+                 * @return number of keys found
+                 */
+                inline size_t dget_n(size_t n, const K * const *keys, V **values, V *dfl) const
+                                                                        { return v.get_n(n, pkcast(keys), pvcast(values), dfl);         }
+
+                /**
+                 * Check the presence of the batch of keys
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param found array to store presence flag for each key, may be NULL
+                 * @return number of keys found
+                 */
+                inline size_t contains_n(size_t n, const K * const *keys, bool *found) const
+                                                                        { return v.contains_n(n, pkcast(keys), found);                  }
+
             public:
                 /**
                  * Put the value to the index
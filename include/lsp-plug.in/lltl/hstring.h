@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_LLTL_HSTRING_H_
+#define LSP_PLUG_IN_LLTL_HSTRING_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        /**
+         * String with precomputed hash and length, can be used as a key of hash containers
+         * instead of C string: hash containers take the hash value without scanning the string
+         * and compare strings with memcmp() over the known length.
+         */
+        struct hstring
+        {
+            size_t          hash;       // Precomputed hash value, same to fast_char_hash_func()
+            size_t          length;     // Length of the string in bytes without terminating zero
+            char            data[];     // Characters of the string with terminating zero
+        };
+
+        /**
+         * Get number of bytes required to store string of specified length
+         * @param length length of the string in bytes
+         * @return number of bytes required to store the string
+         */
+        inline size_t hstring_size(size_t length)
+        {
+            return sizeof(hstring) + length + 1;
+        }
+
+        /**
+         * Initialize string in the caller-provided buffer, useful for lookups without memory allocation
+         * @param buf buffer of at least hstring_size(length) bytes aligned to the size_t
+         * @param s pointer to characters
+         * @param length number of characters
+         * @return pointer to the initialized string
+         */
+        LSP_LLTL_LIB_PUBLIC
+        hstring    *hstring_init(void *buf, const char *s, size_t length);
+
+        /**
+         * Create string
+         * @param s pointer to characters
+         * @param length number of characters
+         * @return pointer to the created string or NULL if there is no memory,
+         *   should be destroyed with hstring_free()
+         */
+        LSP_LLTL_LIB_PUBLIC
+        hstring    *hstring_create(const char *s, size_t length);
+
+        /**
+         * Create string from the C string
+         * @param s C string
+         * @return pointer to the created string or NULL if there is no memory,
+         *   should be destroyed with hstring_free()
+         */
+        LSP_LLTL_LIB_PUBLIC
+        hstring    *hstring_create(const char *s);
+
+        /**
+         * Destroy string
+         * @param s string to destroy, may be NULL
+         */
+        LSP_LLTL_LIB_PUBLIC
+        void        hstring_free(hstring *s);
+
+        /**
+         * Hash function for strings, returns precomputed hash value
+         * @param ptr pointer to the string
+         * @param size size of hstring type (not used)
+         * @return hash value
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      hstring_hash_func(const void *ptr, size_t size);
+
+        /**
+         * Seeded hash function for strings, computes the hash value over the known length
+         * @param ptr pointer to the string
+         * @param size size of hstring type (not used)
+         * @param seed seed of the hash function
+         * @return hash value
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      hstring_seeded_hash_func(const void *ptr, size_t size, uint64_t seed);
+
+        /**
+         * Comparison function for strings: shorter strings precede longer strings,
+         * strings of the same length are compared bytewise
+         * @param a string a
+         * @param b string b
+         * @param size size of hstring type (not used)
+         * @return comparison result
+         */
+        LSP_LLTL_LIB_PUBLIC
+        ssize_t     hstring_cmp_func(const void *a, const void *b, size_t size);
+
+        /**
+         * Copying function for strings
+         * @param ptr pointer to the string
+         * @param size size of hstring type (not used)
+         * @return pointer to the copy of string
+         */
+        LSP_LLTL_LIB_PUBLIC
+        void       *hstring_clone_func(const void *ptr, size_t size);
+
+        //---------------------------------------------------------------------
+        // Specialization for strings with precomputed hash
+        template <>
+        struct hash_spec<hstring>: public hash_iface
+        {
+            inline hash_spec(): hash_iface()
+            {
+                hash        = hstring_hash_func;
+            }
+        };
+
+        template <>
+        struct fast_hash_spec<hstring>: public hash_iface
+        {
+            inline fast_hash_spec(): hash_iface()
+            {
+                hash        = hstring_hash_func;
+            }
+        };
+
+        template <>
+        struct seeded_hash_spec<hstring>: public hash_iface
+        {
+            explicit inline seeded_hash_spec(uint64_t seed = make_hash_seed()): hash_iface()
+            {
+                this->hash      = hstring_hash_func;
+                this->seeded    = hstring_seeded_hash_func;
+                this->seed      = seed;
+            }
+        };
+
+        template <>
+        struct compare_spec<hstring>: public compare_iface
+        {
+            inline compare_spec()
+            {
+                compare     = hstring_cmp_func;
+            }
+        };
+
+        template <>
+        struct allocator_spec<hstring>: public allocator_iface
+        {
+            inline allocator_spec()
+            {
+                clone       = hstring_clone_func;
+                free        = ::free;
+            }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_HSTRING_H_ */
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_LLTL_MPMC_QUEUE_H_
+#define LSP_PLUG_IN_LLTL_MPMC_QUEUE_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/common/atomic.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static constexpr size_t raw_mpmc_queue_padding      = 0x40;
+
+        /**
+         * Raw bounded multi-producer multi-consumer queue implementation with fixed set of routines
+         */
+        struct LSP_LLTL_LIB_PUBLIC raw_mpmc_queue
+        {
+            public:
+                typedef struct cell_t
+                {
+                    size_t          nSeq;           // Sequence number of the cell
+                } cell_t;
+
+            public:
+                size_t          nEnqueue;       // Position of the next element to enqueue
+                uint8_t         vPad1[raw_mpmc_queue_padding - sizeof(size_t)];
+                size_t          nDequeue;       // Position of the next element to dequeue
+                uint8_t         vPad2[raw_mpmc_queue_padding - sizeof(size_t)];
+
+                uint8_t        *vData;          // Allocated memory
+                uint8_t        *vCells;         // Aligned array of cells
+                size_t          nCapacity;      // Capacity of the queue, power of two
+                size_t          nStride;        // Size of one cell in bytes
+                size_t          nHeader;        // Offset of data in the cell
+                size_t          nSizeOf;        // Size of one element stored in the queue
+
+            protected:
+                inline cell_t  *cell(size_t position) const;
+
+            public:
+                void            init(size_t n_sizeof);
+                bool            init(size_t n_sizeof, size_t capacity);
+                void            flush();
+
+                bool            push(const void *data);
+                size_t          push(const void *data, size_t count);
+                bool            pop(void *data);
+                size_t          pop(void *data, size_t count);
+                size_t          size() const;
+        };
+
+        /**
+         * Bounded lock-free multi-producer multi-consumer queue of plain data structures.
+         *
+         * The queue is organized as a ring of cells, each cell carries the sequence number
+         * which tells producers and consumers whether the cell is free for writing or
+         * contains the data for reading. Producers and consumers reserve cells by advancing
+         * the shared positions and never wait for each other.
+         *
+         * Methods which are not marked as thread-safe should be called when there is
+         * no concurrent access to the queue.
+         */
+        template <class T>
+        class mpmc_queue
+        {
+            private:
+                mutable raw_mpmc_queue  v;
+
+            public:
+                explicit inline mpmc_queue()
+                {
+                    v.init(sizeof(T));
+                }
+
+                mpmc_queue(const mpmc_queue<T> & src) = delete;
+                mpmc_queue(mpmc_queue<T> && src) = delete;
+                ~mpmc_queue() { v.flush(); };
+
+                mpmc_queue<T> & operator = (const mpmc_queue<T> & src) = delete;
+                mpmc_queue<T> & operator = (mpmc_queue<T> && src) = delete;
+
+            public:
+                /**
+                 * Allocate storage for the queue and drop all previously stored elements.
+                 * Thread-unsafe method.
+                 * @param capacity the maximum number of elements, rounded up to the power of two
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool init(size_t capacity)                               { return v.init(sizeof(T), capacity);   }
+
+                /**
+                 * Drop all elements and free allocated memory.
+                 * Thread-unsafe method.
+                 */
+                inline void flush()                                             { v.flush();                            }
+
+            public:
+                /**
+                 * Get the maximum number of elements the queue can hold
+                 * @return capacity of the queue
+                 */
+                inline size_t capacity() const                                  { return v.nCapacity;                   }
+
+                /**
+                 * Get number of elements in the queue. The value is approximate if there is
+                 * concurrent access to the queue.
+                 * Thread-safe method.
+                 * @return number of elements in the queue
+                 */
+                inline size_t size() const                                      { return v.size();                      }
+
+                /**
+                 * Check whether queue is empty. The value is approximate if there is
+                 * concurrent access to the queue.
+                 * Thread-safe method.
+                 * @return true if queue is empty
+                 */
+                inline bool is_empty() const                                    { return v.size() <= 0;                 }
+
+            public:
+                /**
+                 * Push element to the queue.
+                 * Thread-safe lock-free method.
+                 * @param item element to push
+                 * @return true if element has been pushed, false if queue is full
+                 */
+                inline bool push(const T *item)                                 { return v.push(item);                  }
+                inline bool push(const T & item)                                { return v.push(&item);                 }
+
+                /**
+                 * Push multiple elements to the queue. Elements are pushed as one consecutive
+                 * sequence, the number of pushed elements can be less than requested if
+                 * there is not enough free space in the queue.
+                 * Thread-safe lock-free method.
+                 * @param data elements to push
+                 * @param count number of elements
+                 * @return number of pushed elements
+                 */
+                inline size_t push(const T *data, size_t count)                 { return v.push(data, count);           }
+
+                /**
+                 * Pop element from the queue.
+                 * Thread-safe lock-free method.
+                 * @param item pointer to store the element
+                 * @return true if element has been popped, false if queue is empty
+                 */
+                inline bool pop(T *item)                                        { return v.pop(item);                   }
+                inline bool pop(T & item)                                       { return v.pop(&item);                  }
+
+                /**
+                 * Pop multiple elements from the queue. Elements are popped as one consecutive
+                 * sequence.
+                 * Thread-safe lock-free method.
+                 * @param data pointer to store elements
+                 * @param count maximum number of elements to pop
+                 * @return number of popped elements
+                 */
+                inline size_t pop(T *data, size_t count)                        { return v.pop(data, count);            }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_MPMC_QUEUE_H_ */
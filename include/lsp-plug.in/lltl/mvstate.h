@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_LLTL_MVSTATE_H_
+#define LSP_PLUG_IN_LLTL_MVSTATE_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/common/atomic.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static constexpr size_t raw_mvstate_readers     = 0x20;
+        static constexpr size_t raw_mvstate_padding     = 0x40;
+
+        struct LSP_LLTL_LIB_PUBLIC raw_mvstate
+        {
+            public:
+                typedef void    (* deleter1_t)(void *ptr);
+                typedef void    (* deleter2_t)(void *ptr, void *arg);
+
+                typedef struct retired_t
+                {
+                    retired_t      *next;       // Next retired state
+                    void           *ptr;        // Pointer to the retired state
+                } retired_t;
+
+                typedef struct reader_t
+                {
+                    void           *hazard;     // State protected by the reader
+                    uatomic_t       busy;       // Reader slot is in use
+                    uint8_t         pad[raw_mvstate_padding - sizeof(void *) - sizeof(uatomic_t)];
+                } reader_t;
+
+            private:
+                void           *current;    // Current state
+                retired_t      *retired;    // List of retired states protected by readers
+                retired_t      *spare;      // Spare list item to retire state
+                atomic_t        gc_lock;    // Garbage collector lock
+                deleter2_t      deleter2;
+                union
+                {
+                    deleter1_t      deleter1;
+                    void           *params;
+                };
+                reader_t        readers[raw_mvstate_readers];
+
+            private:
+                void            cleanup(void *garbage);
+                bool            is_protected(const void *ptr);
+                void            retire(retired_t *list);
+                retired_t      *alloc_retired();
+                void            free_retired(retired_t *item);
+                void            init_readers();
+
+            public:
+                void            init();
+                void            init(deleter1_t deleter);
+                void            init(deleter2_t deleter, void *arg);
+                void            set_deleter(deleter1_t deleter);
+                void            set_deleter(deleter2_t deleter, void *arg);
+                void            clear();
+                void            destroy();
+                void            gc();
+
+                bool            publish(void *new_state);
+                void           *get() const;
+
+                reader_t       *attach();
+                void            detach(reader_t *reader);
+                void           *acquire(reader_t *reader);
+                void            release(reader_t *reader);
+        };
+
+        /**
+         * Multi-version state with lock-free update mechanism.
+         *
+         * Each consumer thread attaches its own reader slot and acquires the snapshot
+         * of the state: the snapshot stays valid until it is released by the reader,
+         * regardless of how many times the state has been published since. Publishing
+         * a new state never fails because of readers: states replaced by publish() are
+         * destroyed as soon as there are no readers holding them.
+         */
+        template <class T>
+        class mvstate
+        {
+            public:
+                using deleter1_t    = void (*)(T *ptr);
+                template <class V>
+                using deleter2_t    = void (*)(T *ptr, V *arg);
+                typedef raw_mvstate::reader_t   reader_t;
+
+            private:
+                raw_mvstate     v;
+
+            private:
+                inline static T *tcast(void *ptr)       { return static_cast<T *>(ptr); }
+
+            public:
+                inline mvstate()                        { v.init(); }
+
+                explicit inline mvstate(deleter1_t deleter)
+                {
+                    v.init(reinterpret_cast<raw_mvstate::deleter1_t>(deleter));
+                }
+
+                template <class V>
+                explicit inline mvstate(deleter2_t<V> deleter, V *arg)
+                {
+                    v.init(reinterpret_cast<raw_mvstate::deleter2_t>(deleter), arg);
+                }
+
+                mvstate(const mvstate &) = delete;
+                mvstate(mvstate &&) = delete;
+                inline ~mvstate()                       { v.destroy(); }
+
+                mvstate & operator = (const mvstate &) = delete;
+                mvstate & operator = (mvstate &&) = delete;
+
+                inline void set_deleter(deleter1_t deleter)
+                {
+                    v.set_deleter(reinterpret_cast<raw_mvstate::deleter1_t>(deleter));
+                }
+
+                template <class V>
+                inline void set_deleter(deleter2_t<V> deleter, V *arg)
+                {
+                    v.set_deleter(reinterpret_cast<raw_mvstate::deleter2_t>(deleter), arg);
+                }
+
+            public:
+                /**
+                 * Cleanup all data.
+                 * RT-unsafe method, thread-unsafe method. Should be called when there is no
+                 * concurrent access from another threads.
+                 */
+                inline void clear()                     { v.clear();                            }
+
+                /**
+                 * Cleanup all data and forget about deleter function.
+                 * RT-unsafe method, thread-unsafe method. Should be called when there is no
+                 * concurrent access from another threads.
+                 */
+                inline void flush()                     { v.destroy();                          }
+
+                /**
+                 * Destroy retired states which are not held by readers anymore.
+                 * Thread-safe and RT-unsafe method, does nothing if another thread is collecting garbage.
+                 */
+                inline void gc()                        { v.gc();                               }
+
+                /**
+                 * Publish new state. The previous state is destroyed immediately if there
+                 * are no readers holding it, otherwise it is destroyed by one of the next
+                 * calls of publish() or gc() after all readers release it.
+                 * Thread-safe and RT-unsafe method.
+                 *
+                 * @param new_state new state to publish
+                 * @return true on success, false if there was no memory to retire the previous state,
+                 *   the state is not changed in this case
+                 */
+                inline bool publish(T *new_state)       { return v.publish(new_state);          }
+
+                /**
+                 * Get the latest published state without protecting it. The pointer may be used
+                 * only if the caller ensures that the state is not replaced concurrently.
+                 * Thread-safe and RT-safe method.
+                 *
+                 * @return pointer to the latest published state
+                 */
+                inline T *get() const                   { return tcast(v.get());                }
+
+            public:
+                /**
+                 * Attach reader. Each consumer thread should use its own reader.
+                 * Thread-safe and RT-safe method.
+                 *
+                 * @return pointer to the reader or NULL if there are no free reader slots
+                 */
+                inline reader_t *attach()               { return v.attach();                    }
+
+                /**
+                 * Detach reader, the reader should not hold any snapshot.
+                 * Thread-safe and RT-safe method.
+                 *
+                 * @param reader reader to detach
+                 */
+                inline void detach(reader_t *reader)    { v.detach(reader);                     }
+
+                /**
+                 * Acquire snapshot of the latest published state. The snapshot remains valid until
+                 * release() or next call of acquire() for the same reader.
+                 * Thread-safe and RT-safe method.
+                 *
+                 * @param reader reader which holds the snapshot
+                 * @return pointer to the state
+                 */
+                inline T *acquire(reader_t *reader)     { return tcast(v.acquire(reader));      }
+
+                /**
+                 * Release snapshot held by the reader.
+                 * Thread-safe and RT-safe method.
+                 *
+                 * @param reader reader which holds the snapshot
+                 */
+                inline void release(reader_t *reader)   { v.release(reader);                    }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_MVSTATE_H_ */
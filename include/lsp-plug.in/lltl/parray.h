@@ -102,6 +102,14 @@ namespace lsp
                 void        ssort(cmp_func_t f);
                 void        ssort(sort_closure_t *c);
 
+                void        pqsort(cmp_func_t f, executor_iface *executor);
+                void        pqsort(sort_closure_t *c, executor_iface *executor);
+
+                void        pssort(cmp_func_t f, executor_iface *executor);
+                void        pssort(sort_closure_t *c, executor_iface *executor);
+
+                bool        rsort(size_t offset, const radix_iface *key);
+
                 raw_iterator    iter();
                 raw_iterator    riter();
 
@@ -356,6 +364,105 @@ namespace lsp
                     v.ssort(&c);
                 }
 
+                /**
+                 * Perform sort of the array using the caller-provided pool of workers. Chunks of
+                 * the array are sorted simultaneously and then merged. Falls back to the sequential
+                 * qsort() if the executor is NULL or the array is small.
+                 * @param cmp comparison function
+                 * @param executor executor to run sorting tasks
+                 */
+                inline void pqsort(cmp_func_t cmp, executor_iface *executor)
+                {
+                    v.pqsort(reinterpret_cast<raw_parray::cmp_func_t>(cmp), executor);
+                }
+
+                inline void pqsort(compare_func_t cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                inline void pqsort(const compare_iface &cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp.compare;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                inline void pqsort(executor_iface *executor)
+                {
+                    compare_spec<T> spec;
+                    sort_closure_t c;
+                    c.compare       = spec.compare;
+                    c.size          = sizeof(T);
+                    v.pqsort(&c, executor);
+                }
+
+                /**
+                 * Perform stable sort of the array using the caller-provided pool of workers. Chunks of
+                 * the array are sorted simultaneously and then merged. Falls back to the sequential
+                 * ssort() if the executor is NULL or the array is small.
+                 * @param cmp comparison function
+                 * @param executor executor to run sorting tasks
+                 */
+                inline void pssort(cmp_func_t cmp, executor_iface *executor)
+                {
+                    v.pssort(reinterpret_cast<raw_parray::cmp_func_t>(cmp), executor);
+                }
+
+                inline void pssort(compare_func_t cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                inline void pssort(const compare_iface &cmp, executor_iface *executor)
+                {
+                    sort_closure_t c;
+                    c.compare       = cmp.compare;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                inline void pssort(executor_iface *executor)
+                {
+                    compare_spec<T> spec;
+                    sort_closure_t c;
+                    c.compare       = spec.compare;
+                    c.size          = sizeof(T);
+                    v.pssort(&c, executor);
+                }
+
+                /**
+                 * Perform stable radix sort of pointers by the referenced objects, applicable
+                 * only if the object is a plain integer or floating-point number. Does not call
+                 * any comparison functions. NULL pointers are placed at the beginning of the array.
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool rsort()
+                {
+                    radix_spec<T> key;
+                    return v.rsort(0, &key);
+                }
+
+                /**
+                 * Perform stable radix sort of pointers by the plain integer or floating-point
+                 * key stored in the referenced objects. NULL pointers are placed at the beginning
+                 * of the array.
+                 * @param offset offset of the key field of type K in the object
+                 * @return true on success, false on invalid key or memory allocation error
+                 */
+                template <class K>
+                inline bool rsort(size_t offset)
+                {
+                    radix_spec<K> key;
+                    return v.rsort(offset, &key);
+                }
 
             public:
                 // Operators
@@ -50,10 +50,20 @@ namespace lsp
                     tuple_t    *data;       // Tuples
                 } bin_t;
 
+                typedef struct slab_t
+                {
+                    slab_t     *next;       // Next slab
+                    size_t      count;      // Number of tuples in slab
+                    tuple_t     data[];     // Tuples
+                } slab_t;
+
             public:
                 size_t          size;       // Overall size of the hash
                 size_t          cap;        // Capacity in bins
                 bin_t          *bins;       // Overall array of bins
+                tuple_t        *pool;       // List of free tuples
+                slab_t         *slabs;      // List of allocated slabs of tuples
+                size_t          pooled;     // Number of free tuples
                 size_t          vsize;      // Size of value object
                 hash_iface      hash;       // Hash interface
                 compare_iface   cmp;        // Copy interface
@@ -61,6 +71,12 @@ namespace lsp
             protected:
                 void            destroy_bin(bin_t *bin);
                 bool            grow();
+                bool            alloc_slab(size_t count);
+                tuple_t        *alloc_tuple();
+                void            free_tuple(tuple_t *tuple);
+                void            destroy_slabs();
+                void            trim_slabs();
+                bool            rehash(size_t ncap);
                 tuple_t        *find_tuple(const void *value, size_t hash);
                 tuple_t        *remove_tuple(const void *value, size_t hash);
                 tuple_t        *create_tuple(size_t hash);
@@ -70,6 +86,8 @@ namespace lsp
                 void            flush();
                 void            clear();
                 void            swap(raw_phashset *src);
+                bool            reserve(size_t count);
+                bool            shrink_to_fit();
                 void           *get(const void *value, void *dfl);
                 void          **wbget(const void *value);
                 void          **put(void *value, void **ret);
@@ -114,6 +132,9 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.pool          = NULL;
+                    v.slabs         = NULL;
+                    v.pooled        = 0;
                     v.vsize         = sizeof(V);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -124,6 +145,9 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.pool          = NULL;
+                    v.slabs         = NULL;
+                    v.pooled        = 0;
                     v.vsize         = sizeof(V);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -182,6 +206,23 @@ namespace lsp
                  */
                 inline void swap(phashset<V> *src)                      { v.swap(&src->v);                                              }
 
+                /**
+                 * Preallocate bins and tuples, so that adding values into the set until it contains
+                 * the specified number of values does not allocate memory. Tuples of removed values
+                 * are kept for reuse until the set is flushed or shrunk.
+                 *
+                 * @param count number of values to reserve memory for
+                 * @return true on success
+                 */
+                inline bool reserve(size_t count)                       { return v.reserve(count);                                      }
+
+                /**
+                 * Reduce the number of bins to the minimum required for current number of values
+                 * and release slabs of tuples that are not in use.
+                 * @return true on success
+                 */
+                inline bool shrink_to_fit()                             { return v.shrink_to_fit();                                     }
+
             public:
                 /**
                  * Check that value associated with key exists (same to contains)
@@ -52,10 +52,24 @@ namespace lsp
                     tuple_t    *data;       // Tuples
                 } bin_t;
 
+                typedef struct slab_t
+                {
+                    slab_t     *next;       // Next slab
+                    size_t      count;      // Number of tuples in slab
+                    tuple_t     data[];     // Tuples
+                } slab_t;
+
             public:
                 size_t          size;       // Overall size of the hash
                 size_t          cap;        // Capacity in bins
                 bin_t          *bins;       // Overall array of bins
+                bin_t          *obins;      // Old array of bins while incremental rehash is in progress
+                size_t          ocap;       // Capacity of the old array of bins
+                size_t          moved;      // Number of bins already migrated from the old array
+                size_t          step;       // Number of bins to migrate per operation, 0 means rehash at once
+                tuple_t        *pool;       // List of free tuples
+                slab_t         *slabs;      // List of allocated slabs of tuples
+                size_t          pooled;     // Number of free tuples
                 size_t          ksize;      // Size of key object
                 hash_iface      hash;       // Hash interface
                 compare_iface   cmp;        // Copy interface
@@ -64,7 +78,19 @@ namespace lsp
             protected:
                 void            destroy_bin(bin_t *bin);
                 bool            grow();
+                bool            alloc_slab(size_t count);
+                tuple_t        *alloc_tuple();
+                void            free_tuple(tuple_t *tuple);
+                void            destroy_slabs();
+                void            trim_slabs();
+                bool            rehash(size_t ncap);
+                void            migrate(size_t count);
+                bin_t          *bin_of(size_t hash);
+                const bin_t    *bin_at(size_t index) const;
+                size_t          bin_count() const;
                 tuple_t        *find_tuple(const void *key, size_t hash);
+                tuple_t        *find_in_list(tuple_t *curr, const void *key, size_t hash);
+                size_t          lookup_n(size_t n, const void * const *keys, tuple_t **found);
                 tuple_t        *remove_tuple(const void *key, size_t hash);
                 tuple_t        *create_tuple(const void *key, size_t hash);
                 static tuple_t *prev_tuple(bin_t *bin, const tuple_t *tuple);
@@ -73,9 +99,15 @@ namespace lsp
                 void            flush();
                 void            clear();
                 void            swap(raw_pphash *src);
+                void            set_rehash_step(size_t step);
+                bool            reserve(size_t count);
+                bool            shrink_to_fit();
+                void            finish_rehash();
                 void           *get(const void *key, void *dfl);
                 void           *key(const void *key, void *dfl);
                 void          **wbget(const void *key);
+                size_t          get_n(size_t n, const void * const *keys, void **values, void *dfl);
+                size_t          contains_n(size_t n, const void * const *keys, bool *found);
                 void          **put(const void *key, void *value, void **ov);
                 void          **replace(const void *key, void *value, void **ov);
                 void          **create(const void *key, void *value);
@@ -114,6 +146,7 @@ namespace lsp
                 inline static K **pkcast(void *ptr)     { return reinterpret_cast<K **>(ptr);       }
                 inline static void **pvcast(V **ptr)    { return reinterpret_cast<void **>(ptr);    }
                 inline static void **pkcast(K **ptr)    { return reinterpret_cast<void **>(ptr);    }
+                inline static const void * const *pkcast(const K * const *ptr)  { return reinterpret_cast<const void * const *>(ptr);   }
 
             public:
                 explicit inline pphash()
@@ -125,6 +158,13 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.obins         = NULL;
+                    v.ocap          = 0;
+                    v.moved         = 0;
+                    v.step          = 0;
+                    v.pool          = NULL;
+                    v.slabs         = NULL;
+                    v.pooled        = 0;
                     v.ksize         = sizeof(K);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -136,6 +176,13 @@ namespace lsp
                     v.size          = 0;
                     v.cap           = 0;
                     v.bins          = NULL;
+                    v.obins         = NULL;
+                    v.ocap          = 0;
+                    v.moved         = 0;
+                    v.step          = 0;
+                    v.pool          = NULL;
+                    v.slabs         = NULL;
+                    v.pooled        = 0;
                     v.ksize         = sizeof(K);
                     v.hash          = hash;
                     v.cmp           = cmp;
@@ -168,6 +215,18 @@ namespace lsp
                  */
                 inline bool         is_empty() const                    { return v.size <= 0;                                           }
 
+                /**
+                 * Get number of bins migrated per each operation while the hash is being rehashed
+                 * @return number of bins migrated per each operation, 0 if incremental rehash is disabled
+                 */
+                inline size_t       rehash_step() const                 { return v.step;                                                }
+
+                /**
+                 * Check that incremental rehash is in progress
+                 * @return true if incremental rehash is in progress
+                 */
+                inline bool         rehashing() const                   { return v.obins != NULL;                                       }
+
             public:
                 /**
                  * Clear all bin data.
@@ -195,6 +254,47 @@ namespace lsp
                  */
                 inline void swap(pphash<K, V> *src)                     { v.swap(&src->v);                                               }
 
+                /**
+                 * Set the number of bins migrated per each operation when the hash grows.
+                 * Zero value (default) migrates all bins at once in the operation which triggers
+                 * the growth. Non-zero value enables incremental rehashing: old and new arrays of
+                 * bins coexist, and each insertion or removal migrates the specified number
+                 * of bins until the rehash completes. This bounds the latency of each operation.
+                 * Lookups never migrate bins, so const lookups do not modify the hash and remain
+                 * safe for concurrent readers in incremental mode as well. Iterators complete the
+                 * pending rehash, so call finish_rehash() before sharing the hash between readers
+                 * which iterate it.
+                 * Setting zero value completes the pending rehash.
+                 *
+                 * @param step number of bins to migrate per each operation
+                 */
+                inline void set_rehash_step(size_t step)                { v.set_rehash_step(step);                                      }
+
+                /**
+                 * Preallocate bins and tuples, so that inserting items into the hash until it contains
+                 * the specified number of items does not allocate memory for the hash structure.
+                 * Completes the pending incremental rehash. Tuples of removed items are kept for
+                 * reuse until the hash is flushed or shrunk. Keys are still cloned by the allocator
+                 * interface.
+                 *
+                 * @param count number of items to reserve memory for
+                 * @return true on success
+                 */
+                inline bool reserve(size_t count)                       { return v.reserve(count);                                      }
+
+                /**
+                 * Reduce the number of bins to the minimum required for current number of items
+                 * and release slabs of tuples that are not in use. Completes the pending incremental
+                 * rehash.
+                 * @return true on success
+                 */
+                inline bool shrink_to_fit()                             { return v.shrink_to_fit();                                     }
+
+                /**
+                 * Complete the pending incremental rehash immediately
+                 */
+                inline void finish_rehash()                             { v.finish_rehash();                                            }
+
             public:
                 /**
                  * Check that value associated with key exists (same to contains)
@@ -239,6 +339,39 @@ namespace lsp
                  */
                 inline V **wbget(const K *key)                          { return pvcast(v.wbget(key));                                  }
 
+                /**
+                 * Get values for the batch of keys. All keys are hashed first, and memory of the
+                 * target bins is prefetched before lookup, so memory access latencies of different
+                 * keys overlap instead of being serialized.
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param values array to store values, NULL is stored for keys that do not exist
+                 * @return number of keys found
+                 */
+                inline size_t get_n(size_t n, const K * const *keys, V **values) const
+                                                                        { return v.get_n(n, pkcast(keys), pvcast(values), NULL);        }
+
+                /**
+                 * Get values for the batch of keys or default value for keys that do not exist
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param values array to store values
+                 * @param dfl default value to store for keys that do not exist
+                 * @return number of keys found
+                 */
+                inline size_t dget_n(size_t n, const K * const *keys, V **values, V *dfl) const
+                                                                        { return v.get_n(n, pkcast(keys), pvcast(values), dfl);         }
+
+                /**
+                 * Check the presence of the batch of keys
+                 * @param n number of keys in the batch
+                 * @param keys array of keys to lookup
+                 * @param found array to store presence flag for each key, may be NULL
+                 * @return number of keys found
+                 */
+                inline size_t contains_n(size_t n, const K * const *keys, bool *found) const
+                                                                        { return v.contains_n(n, pkcast(keys), found);                  }
+
             public:
                 /**
                  * Put the value to the hash
@@ -55,6 +55,7 @@ namespace lsp
             protected:
                 void            destroy_bin(bin_t *bin);
                 bool            grow();
+                bool            rehash(size_t ncap);
                 bin_t          *next_bin(bin_t *bin);
                 bin_t          *prev_bin(bin_t *bin);
 
@@ -69,6 +70,8 @@ namespace lsp
                 void            flush();
                 void            clear();
                 void            swap(raw_ptrset *src);
+                bool            reserve(size_t count);
+                bool            shrink_to_fit();
                 void           *get(const void *value, void *dfl);
                 bool            contains(const void *value);
                 bool            put(void *value);
@@ -155,8 +158,7 @@ namespace lsp
 
             public:
                 /**
-                 * Clear all bin data.
-                 * Automatically destroys keys.
+                 * Clear all bin data, the memory allocated for bins is kept for reuse.
                  * Caller is responsible for destroying values.
                  */
                 void clear()                                            { v.clear();                                                    }
@@ -180,6 +182,24 @@ namespace lsp
                  */
                 inline void swap(ptrset<V> *src)                        { v.swap(&src->v);                                              }
 
+                /**
+                 * Preallocate bins, so that putting values into the set until it contains
+                 * the specified number of values does not allocate memory. Each bin gets storage
+                 * for ptrset_tuple_items values, so the guarantee holds until some bin receives
+                 * more values than that, which is very unlikely for evenly distributed hashes.
+                 *
+                 * @param count number of values to reserve memory for
+                 * @return true on success
+                 */
+                inline bool reserve(size_t count)                       { return v.reserve(count);                                      }
+
+                /**
+                 * Reduce the number of bins to the minimum required for current number of values
+                 * and release unused storage of each bin.
+                 * @return true on success
+                 */
+                inline bool shrink_to_fit()                             { return v.shrink_to_fit();                                     }
+
             public:
                 /**
                  * Check that value associated with key exists (same to contains)
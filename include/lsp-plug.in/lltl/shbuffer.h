@@ -32,6 +32,22 @@ namespace lsp
 {
     namespace lltl
     {
+        /**
+         * Access pattern hints for the memory-mapped file regions
+         */
+        enum shbuffer_advice_t
+        {
+            SHBUFFER_ADVICE_NORMAL      = 0,            // No special access pattern
+            SHBUFFER_ADVICE_SEQUENTIAL  = 1 << 0,       // Data will be accessed sequentially
+            SHBUFFER_ADVICE_RANDOM      = 1 << 1,       // Data will be accessed in random order
+            SHBUFFER_ADVICE_WILLNEED    = 1 << 2        // Data will be accessed soon, read ahead
+        };
+
+        static constexpr size_t shbuffer_pool_classes       = 12;
+        static constexpr size_t shbuffer_pool_min_shift     = 6;
+
+        class shbuffer_pool;
+
         /**
          * Raw shared buffer
          */
@@ -40,27 +56,118 @@ namespace lsp
             public:
                 typedef void    (* deleter_t)(void *data);
 
+                struct buffer_t;
+                typedef void    (* destructor_t)(buffer_t *buf);
+
                 typedef struct buffer_t
                 {
                     uatomic_t       references;
                     deleter_t       deleter;
+                    destructor_t    destructor;     // Destroys whole buffer including header, overrides deleter
+                    bool            writable;       // Data is owned by the buffer and can be modified
                     size_t          bytes;
                     uint8_t        *data;
                 } buffer_t;
 
             public:
                 buffer_t       *ptr;
+                size_t          offset;     // Offset of the referenced window in bytes
+                size_t          length;     // Length of the referenced window in bytes
 
             public:
+                void            init();
                 void           *get(size_t offset);
-                void            map(void *data, size_t length, deleter_t deleter);
-                void            make(const void *data, size_t length);
+                void            assign(raw_shbuffer *src);
+                void            take(raw_shbuffer *src);
+                void            slice(raw_shbuffer *dst, size_t first, size_t count, size_t szof);
+                void            swap(raw_shbuffer *src);
+                void           *edit(shbuffer_pool *pool);
+                void            map(void *data, size_t length, deleter_t deleter, shbuffer_pool *pool);
+                void            make(const void *data, size_t length, shbuffer_pool *pool);
+                status_t        map_file(const char *path, wsize_t offset, wsize_t length, size_t advice);
                 buffer_t       *reference_up();
                 void            reference_down(buffer_t *replace);
                 ptrdiff_t       compare(const raw_shbuffer & src);
                 ptrdiff_t       compare(const void *p);
         };
 
+        /**
+         * Pool of shared buffers. Keeps the memory of released buffers in per-size-class free lists
+         * and reuses it for new buffers, so creation and destruction of shared buffers does not
+         * involve the heap allocator in the steady state. Buffers can be released by any thread:
+         * the memory is returned to the pool without locks. The pool should outlive all buffers
+         * allocated from it.
+         */
+        class LSP_LLTL_LIB_PUBLIC shbuffer_pool
+        {
+            private:
+                friend struct raw_shbuffer;
+
+                struct block_t;
+
+                typedef struct bin_t
+                {
+                    block_t        *free;           // Blocks available for allocation, protected by lock
+                    block_t        *returned;       // Blocks returned by releasing threads
+                    atomic_t        lock;           // Allocation lock
+                } bin_t;
+
+            private:
+                bin_t           vBins[shbuffer_pool_classes];
+
+            private:
+                static ssize_t          size_class(size_t bytes);
+                static size_t           class_bytes(size_t sclass);
+                static void             release(raw_shbuffer::buffer_t *buf);
+                static void             free_list(block_t *list);
+
+                block_t                *alloc_block(size_t sclass);
+                raw_shbuffer::buffer_t *allocate(size_t bytes);
+
+            public:
+                explicit shbuffer_pool();
+                shbuffer_pool(const shbuffer_pool &) = delete;
+                shbuffer_pool(shbuffer_pool &&) = delete;
+                ~shbuffer_pool();
+
+                shbuffer_pool & operator = (const shbuffer_pool &) = delete;
+                shbuffer_pool & operator = (shbuffer_pool &&) = delete;
+
+            public:
+                /**
+                 * Get the maximum size of data which can be stored in the pooled buffer.
+                 * Larger buffers are allocated from heap.
+                 * @return maximum size of data in bytes
+                 */
+                static size_t           max_bytes();
+
+                /**
+                 * Allocate buffers in advance so that first uses of the pool do not involve heap allocator.
+                 * Thread-safe and RT-unsafe method.
+                 *
+                 * @param bytes size of data in bytes, zero for buffers that map external data
+                 * @param count number of buffers to allocate
+                 * @return true on success, false if there is no memory, the size exceeds max_bytes()
+                 *   or the size class is currently in use by another thread
+                 */
+                bool                    reserve(size_t bytes, size_t count);
+
+                /**
+                 * Get number of buffers currently cached by the pool.
+                 * Thread-safe method, the result is approximate if there are concurrent accesses.
+                 *
+                 * @return number of cached buffers
+                 */
+                size_t                  cached();
+
+                /**
+                 * Release all cached buffers to the heap. Buffers which are still in use are returned
+                 * to the pool when released.
+                 * Thread-safe and RT-unsafe method.
+                 */
+                void                    flush();
+        };
+
         /**
          * This class reperesents some reference to constant shared buffer
          * @tparam T type of data wrapped by shared buffer
@@ -87,7 +194,7 @@ namespace lsp
                  */
                 inline shbuffer()
                 {
-                    v.ptr       = NULL;
+                    v.init();
                 }
 
                 /**
@@ -96,7 +203,8 @@ namespace lsp
                  */
                 inline shbuffer(const shbuffer & src)
                 {
-                    v.ptr       = src.v.reference_up();
+                    v.init();
+                    v.assign(&src.v);
                 }
 
                 /**
@@ -104,7 +212,7 @@ namespace lsp
                  */
                 inline shbuffer(const nullptr_t)
                 {
-                    v.ptr       = NULL;
+                    v.init();
                 }
 
                 /**
@@ -113,8 +221,8 @@ namespace lsp
                  */
                 inline shbuffer(shbuffer && src)
                 {
-                    v.ptr       = src.v.ptr;
-                    src.v.ptr   = NULL;
+                    v.init();
+                    v.take(&src.v);
                 }
 
                 /**
@@ -125,8 +233,8 @@ namespace lsp
                  */
                 inline shbuffer(const T * data, size_t count, deleter_t deleter)
                 {
-                    v.ptr       = NULL;
-                    v.map(const_cast<T *>(data), count * SZOF, reinterpret_cast<raw_shbuffer::deleter_t>(deleter));
+                    v.init();
+                    v.map(const_cast<T *>(data), count * SZOF, reinterpret_cast<raw_shbuffer::deleter_t>(deleter), NULL);
                 }
 
                 /**
@@ -136,8 +244,8 @@ namespace lsp
                  */
                 inline shbuffer(const T * data, size_t count = 1)
                 {
-                    v.ptr       = NULL;
-                    v.make(data, count * SZOF);
+                    v.init();
+                    v.make(data, count * SZOF, NULL);
                 }
 
                 ~shbuffer()
@@ -153,7 +261,7 @@ namespace lsp
                  */
                 inline shbuffer & operator = (const shbuffer & src)
                 {
-                    v.reference_down(src.v.reference_up());
+                    v.assign(&src.v);
                     return *this;
                 }
 
@@ -164,8 +272,7 @@ namespace lsp
                  */
                 inline shbuffer & operator = (shbuffer && src)
                 {
-                    v.ptr           = src.v.ptr;
-                    src.v.ptr       = NULL;
+                    v.take(&src.v);
                     return *this;
                 }
 
@@ -231,7 +338,21 @@ namespace lsp
                  */
                 inline shbuffer & map(const T * data, size_t count = 1, deleter_t deleter = NULL)
                 {
-                    v.map(const_cast<T *>(data), count * SZOF, reinterpret_cast<raw_shbuffer::deleter_t>(deleter));
+                    v.map(const_cast<T *>(data), count * SZOF, reinterpret_cast<raw_shbuffer::deleter_t>(deleter), NULL);
+                    return *this;
+                }
+
+                /**
+                 * Map shared buffer associated with some already existing memory chunk,
+                 * allocate the buffer header from the pool
+                 * @param data pointer to memory chunk
+                 * @param count number of elements in chunk
+                 * @param deleter memory deleter
+                 * @param pool pool to allocate the buffer header
+                 */
+                inline shbuffer & map(const T * data, size_t count, deleter_t deleter, shbuffer_pool *pool)
+                {
+                    v.map(const_cast<T *>(data), count * SZOF, reinterpret_cast<raw_shbuffer::deleter_t>(deleter), pool);
                     return *this;
                 }
 
@@ -242,21 +363,91 @@ namespace lsp
                  */
                 inline shbuffer & set(const T * data, size_t count = 1)
                 {
-                    v.make(data, count * SZOF);
+                    v.make(data, count * SZOF, NULL);
                     return *this;
                 }
 
+                /**
+                 * Set shared buffer as a copy of memory chunk, allocate the buffer from the pool
+                 * @param data pointer to memory chunk
+                 * @param count number of elements in chunk
+                 * @param pool pool to allocate the buffer, the buffer is allocated from heap
+                 *   if it is larger than the pool supports
+                 */
+                inline shbuffer & set(const T * data, size_t count, shbuffer_pool *pool)
+                {
+                    v.make(data, count * SZOF, pool);
+                    return *this;
+                }
+
+                /**
+                 * Map the region of file into memory and associate the shared buffer with it.
+                 * The mapping is read-only and is released when the last reference is removed,
+                 * so the file contents can be shared between consumers without copying.
+                 * The current reference is not changed if the method fails.
+                 *
+                 * @param path path to the file in UTF-8 encoding
+                 * @param offset offset of the region in bytes
+                 * @param length length of the region in bytes, zero to map the file until end
+                 * @param advice set of shbuffer_advice_t flags with access pattern hints
+                 * @return status of operation
+                 */
+                inline status_t map_file(const char *path, wsize_t offset = 0, wsize_t length = 0,
+                    size_t advice = SHBUFFER_ADVICE_NORMAL)
+                {
+                    return v.map_file(path, offset, length, advice);
+                }
+
+                /**
+                 * Create the reference to the range of elements of the buffer. The slice shares
+                 * the same memory with the buffer, so no data is copied and only the reference
+                 * counter is incremented. The range is truncated to the end of the buffer.
+                 *
+                 * @param first index of the first element of the range
+                 * @param count number of elements in the range
+                 * @return reference to the range of elements or empty reference if the range is empty
+                 */
+                inline shbuffer slice(size_t first, size_t count) const
+                {
+                    shbuffer res;
+                    v.slice(&res.v, first, count, SZOF);
+                    return res;
+                }
+
+                /**
+                 * Obtain mutable access to the data referenced by the buffer. The data is modified in place
+                 * if the buffer holds the only reference and owns the data, otherwise the referenced elements
+                 * are copied to the new buffer first, and other references keep seeing the original data.
+                 * The pointer remains valid until the reference is changed.
+                 *
+                 * @param pool pool to allocate the copy of data, NULL to allocate from heap
+                 * @return pointer to the first element or NULL if reference is null or there is no memory
+                 */
+                inline T * edit(shbuffer_pool *pool = NULL)             { return cast(v.edit(pool));                            }
+
+                /**
+                 * Check that the buffer holds the only reference to the data
+                 * @return true if there are no other references to the data
+                 */
+                inline bool unique() const                              { return references() == 1;                             }
+
                 /**
                  * Get overall number of bytes used by buffer
                  * @return number of bytes used by buffer
                  */
-                inline size_t bytes() const                             { return (v.ptr != NULL) ? v.ptr->bytes : 0;            }
+                inline size_t bytes() const                             { return v.length;                                      }
 
                 /**
                  * Get overall number of elements used by buffer
                  * @return number of elements used by buffer
                  */
-                inline size_t count() const                             { return (v.ptr != NULL) ? v.ptr->bytes/SZOF : 0;       }
+                inline size_t count() const                             { return v.length / SZOF;                               }
+
+                /**
+                 * Check whether the reference covers only the part of the buffer
+                 * @return true if the reference covers only the part of the buffer
+                 */
+                inline bool is_slice() const                            { return (v.ptr != NULL) && (v.length != v.ptr->bytes); }
 
                 /**
                  * Get number of references
@@ -265,8 +456,8 @@ namespace lsp
                 inline size_t references() const                        { return (v.ptr != NULL) ? atomic_load(&v.ptr->references) : 0;     }
 
             public:
-                inline void swap(shbuffer<T> * src)                     { lsp::swap(v.ptr, src->v.ptr);                         }
-                inline void swap(shbuffer<T> & src)                     { lsp::swap(v.ptr, src.v.ptr);                          }
+                inline void swap(shbuffer<T> * src)                     { v.swap(&src->v);                                      }
+                inline void swap(shbuffer<T> & src)                     { v.swap(&src.v);                                       }
         };
 
         template<typename V>
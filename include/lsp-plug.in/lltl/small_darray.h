@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef LSP_PLUG_IN_LLTL_SMALL_DARRAY_H_
+#define LSP_PLUG_IN_LLTL_SMALL_DARRAY_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        /**
+         * Data array template with inline storage for N elements. Elements are stored
+         * inside of the object until their number exceeds N, after that the data is moved
+         * to the heap. The data is moved back to the inline storage when the array is
+         * truncated or flushed. The array provides the whole API of darray and can be
+         * passed anywhere where darray is expected. Since the inline storage does not
+         * guarantee custom alignment, swap with darray created with non-default alignment
+         * is rejected.
+         */
+        template <class T, size_t N>
+        class small_darray: public darray<T>
+        {
+            private:
+                alignas(T) uint8_t  vStorage[N * sizeof(T)];
+
+            public:
+                explicit inline small_darray()
+                {
+                    this->v.init(sizeof(T), vStorage, N);
+                }
+
+                small_darray(const small_darray<T, N> & src) = delete;
+                small_darray(small_darray<T, N> && src) = delete;
+
+                small_darray<T, N> & operator = (const small_darray<T, N> & src) = delete;
+                small_darray<T, N> & operator = (small_darray<T, N> && src) = delete;
+
+            public:
+                /**
+                 * Get the capacity of inline storage
+                 * @return capacity of inline storage
+                 */
+                inline size_t inline_capacity() const                           { return N;                                 }
+
+                /**
+                 * Check that data is stored in the inline storage
+                 * @return true if data is stored in the inline storage
+                 */
+                inline bool is_inline() const                                   { return this->v.vItems == vStorage;        }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_SMALL_DARRAY_H_ */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_LLTL_SPARSE_BITSET_H_
+#define LSP_PLUG_IN_LLTL_SPARSE_BITSET_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/common/types.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        /**
+         * Compressed bitset for sparse data. The range of indices is split into chunks of 65536 bits,
+         * only chunks containing set bits are stored. Each chunk uses one of three containers
+         * depending on what requires less memory: sorted array of bit indices, plain bitmap or
+         * sorted array of runs of set bits.
+         *
+         * Unlike lltl::bitset, modifications may require memory allocation. If the allocation fails,
+         * the modification is not applied.
+         */
+        class LSP_LLTL_LIB_PUBLIC sparse_bitset
+        {
+            protected:
+                enum chunk_type_t
+                {
+                    CHUNK_ARRAY,        // Sorted array of uint16_t indices
+                    CHUNK_BITMAP,       // Bitmap of 65536 bits
+                    CHUNK_RUN           // Sorted array of runs
+                };
+
+                enum bit_op_t
+                {
+                    OP_SET,
+                    OP_UNSET,
+                    OP_TOGGLE,
+                    OP_AND,
+                    OP_OR,
+                    OP_XOR,
+                    OP_ANDNOT
+                };
+
+                typedef struct run_t
+                {
+                    uint16_t    start;      // First bit of the run
+                    uint16_t    length;     // Number of bits in the run minus one
+                } run_t;
+
+                typedef struct chunk_t
+                {
+                    size_t      key;        // Index of the chunk
+                    uint32_t    type;       // Type of the container
+                    uint32_t    count;      // Number of set bits
+                    uint32_t    size;       // Number of items in the array or run container
+                    uint32_t    cap;        // Capacity of the array or run container
+                    void       *data;       // Data of the container
+                } chunk_t;
+
+            protected:
+                size_t          nSize;
+                size_t          nChunks;
+                size_t          nCapacity;
+                chunk_t        *vChunks;
+
+            protected:
+                static size_t   item_size(uint32_t type);
+                static ssize_t  run_search(const run_t *r, size_t n, size_t value);
+                static bool     run_oversized(const chunk_t *c);
+                static bool     chunk_get(const chunk_t *c, size_t low);
+                static bool     chunk_add(chunk_t *c, size_t low, bool *prev);
+                static bool     chunk_remove(chunk_t *c, size_t low, bool *prev);
+                static ssize_t  chunk_find(const chunk_t *c, size_t low);
+                static bool     chunk_fill(chunk_t *c);
+                static bool     chunk_clone(chunk_t *dst, const chunk_t *src);
+                static bool     chunk_combine(chunk_t *c, const chunk_t *src, bit_op_t op, uint64_t *tmp);
+                static void     chunk_free(chunk_t *c);
+                static bool     chunk_reserve(chunk_t *c, size_t size, size_t szof);
+                static void     to_bitmap(uint64_t *dst, const chunk_t *c);
+                static bool     from_bitmap(chunk_t *c, const uint64_t *src);
+                static bool     reencode(chunk_t *c);
+
+                size_t          find_chunk(size_t key) const;
+                chunk_t        *insert_chunk(size_t pos, size_t key);
+                void            remove_chunk(size_t pos);
+                size_t          range_op(size_t index, size_t count, bit_op_t op);
+                bool            bit_op(size_t index, bit_op_t op);
+                bool            bulk_op(const sparse_bitset *src, bit_op_t op);
+                bool            truncate(size_t size);
+                ssize_t         find(size_t index) const;
+
+            public:
+                explicit        sparse_bitset();
+                sparse_bitset(const sparse_bitset &) = delete;
+                sparse_bitset(sparse_bitset &&) = delete;
+                ~sparse_bitset();
+
+                sparse_bitset &operator = (const sparse_bitset &) = delete;
+                sparse_bitset &operator = (sparse_bitset &&) = delete;
+
+            public:
+                inline bool     is_empty() const            { return nSize == 0;                    }
+                inline size_t   size() const                { return nSize;                         }
+
+                /**
+                 * Get amount of memory used by the bitset
+                 * @return amount of memory in bytes
+                 */
+                size_t          capacity() const;
+
+            public:
+                bool            resize(size_t size);
+                void            flush();
+                void            clear();
+
+                /**
+                 * Convert each chunk to the container that requires less memory. The container
+                 * of chunk is also selected automatically on bulk modifications, so the call
+                 * is useful after series of single-bit modifications.
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            optimize();
+
+            public:
+                bool            get(size_t index) const;
+
+                void            set_all();
+                bool            set(size_t index);
+                bool            set(size_t index, bool value);
+                size_t          set(size_t index, size_t count);
+                size_t          set(size_t index, size_t count, const bool *values);
+
+                void            unset_all();
+                bool            unset(size_t index);
+                size_t          unset(size_t index, size_t count);
+
+                void            toggle_all();
+                bool            toggle(size_t index);
+                size_t          toggle(size_t index, size_t count);
+
+            public:
+                /**
+                 * Perform bitwise AND (intersection) with another bitset: this = this & src.
+                 * @param src source bitset
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            bitwise_and(const sparse_bitset *src);
+
+                /**
+                 * Perform bitwise OR (union) with another bitset: this = this | src.
+                 * Bits of the source bitset beyond the size of this bitset are ignored.
+                 * @param src source bitset
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            bitwise_or(const sparse_bitset *src);
+
+                /**
+                 * Perform bitwise XOR with another bitset: this = this ^ src.
+                 * Bits of the source bitset beyond the size of this bitset are ignored.
+                 * @param src source bitset
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            bitwise_xor(const sparse_bitset *src);
+
+                /**
+                 * Clear all bits which are set in another bitset: this = this & ~src.
+                 * @param src source bitset
+                 * @return true on success, false on memory allocation error
+                 */
+                bool            bitwise_andnot(const sparse_bitset *src);
+
+            public:
+                /**
+                 * Get number of set bits
+                 * @return number of set bits
+                 */
+                size_t          count() const;
+
+                /**
+                 * Find first set bit. All set bits can be enumerated in the following way:
+                 *   for (ssize_t i = bs.find_first(); i >= 0; i = bs.find_next(i)) { ... }
+                 * @return index of the first set bit or negative value if there are no set bits
+                 */
+                inline ssize_t  find_first() const                  { return find(0);                       }
+
+                /**
+                 * Find next set bit after the specified index
+                 * @param index index of the bit to start search after
+                 * @return index of the next set bit or negative value if there are no set bits
+                 */
+                inline ssize_t  find_next(size_t index) const       { return find(index + 1);               }
+
+            public:
+                void            swap(sparse_bitset *dst);
+        };
+
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_SPARSE_BITSET_H_ */
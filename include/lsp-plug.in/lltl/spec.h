@@ -35,7 +35,7 @@ namespace lsp
         // Interface for pointers
         struct ptr_hash_iface: public hash_iface
         {
-            inline ptr_hash_iface()
+            inline ptr_hash_iface(): hash_iface()
             {
                 hash        = ptr_hash_func;
             }
@@ -58,7 +58,7 @@ namespace lsp
         template <class T>
         struct hash_spec: public hash_iface
         {
-            inline hash_spec()
+            inline hash_spec(): hash_iface()
             {
                 hash        = default_hash_func;
             }
@@ -101,12 +101,45 @@ namespace lsp
             }
         };
 
+        /**
+         * Default specialization for radix interface, applicable to integer types
+         */
+        template <class T>
+        struct radix_spec: public radix_iface
+        {
+            inline radix_spec()
+            {
+                size        = sizeof(T);
+                type        = (T(-1) < T(0)) ? RADIX_SIGNED : RADIX_UNSIGNED;
+            }
+        };
+
+        template <>
+        struct radix_spec<float>: public radix_iface
+        {
+            inline radix_spec()
+            {
+                size        = sizeof(float);
+                type        = RADIX_FLOAT;
+            }
+        };
+
+        template <>
+        struct radix_spec<double>: public radix_iface
+        {
+            inline radix_spec()
+            {
+                size        = sizeof(double);
+                type        = RADIX_FLOAT;
+            }
+        };
+
         //---------------------------------------------------------------------
         // Specialization for raw pointers
         template <class T>
         struct hash_spec<T *>: public hash_iface
         {
-            inline hash_spec()
+            inline hash_spec(): hash_iface()
             {
                 hash        = ptr_hash_func;
             }
@@ -124,12 +157,22 @@ namespace lsp
             }
         };
 
+        template <class T>
+        struct radix_spec<T *>: public radix_iface
+        {
+            inline radix_spec()
+            {
+                size        = sizeof(T *);
+                type        = RADIX_UNSIGNED;
+            }
+        };
+
         //---------------------------------------------------------------------
         // Specialization for C-strings: char *
         template <>
         struct hash_spec<char>: public hash_iface
         {
-            inline hash_spec()
+            inline hash_spec(): hash_iface()
             {
                 hash        = char_hash_func;
             }
@@ -159,7 +202,7 @@ namespace lsp
         template <>
         struct hash_spec<const char>: public hash_iface
         {
-            inline hash_spec()
+            inline hash_spec(): hash_iface()
             {
                 hash        = char_hash_func;
             }
@@ -183,6 +226,101 @@ namespace lsp
                 free        = ::free;
             }
         };
+
+        //---------------------------------------------------------------------
+        // Specializations for fast hashing
+
+        /**
+         * Hash interface with fast hashing functions, can be passed to the
+         * constructors of hash containers instead of default specialization
+         */
+        template <class T>
+        struct fast_hash_spec: public hash_iface
+        {
+            inline fast_hash_spec(): hash_iface()
+            {
+                hash        = fast_hash_func;
+            }
+        };
+
+        template <class T>
+        struct fast_hash_spec<T *>: public hash_iface
+        {
+            inline fast_hash_spec(): hash_iface()
+            {
+                hash        = ptr_hash_func;
+            }
+        };
+
+        template <>
+        struct fast_hash_spec<char>: public hash_iface
+        {
+            inline fast_hash_spec(): hash_iface()
+            {
+                hash        = fast_char_hash_func;
+            }
+        };
+
+        template <>
+        struct fast_hash_spec<const char>: public hash_iface
+        {
+            inline fast_hash_spec(): hash_iface()
+            {
+                hash        = fast_char_hash_func;
+            }
+        };
+
+        //---------------------------------------------------------------------
+        // Specializations for seeded hashing
+
+        /**
+         * Hash interface with seeded hashing functions, protects hash containers from
+         * keys crafted to collide. By default each instance gets its own random seed,
+         * explicit seed can be passed to get reproducible hash values.
+         */
+        template <class T>
+        struct seeded_hash_spec: public hash_iface
+        {
+            explicit inline seeded_hash_spec(uint64_t seed = make_hash_seed()): hash_iface()
+            {
+                this->hash      = fast_hash_func;
+                this->seeded    = fast_seeded_hash_func;
+                this->seed      = seed;
+            }
+        };
+
+        template <class T>
+        struct seeded_hash_spec<T *>: public hash_iface
+        {
+            explicit inline seeded_hash_spec(uint64_t seed = make_hash_seed()): hash_iface()
+            {
+                this->hash      = ptr_hash_func;
+                this->seeded    = ptr_seeded_hash_func;
+                this->seed      = seed;
+            }
+        };
+
+        template <>
+        struct seeded_hash_spec<char>: public hash_iface
+        {
+            explicit inline seeded_hash_spec(uint64_t seed = make_hash_seed()): hash_iface()
+            {
+                this->hash      = fast_char_hash_func;
+                this->seeded    = fast_seeded_char_hash_func;
+                this->seed      = seed;
+            }
+        };
+
+        template <>
+        struct seeded_hash_spec<const char>: public hash_iface
+        {
+            explicit inline seeded_hash_spec(uint64_t seed = make_hash_seed()): hash_iface()
+            {
+                this->hash      = fast_char_hash_func;
+                this->seeded    = fast_seeded_char_hash_func;
+                this->seed      = seed;
+            }
+        };
     } /* namespace lltl */
 } /* namespace lsp */
 
@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef LSP_PLUG_IN_LLTL_SPSC_QUEUE_H_
+#define LSP_PLUG_IN_LLTL_SPSC_QUEUE_H_
+
+#include <lsp-plug.in/lltl/version.h>
+#include <lsp-plug.in/lltl/ddeque.h>
+#include <lsp-plug.in/common/atomic.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static constexpr size_t raw_spsc_queue_padding      = 0x40;
+
+        /**
+         * Raw single-producer single-consumer queue implementation with fixed set of routines
+         */
+        struct LSP_LLTL_LIB_PUBLIC raw_spsc_queue
+        {
+            public:
+                typedef raw_ddeque::chunk_t chunk_t;
+
+            public:
+                // Consumer side
+                chunk_t        *pHead;          // Chunk being read by consumer
+                size_t          nPopped;        // Overall number of popped elements
+                uint8_t         vPad1[raw_spsc_queue_padding - sizeof(chunk_t *) - sizeof(size_t)];
+
+                // Producer side
+                chunk_t        *pTail;          // Chunk being written by producer
+                chunk_t        *pFirst;         // First chunk already read by consumer and available for reuse
+                chunk_t        *pHeadCopy;      // Cached value of pHead
+                chunk_t        *pUnused;        // List of reserved chunks
+                size_t          nPushed;        // Overall number of pushed elements
+                size_t          nChunks;        // Overall number of allocated chunks
+                size_t          nUnused;        // Number of reserved chunks
+                uint8_t         vPad2[raw_spsc_queue_padding - sizeof(chunk_t *) * 4 - sizeof(size_t) * 3];
+
+                // Immutable data
+                size_t          nSizeOf;        // Size of one element stored in the queue
+                size_t          nChunkSize;     // Size of one chunk in elements
+
+            protected:
+                chunk_t        *alloc_chunk();
+                chunk_t        *acquire_chunk();
+                void            release_chunks(chunk_t *list);
+                static void     free_chunk_list(chunk_t *head);
+
+            public:
+                void            init(size_t n_sizeof, size_t chunk_capacity);
+                void            flush();
+                bool            reserve(size_t capacity);
+
+                bool            push_back(const void *data);
+                bool            push_back(const void *data, size_t count);
+                bool            pop_front(void *data);
+                size_t          pop_front(void *data, size_t count);
+                size_t          size() const;
+        };
+
+        /**
+         * Wait-free single-producer single-consumer queue of plain data structures.
+         *
+         * Elements are stored in the chunks of the same format as used by ddeque. Chunks
+         * which have been read by the consumer are recycled by the producer, so once the
+         * queue is warmed up (or reserve() has been called), the producer does not perform
+         * any memory allocations. Neither producer nor consumer ever blocks.
+         *
+         * Only one thread may push elements and only one thread may pop elements at the
+         * same time. Methods which are not marked as producer or consumer methods are
+         * thread-unsafe and should be called when there is no concurrent access.
+         */
+        template <class T>
+        class spsc_queue
+        {
+            private:
+                mutable raw_spsc_queue  v;
+
+                inline static T *cast(void *ptr)                                { return static_cast<T *>(ptr);         }
+
+            public:
+                explicit inline spsc_queue(size_t chunk_capacity = raw_ddeque::DEFAULT_CHUNK_CAPACITY)
+                {
+                    v.init(sizeof(T), chunk_capacity);
+                }
+
+                spsc_queue(const spsc_queue<T> & src) = delete;
+                spsc_queue(spsc_queue<T> && src) = delete;
+                ~spsc_queue() { v.flush(); };
+
+                spsc_queue<T> & operator = (const spsc_queue<T> & src) = delete;
+                spsc_queue<T> & operator = (spsc_queue<T> && src) = delete;
+
+            public:
+                /**
+                 * Get number of elements in the queue. The value is approximate if there is
+                 * concurrent access to the queue.
+                 * @return number of elements in the queue
+                 */
+                inline size_t size() const                                      { return v.size();                  }
+
+                /**
+                 * Check whether queue is empty. The value is approximate if there is
+                 * concurrent access to the queue.
+                 * @return true if queue is empty
+                 */
+                inline bool is_empty() const                                    { return v.size() <= 0;             }
+
+                /**
+                 * Get number of allocated chunks
+                 * @return number of allocated chunks
+                 */
+                inline size_t chunks() const                                    { return v.nChunks;                 }
+
+                /**
+                 * Get capacity of one chunk in elements
+                 * @return capacity of one chunk in elements
+                 */
+                inline size_t chunk_capacity() const                            { return v.nChunkSize;              }
+
+            public:
+                /**
+                 * Drop all elements and free all allocated memory.
+                 * Thread-unsafe method.
+                 */
+                inline void flush()                                             { v.flush();                        }
+
+                /**
+                 * Ensure that the queue is able to store the specified number of elements
+                 * without memory allocations.
+                 * Producer method.
+                 * @param capacity the number of elements
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool reserve(size_t capacity)                            { return v.reserve(capacity);       }
+
+            public:
+                /**
+                 * Push element to the end of the queue.
+                 * Producer method.
+                 * @param item element to push
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool push(const T *item)                                 { return v.push_back(item);         }
+                inline bool push(const T & item)                                { return v.push_back(&item);        }
+                inline bool push_back(const T *item)                            { return v.push_back(item);         }
+                inline bool push_back(const T & item)                           { return v.push_back(&item);        }
+
+                /**
+                 * Push multiple elements to the end of the queue. Either all elements are
+                 * pushed or none of them.
+                 * Producer method.
+                 * @param data pointer to elements to push
+                 * @param count number of elements
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool push(const T *data, size_t count)                   { return v.push_back(data, count);  }
+                inline bool push_back(const T *data, size_t count)              { return v.push_back(data, count);  }
+
+                /**
+                 * Pop element from the beginning of the queue.
+                 * Consumer method.
+                 * @param item pointer to store the element
+                 * @return true if element has been popped, false if queue is empty
+                 */
+                inline bool pop(T *item)                                        { return v.pop_front(item);         }
+                inline bool pop(T & item)                                       { return v.pop_front(&item);        }
+                inline bool pop_front(T *item)                                  { return v.pop_front(item);         }
+                inline bool pop_front(T & item)                                 { return v.pop_front(&item);        }
+
+                /**
+                 * Pop multiple elements from the beginning of the queue.
+                 * Consumer method.
+                 * @param data pointer to store elements
+                 * @param count maximum number of elements to pop
+                 * @return actual number of popped elements
+                 */
+                inline size_t pop(T *data, size_t count)                        { return v.pop_front(data, count);  }
+                inline size_t pop_front(T *data, size_t count)                  { return v.pop_front(data, count);  }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* LSP_PLUG_IN_LLTL_SPSC_QUEUE_H_ */
@@ -24,6 +24,7 @@
 
 #include <lsp-plug.in/lltl/version.h>
 #include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/common/atomic.h>
 
 namespace lsp
 {
@@ -35,6 +36,12 @@ namespace lsp
                 typedef void    (* deleter1_t)(void *ptr);
                 typedef void    (* deleter2_t)(void *ptr, void *arg);
 
+                typedef struct garbage_t
+                {
+                    garbage_t      *next;       // Next item in the list
+                    void           *ptr;        // Pointer to the state
+                } garbage_t;
+
             private:
                 enum bin_t
                 {
@@ -47,16 +54,25 @@ namespace lsp
 
             private:
                 void           *bins[B_TOTAL];
+                void           *active;     // Unwrapped pointer to the state stored in B_STATE bin
                 deleter2_t      deleter2;
                 union
                 {
                     deleter1_t      deleter1;
                     void           *params;
                 };
+                garbage_t      *retired;    // Superseded states in deferred mode
+                garbage_t      *spare;      // Spare list items in deferred mode
+                atomic_t        spare_lock; // Lock of spare list items
+                bool            deferred;   // Deferred reclamation mode
 
             private:
                 void            cleanup(void *garbage);
                 void            init_bins();
+                void           *unwrap(void *ptr) const;
+                bool            wrap(void **dst, void *ptr, bool alloc);
+                void            dispose(void *ptr);
+                void            recycle(garbage_t *item);
 
             public:
                 void            init();
@@ -66,7 +82,11 @@ namespace lsp
                 void            set_deleter(deleter2_t deleter, void *arg);
                 void            clear();
                 void            destroy();
-                void            push(void *new_state);
+                bool            set_deferred(bool defer);
+                inline bool     is_deferred() const     { return deferred; }
+                bool            reserve(size_t count);
+                size_t          collect();
+                bool            push(void *new_state);
                 bool            set(void *new_state);
                 void           *pull();
                 void           *get();
@@ -77,7 +97,12 @@ namespace lsp
 
 
         /**
-         * State with lock-free update mechanism
+         * State with lock-free update mechanism.
+         *
+         * By default, superseded states are destroyed by the thread which performs the update.
+         * In deferred mode superseded states are never destroyed by push(), pull(), set() and get()
+         * methods: they are moved to the lock-free garbage list which is drained by explicit call
+         * of collect() or gc(), so the real-time consumer never runs the deleter.
          */
         template <class T>
         class state
@@ -146,15 +171,57 @@ namespace lsp
                  */
                 inline void gc()                        { v.gc();                               }
 
+            public:
+                /**
+                 * Enable or disable deferred reclamation mode. Mode can be changed only
+                 * when the state is empty.
+                 * RT-unsafe method, thread-unsafe method.
+                 *
+                 * @param defer true to enable deferred reclamation mode
+                 * @return true if mode has been changed, false if state is not empty
+                 */
+                inline bool set_deferred(bool defer)    { return v.set_deferred(defer);         }
+
+                /**
+                 * Check that deferred reclamation mode is enabled.
+                 * @return true if deferred reclamation mode is enabled
+                 */
+                inline bool is_deferred() const         { return v.is_deferred();               }
+
+                /**
+                 * Reserve list items for the set() method in deferred reclamation mode.
+                 * Each state passed to set() consumes one list item, it is returned back
+                 * to the reserve by collect().
+                 * Thread-safe and RT-unsafe method.
+                 *
+                 * @param count number of items to reserve
+                 * @return true on success, false on memory allocation error
+                 */
+                inline bool reserve(size_t count)       { return v.reserve(count);              }
+
+                /**
+                 * Destroy all superseded states put to the garbage list in deferred reclamation
+                 * mode. Can be called periodically by the background thread.
+                 * Thread-safe and RT-unsafe method.
+                 *
+                 * @return number of destroyed states
+                 */
+                inline size_t collect()                 { return v.collect();                   }
+
+            public:
                 /**
                  * Update state. Call deleter for garbage and previous pending state.
+                 * In deferred reclamation mode the previous pending state is moved to the garbage list.
                  * This is thread-safe but RT-unsafe method.
                  * @param new_state new state to set
+                 * @return true on success, false if there is no memory in deferred reclamation mode
                  */
-                inline void push(T *new_state)          { v.push(new_state);                    }
+                inline bool push(T *new_state)          { return v.push(new_state);             }
 
                 /**
                  * Refresh and get current state. Call deleter for garbage and previous pending state.
+                 * In deferred reclamation mode the previous state is moved to the garbage list
+                 * and the method becomes RT-safe.
                  * This is thread safe but RT-unsafe method.
                  * @return pointer to current state
                  */
@@ -164,8 +231,11 @@ namespace lsp
                  * Update state. Do not call deleter for garbage and previous pending state.
                  * This is thread-safe and RT-safe method that should be called only in conjunction with pull().
                  * Otherwise it won't update until garbage is properly cleaned up.
+                 * In deferred reclamation mode the method consumes one item reserved by reserve()
+                 * and fails if there are no reserved items or the reserve is concurrently modified.
                  *
                  * @param new_state new state to set
+                 * @return true if state has been updated
                  */
                 inline bool set(T *new_state)           { return v.set(new_state);              }
 
@@ -173,6 +243,8 @@ namespace lsp
                  * Refresh and get current state. Do not call deleter for garbage and previous pending state.
                  * This is thread-safe and RT-safe method that should be called only in conjunction with push().
                  * Otherwise it won't update until garbage is properly cleaned up.
+                 * In deferred reclamation mode the previous state is moved to the garbage list
+                 * and the state is always updated.
                  *
                  * @return pointer to current state
                  */
@@ -44,6 +44,16 @@ namespace lsp
          */
         typedef     size_t (* hash_func_t)(const void *ptr, size_t size);
 
+        /**
+         * Seeded hashing function
+         *
+         * @param ptr pointer to the object to retrieve hash value, never NULL
+         * @param size size of the object in bytes
+         * @param seed seed of the hash function
+         * @return hash value
+         */
+        typedef     size_t (* seeded_hash_func_t)(const void *ptr, size_t size, uint64_t seed);
+
         /**
          * Comparison function
          * @param a pointer to object a, never NULL
@@ -116,6 +126,50 @@ namespace lsp
         LSP_LLTL_LIB_PUBLIC
         size_t      default_hash_func(const void *ptr, size_t size);
 
+        /**
+         * Fast hashing function based on 64-bit multiply-mix. Processes input by 8-byte words in
+         * several independent lanes, provides better distribution and much higher throughput on
+         * long keys than default_hash_func()
+         *
+         * @param ptr pointer to the object to retrieve hash value
+         * @param size size of the object in bytes
+         * @return hash value
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      fast_hash_func(const void *ptr, size_t size);
+
+        /**
+         * Seeded variant of fast_hash_func(). Hash values for different seeds are unrelated,
+         * so keys colliding for one seed do not collide for another one
+         *
+         * @param ptr pointer to the object to retrieve hash value
+         * @param size size of the object in bytes
+         * @param seed seed of the hash function
+         * @return hash value
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      fast_seeded_hash_func(const void *ptr, size_t size, uint64_t seed);
+
+        /**
+         * Seeded variant of ptr_hash_func(): computes hash of the pointer value
+         *
+         * @param ptr pointer to the object to compute the hash value
+         * @param size size of the object in bytes (not used)
+         * @param seed seed of the hash function
+         * @return hash value
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      ptr_seeded_hash_func(const void *ptr, size_t size, uint64_t seed);
+
+        /**
+         * Generate random seed for the seeded hash function. Each call returns a new seed,
+         * the seeds are not predictable outside of the process.
+         *
+         * @return random seed
+         */
+        LSP_LLTL_LIB_PUBLIC
+        uint64_t    make_hash_seed();
+
         /**
          * Default hashing function for raw pointers (considering pointer
          * being uniquely identifying object)
@@ -136,6 +190,26 @@ namespace lsp
         LSP_LLTL_LIB_PUBLIC
         size_t      char_hash_func(const void *ptr, size_t size);
 
+        /**
+         * Fast hash function for computing C string hash, same to fast_hash_func()
+         * applied to the characters of the string
+         * @param ptr pointer to the C string
+         * @param size size of char type
+         * @return hash function
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      fast_char_hash_func(const void *ptr, size_t size);
+
+        /**
+         * Seeded variant of fast_char_hash_func()
+         * @param ptr pointer to the C string
+         * @param size size of char type
+         * @param seed seed of the hash function
+         * @return hash function
+         */
+        LSP_LLTL_LIB_PUBLIC
+        size_t      fast_seeded_char_hash_func(const void *ptr, size_t size, uint64_t seed);
+
         /**
          * Comparison function for comparing C strings
          * @param a C string a
@@ -167,11 +241,129 @@ namespace lsp
         void       *char_clone_func(const void *ptr, size_t size);
 
         /**
-         * Hash interface: function to perform hashing of the non-NULL object
+         * Comparison function used by sorting routines
+         * @param a pointer to element a
+         * @param b pointer to element b
+         * @param arg additional argument passed to the sorting routine
+         * @return negative value if a less than b, positive if a is greater than b, 0 otherwise
+         */
+        typedef     int (* sort_func_t)(const void *a, const void *b, void *arg);
+
+        /**
+         * Task executed by the executor
+         * @param arg argument of the task
+         * @param index index of the task
+         */
+        typedef     void (* task_func_t)(void *arg, size_t index);
+
+        /**
+         * Type of the plain key used for radix sorting
+         */
+        enum radix_key_t
+        {
+            RADIX_UNSIGNED,     // Unsigned integer
+            RADIX_SIGNED,       // Signed integer
+            RADIX_FLOAT         // IEEE 754 floating-point number
+        };
+
+        /**
+         * Item of radix sorting: ordered key and associated value
+         */
+        struct radix_item_t
+        {
+            uint64_t        key;        // Key converted to the unsigned order
+            uintptr_t       value;      // Associated value (index or pointer)
+        };
+
+        /**
+         * Convert plain key to the unsigned value which keeps the order of keys
+         * @param ptr pointer to the key
+         * @param size size of the key in bytes: 1, 2, 4 or 8
+         * @param type type of the key
+         * @return ordered key
+         */
+        LSP_LLTL_LIB_PUBLIC
+        uint64_t    radix_key(const void *ptr, size_t size, radix_key_t type);
+
+        /**
+         * Perform stable LSD radix sort of items by key. Passes for key bytes which are
+         * the same for all items are skipped, small arrays are sorted by insertion sort.
+         * @param items items to sort
+         * @param tmp temporary buffer of the same size as items
+         * @param n number of items
+         * @param size number of least significant bytes of the key to sort by
+         * @return pointer to the buffer (items or tmp) which contains the sorted data
+         */
+        LSP_LLTL_LIB_PUBLIC
+        radix_item_t   *radix_sort(radix_item_t *items, radix_item_t *tmp, size_t n, size_t size);
+
+        /**
+         * Number of keys processed at once by batched lookup methods of hash containers
+         */
+        static constexpr size_t raw_hash_batch_size     = 32;
+
+        /**
+         * Minimum number of elements in the chunk sorted by single task of parallel sort
+         */
+        static constexpr size_t raw_parallel_sort_chunk = 0x2000;
+
+        /**
+         * Executor interface: runs tasks on the caller-provided pool of workers
+         */
+        struct executor_iface
+        {
+            size_t              workers;    // Number of workers that can run tasks simultaneously
+
+            /**
+             * Execute tasks with indices from 0 to count-1 and wait for completion of all of them
+             * @param self pointer to the executor interface
+             * @param task task to execute
+             * @param arg argument of the task
+             * @param count number of tasks
+             */
+            void              (* execute)(executor_iface *self, task_func_t task, void *arg, size_t count);
+        };
+
+        /**
+         * Sort elements of the array using multiple workers: chunks of the array are sorted
+         * simultaneously and then merged into the single sorted sequence. Falls back to the
+         * sequential sort if there is no executor, the array is too small or there is not
+         * enough memory for temporary buffer.
+         * @param data array to sort
+         * @param n number of elements
+         * @param size size of each element
+         * @param cmp comparison function
+         * @param arg argument to pass to the comparison function
+         * @param stable perform stable sort
+         * @param executor executor to run tasks, may be NULL
+         */
+        LSP_LLTL_LIB_PUBLIC
+        void        parallel_sort(void *data, size_t n, size_t size, sort_func_t cmp, void *arg, bool stable, executor_iface *executor);
+
+        /**
+         * Hash interface: function to perform hashing of the non-NULL object.
+         * If the seeded hashing function is set, it is used instead of the
+         * hashing function with the seed stored in the interface.
+         *
+         * The interface is an aggregate: specializations should value-initialize it
+         * with hash_iface() in the constructor to get NULL seeded function.
          */
         struct hash_iface
         {
             hash_func_t         hash;       // Hashing function
+            seeded_hash_func_t  seeded;     // Seeded hashing function, optional
+            uint64_t            seed;       // Seed for the seeded hashing function
+
+            /**
+             * Compute hash value of the object
+             * @param ptr pointer to the object, never NULL
+             * @param size size of the object in bytes
+             * @return hash value
+             */
+            inline size_t compute(const void *ptr, size_t size) const
+            {
+                return (seeded != NULL) ? seeded(ptr, size, seed) : hash(ptr, size);
+            }
         };
 
         /**
@@ -201,6 +393,15 @@ namespace lsp
             copy_func_t         copy;       // Copy function
         };
 
+        /**
+         * Radix interface: description of the plain key used for radix sorting
+         */
+        struct radix_iface
+        {
+            size_t              size;       // Size of the key in bytes: 1, 2, 4 or 8
+            radix_key_t         type;       // Type of the key
+        };
+
         /**
          * Interface for sorting
          */
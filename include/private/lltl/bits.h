@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_LLTL_BITS_H_
+#define PRIVATE_LLTL_BITS_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static inline size_t bit_count(uint64_t w)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __builtin_popcountll(w);
+        #else
+            size_t count = 0;
+            for ( ; w; w &= w - 1)
+                ++count;
+            return count;
+        #endif
+        }
+
+        static inline size_t first_bit(uint64_t w)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctzll(w);
+        #else
+            size_t index = 0;
+            for ( ; !(w & 1); w >>= 1)
+                ++index;
+            return index;
+        #endif
+        }
+
+        /**
+         * Resize the array of words which stores bits. Newly allocated words and unused
+         * bits of the last word are cleared, zero size releases the array.
+         *
+         * @param data pointer to the array of words
+         * @param capacity pointer to the capacity of the array in words
+         * @param nsize pointer to the size of the set in bits
+         * @param size new size of the set in bits
+         * @return true on success, false on memory allocation error
+         */
+        static inline bool resize_bits(umword_t **data, size_t *capacity, size_t *nsize, size_t size)
+        {
+            if (size == 0)
+            {
+                if (*data != NULL)
+                {
+                    ::free(*data);
+                    *data       = NULL;
+                }
+                *capacity   = 0;
+                *nsize      = 0;
+                return true;
+            }
+
+            size_t cap  = (size + UMWORD_BITS-1) / UMWORD_BITS;
+            size_t bits = size % UMWORD_BITS;
+
+            // Need to realloc data?
+            if (cap != *capacity)
+            {
+                umword_t *buf   = static_cast<umword_t *>(::realloc(*data, cap * sizeof(umword_t)));
+                if (buf == NULL)
+                    return false;
+                if (cap > *capacity)
+                    ::bzero(&buf[*capacity], (cap - *capacity) * sizeof(umword_t));
+                *data           = buf;
+                *capacity       = cap;
+            }
+
+            // Clear unused bits
+            if (bits > 0)
+                (*data)[cap-1] &= ~(UMWORD_MAX << bits);
+            *nsize              = size;
+            return true;
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* PRIVATE_LLTL_BITS_H_ */
@@ -0,0 +1,168 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_LLTL_HASH_H_
+#define PRIVATE_LLTL_HASH_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        /**
+         * Hint the CPU to fetch the memory into the cache before it is accessed
+         * @param ptr pointer to the memory
+         */
+        static inline void prefetch(const void *ptr)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(ptr);
+        #endif /* __GNUC__ */
+        }
+
+        /**
+         * Compute the capacity of the bin array which keeps the average load
+         * of each bin not greater than 4 items
+         * @param count number of items
+         * @return capacity of the bin array, power of two
+         */
+        static inline size_t bin_capacity(size_t count)
+        {
+            size_t cap          = 0x10;
+            while (cap * 4 < count)
+                cap               <<= 1;
+            return cap;
+        }
+
+        static inline int cmp_slab_ptr(const void *a, const void *b)
+        {
+            const uintptr_t pa  = uintptr_t(*static_cast<void * const *>(a));
+            const uintptr_t pb  = uintptr_t(*static_cast<void * const *>(b));
+            return (pa < pb) ? -1 : (pa > pb) ? 1 : 0;
+        }
+
+        /**
+         * Find the slab which contains the pointer
+         * @param vs array of slabs sorted by address
+         * @param n number of slabs
+         * @param ptr pointer to the tuple
+         * @return index of the slab
+         */
+        template <class S>
+        static inline size_t find_slab(S * const *vs, size_t n, const void *ptr)
+        {
+            // Find the last slab located before the pointer
+            size_t first = 0, last = n;
+            while ((last - first) > 1)
+            {
+                const size_t mid    = (first + last) >> 1;
+                if (uintptr_t(vs[mid]) <= uintptr_t(ptr))
+                    first               = mid;
+                else
+                    last                = mid;
+            }
+            return first;
+        }
+
+        /**
+         * Release slabs of tuples which have all their tuples in the pool of free tuples.
+         * Each slab should have the next, count and data[] fields, each tuple should
+         * have the next field.
+         *
+         * @param slabs pointer to the list of slabs
+         * @param pool pointer to the list of free tuples
+         * @return number of tuples removed from the pool
+         */
+        template <class S, class T>
+        size_t trim_slab_pool(S **slabs, T **pool)
+        {
+            size_t n        = 0;
+            for (S *s = *slabs; s != NULL; s = s->next)
+                ++n;
+            if (n <= 0)
+                return 0;
+
+            // Trimming is optional, do nothing if there is no memory for it
+            uint8_t *buf    = static_cast<uint8_t *>(::malloc(n * (sizeof(S *) + sizeof(size_t))));
+            if (buf == NULL)
+                return 0;
+            S **vs          = reinterpret_cast<S **>(buf);
+            size_t *vfree   = reinterpret_cast<size_t *>(&buf[n * sizeof(S *)]);
+
+            n               = 0;
+            for (S *s = *slabs; s != NULL; s = s->next)
+                vs[n++]         = s;
+            ::qsort(vs, n, sizeof(S *), cmp_slab_ptr);
+            for (size_t i=0; i<n; ++i)
+                vfree[i]        = 0;
+
+            // Count free tuples of each slab in a single pass over the pool
+            for (T *t = *pool; t != NULL; t = t->next)
+                ++vfree[find_slab(vs, n, t)];
+
+            // Mark slabs which are not in use
+            size_t released = 0;
+            for (size_t i=0; i<n; ++i)
+            {
+                if (vfree[i] >= vs[i]->count)
+                {
+                    released       += vfree[i];
+                    vfree[i]        = 1;
+                }
+                else
+                    vfree[i]        = 0;
+            }
+
+            if (released > 0)
+            {
+                // Unlink tuples of marked slabs from the pool
+                for (T **pt = pool; *pt != NULL; )
+                {
+                    T *t            = *pt;
+                    if (vfree[find_slab(vs, n, t)])
+                        *pt             = t->next;
+                    else
+                        pt              = &t->next;
+                }
+
+                // Unlink and free marked slabs
+                for (S **ps = slabs; *ps != NULL; )
+                {
+                    S *s            = *ps;
+                    if (vfree[find_slab(vs, n, s)])
+                    {
+                        *ps             = s->next;
+                        ::free(s);
+                    }
+                    else
+                        ps              = &s->next;
+                }
+            }
+
+            ::free(buf);
+            return released;
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* PRIVATE_LLTL_HASH_H_ */
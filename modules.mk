@@ -43,3 +43,8 @@ LIBGNU_VERSION             := system
 LIBGNU_NAME                := libgnu
 LIBGNU_TYPE                := opt
 LIBGNU_LDFLAGS             := -lgnu
+
+LIBPTHREAD_VERSION         := system
+LIBPTHREAD_NAME            := libpthread
+LIBPTHREAD_TYPE            := opt
+LIBPTHREAD_LDFLAGS         := -lpthread
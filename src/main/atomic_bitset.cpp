@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/atomic_bitset.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/lltl/bits.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static inline umword_t fetch_or(umword_t *ptr, umword_t mask)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __atomic_fetch_or(ptr, mask, __ATOMIC_SEQ_CST);
+        #else
+            umword_t w;
+            do {
+                w   = atomic_load(ptr);
+            } while (!atomic_cas(ptr, w, w | mask));
+            return w;
+        #endif
+        }
+
+        static inline umword_t fetch_and(umword_t *ptr, umword_t mask)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __atomic_fetch_and(ptr, mask, __ATOMIC_SEQ_CST);
+        #else
+            umword_t w;
+            do {
+                w   = atomic_load(ptr);
+            } while (!atomic_cas(ptr, w, w & mask));
+            return w;
+        #endif
+        }
+
+        static inline umword_t fetch_xor(umword_t *ptr, umword_t mask)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __atomic_fetch_xor(ptr, mask, __ATOMIC_SEQ_CST);
+        #else
+            umword_t w;
+            do {
+                w   = atomic_load(ptr);
+            } while (!atomic_cas(ptr, w, w ^ mask));
+            return w;
+        #endif
+        }
+
+        atomic_bitset::atomic_bitset()
+        {
+            nSize       = 0;
+            nCapacity   = 0;
+            vData       = NULL;
+        }
+
+        atomic_bitset::~atomic_bitset()
+        {
+            flush();
+        }
+
+        void atomic_bitset::flush()
+        {
+            if (vData != NULL)
+            {
+                ::free(vData);
+                vData       = NULL;
+            }
+
+            nSize       = 0;
+            nCapacity   = 0;
+        }
+
+        bool atomic_bitset::resize(size_t size)
+        {
+            return resize_bits(&vData, &nCapacity, &nSize, size);
+        }
+
+        umword_t atomic_bitset::valid_bits(size_t word) const
+        {
+            size_t bits = nSize - word * UMWORD_BITS;
+            return (bits >= UMWORD_BITS) ? UMWORD_MAX : ~(UMWORD_MAX << bits);
+        }
+
+        bool atomic_bitset::get(size_t index) const
+        {
+            if (index >= nSize)
+                return false;
+
+            umword_t mask   = umword_t(1) << (index % UMWORD_BITS);
+            return atomic_load(&vData[index / UMWORD_BITS]) & mask;
+        }
+
+        bool atomic_bitset::set(size_t index)
+        {
+            if (index >= nSize)
+                return false;
+
+            umword_t mask   = umword_t(1) << (index % UMWORD_BITS);
+            return fetch_or(&vData[index / UMWORD_BITS], mask) & mask;
+        }
+
+        bool atomic_bitset::set(size_t index, bool value)
+        {
+            return (value) ? set(index) : unset(index);
+        }
+
+        bool atomic_bitset::unset(size_t index)
+        {
+            if (index >= nSize)
+                return false;
+
+            umword_t mask   = umword_t(1) << (index % UMWORD_BITS);
+            return fetch_and(&vData[index / UMWORD_BITS], ~mask) & mask;
+        }
+
+        bool atomic_bitset::toggle(size_t index)
+        {
+            if (index >= nSize)
+                return false;
+
+            umword_t mask   = umword_t(1) << (index % UMWORD_BITS);
+            return fetch_xor(&vData[index / UMWORD_BITS], mask) & mask;
+        }
+
+        void atomic_bitset::set_all()
+        {
+            for (size_t i=0; i<nCapacity; ++i)
+                atomic_store(&vData[i], valid_bits(i));
+        }
+
+        void atomic_bitset::unset_all()
+        {
+            for (size_t i=0; i<nCapacity; ++i)
+                atomic_store(&vData[i], 0);
+        }
+
+        ssize_t atomic_bitset::claim_range(size_t first, size_t last)
+        {
+            size_t fw       = first / UMWORD_BITS;
+            size_t lw       = (last + UMWORD_BITS - 1) / UMWORD_BITS;
+
+            for (size_t i=fw; i<lw; ++i)
+            {
+                // Compute the mask of bits allowed for claiming
+                umword_t mask   = valid_bits(i);
+                if (i == fw)
+                    mask           &= UMWORD_MAX << (first % UMWORD_BITS);
+                size_t tail     = last - i * UMWORD_BITS;
+                if (tail < UMWORD_BITS)
+                    mask           &= ~(UMWORD_MAX << tail);
+
+                // Try to claim the first free bit until there are free bits in the word
+                umword_t w      = atomic_load(&vData[i]);
+                for (umword_t free = (~w) & mask; free != 0; free = (~w) & mask)
+                {
+                    umword_t bit    = free & (~free + 1);
+                    w               = fetch_or(&vData[i], bit);
+                    if (!(w & bit))
+                        return i * UMWORD_BITS + first_bit(bit);
+                }
+            }
+
+            return -1;
+        }
+
+        ssize_t atomic_bitset::claim(size_t hint)
+        {
+            if (nSize <= 0)
+                return -1;
+            if (hint >= nSize)
+                hint            = 0;
+
+            ssize_t index   = claim_range(hint, nSize);
+            if ((index < 0) && (hint > 0))
+                index           = claim_range(0, hint);
+
+            return index;
+        }
+
+        size_t atomic_bitset::count() const
+        {
+            size_t result   = 0;
+            for (size_t i=0; i<nCapacity; ++i)
+                result         += bit_count(atomic_load(&vData[i]));
+
+            return result;
+        }
+
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -23,10 +23,127 @@
 #include <lsp-plug.in/stdlib/stdlib.h>
 #include <lsp-plug.in/stdlib/string.h>
 
+#include <private/lltl/bits.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define LLTL_BITSET_AVX2
+#endif /* __AVX2__ */
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define LLTL_BITSET_SSE2
+#endif /* __SSE2__ */
+
 namespace lsp
 {
     namespace lltl
     {
+        static constexpr size_t sse2_words  = 16 / sizeof(umword_t);
+        static constexpr size_t avx2_words  = 32 / sizeof(umword_t);
+
+        struct bitwise_and_op
+        {
+            static inline umword_t word(umword_t a, umword_t b)     { return a & b;                     }
+        #ifdef LLTL_BITSET_SSE2
+            static inline __m128i sse2(__m128i a, __m128i b)        { return _mm_and_si128(a, b);       }
+        #endif /* LLTL_BITSET_SSE2 */
+        #ifdef LLTL_BITSET_AVX2
+            static inline __m256i avx2(__m256i a, __m256i b)        { return _mm256_and_si256(a, b);    }
+        #endif /* LLTL_BITSET_AVX2 */
+        };
+
+        struct bitwise_or_op
+        {
+            static inline umword_t word(umword_t a, umword_t b)     { return a | b;                     }
+        #ifdef LLTL_BITSET_SSE2
+            static inline __m128i sse2(__m128i a, __m128i b)        { return _mm_or_si128(a, b);        }
+        #endif /* LLTL_BITSET_SSE2 */
+        #ifdef LLTL_BITSET_AVX2
+            static inline __m256i avx2(__m256i a, __m256i b)        { return _mm256_or_si256(a, b);     }
+        #endif /* LLTL_BITSET_AVX2 */
+        };
+
+        struct bitwise_xor_op
+        {
+            static inline umword_t word(umword_t a, umword_t b)     { return a ^ b;                     }
+        #ifdef LLTL_BITSET_SSE2
+            static inline __m128i sse2(__m128i a, __m128i b)        { return _mm_xor_si128(a, b);       }
+        #endif /* LLTL_BITSET_SSE2 */
+        #ifdef LLTL_BITSET_AVX2
+            static inline __m256i avx2(__m256i a, __m256i b)        { return _mm256_xor_si256(a, b);    }
+        #endif /* LLTL_BITSET_AVX2 */
+        };
+
+        struct bitwise_andnot_op
+        {
+            static inline umword_t word(umword_t a, umword_t b)     { return a & (~b);                  }
+        #ifdef LLTL_BITSET_SSE2
+            static inline __m128i sse2(__m128i a, __m128i b)        { return _mm_andnot_si128(b, a);    }
+        #endif /* LLTL_BITSET_SSE2 */
+        #ifdef LLTL_BITSET_AVX2
+            static inline __m256i avx2(__m256i a, __m256i b)        { return _mm256_andnot_si256(b, a); }
+        #endif /* LLTL_BITSET_AVX2 */
+        };
+
+        template <class OP>
+        static void bulk_op(umword_t *dst, const umword_t *src, size_t count)
+        {
+            size_t i = 0;
+
+        #ifdef LLTL_BITSET_AVX2
+            for ( ; i + avx2_words <= count; i += avx2_words)
+            {
+                __m256i a   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&dst[i]));
+                __m256i b   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src[i]));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(&dst[i]), OP::avx2(a, b));
+            }
+        #endif /* LLTL_BITSET_AVX2 */
+
+        #ifdef LLTL_BITSET_SSE2
+            for ( ; i + sse2_words <= count; i += sse2_words)
+            {
+                __m128i a   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&dst[i]));
+                __m128i b   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i]));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(&dst[i]), OP::sse2(a, b));
+            }
+        #endif /* LLTL_BITSET_SSE2 */
+
+            for ( ; i < count; ++i)
+                dst[i]      = OP::word(dst[i], src[i]);
+        }
+
+        // Get number of leading words equal to the pattern (all zeros or all ones)
+        static size_t skip_words(const umword_t *src, size_t count, umword_t pattern)
+        {
+            size_t i = 0;
+
+        #ifdef LLTL_BITSET_AVX2
+            const __m256i p256  = _mm256_set1_epi8(char(pattern));
+            for ( ; i + avx2_words <= count; i += avx2_words)
+            {
+                __m256i x   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&src[i]));
+                if (uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, p256))) != 0xffffffffU)
+                    break;
+            }
+        #endif /* LLTL_BITSET_AVX2 */
+
+        #ifdef LLTL_BITSET_SSE2
+            const __m128i p128  = _mm_set1_epi8(char(pattern));
+            for ( ; i + sse2_words <= count; i += sse2_words)
+            {
+                __m128i x   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&src[i]));
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, p128)) != 0xffff)
+                    break;
+            }
+        #endif /* LLTL_BITSET_SSE2 */
+
+            while ((i < count) && (src[i] == pattern))
+                ++i;
+
+            return i;
+        }
+
         bitset::bitset()
         {
             nSize       = 0;
@@ -53,32 +170,7 @@ namespace lsp
 
         bool bitset::resize(size_t size)
         {
-            if (size == 0)
-            {
-                flush();
-                return true;
-            }
-
-            size_t cap  = (size + UMWORD_BITS-1) / UMWORD_BITS;
-            size_t bits = size % UMWORD_BITS;
-
-            // Need to realloc data?
-            if (cap != nCapacity)
-            {
-                umword_t *buf   = static_cast<umword_t *>(::realloc(vData, cap * sizeof(umword_t)));
-                if (buf == NULL)
-                    return false;
-                if (cap > nCapacity)
-                    ::bzero(&buf[nCapacity], (cap - nCapacity) * sizeof(umword_t));
-                vData           = buf;
-                nCapacity       = cap;
-            }
-
-            // Clear unused bits
-            if (bits > 0)
-                vData[nCapacity-1] &= ~(UMWORD_MAX << bits);
-            nSize               = size;
-            return true;
+            return resize_bits(&vData, &nCapacity, &nSize, size);
         }
 
         void bitset::clear()
@@ -353,6 +445,83 @@ namespace lsp
             return total;
         }
 
+        void bitset::trim()
+        {
+            size_t bits         = nSize % UMWORD_BITS;
+            if (bits > 0)
+                vData[words() - 1] &= ~(UMWORD_MAX << bits);
+        }
+
+        void bitset::bitwise_and(const bitset *src)
+        {
+            size_t n        = words();
+            size_t count    = lsp_min(n, src->words());
+
+            bulk_op<bitwise_and_op>(vData, src->vData, count);
+            if (n > count)
+                ::bzero(&vData[count], (n - count) * sizeof(umword_t));
+        }
+
+        void bitset::bitwise_or(const bitset *src)
+        {
+            size_t count    = lsp_min(words(), src->words());
+            if (count <= 0)
+                return;
+
+            bulk_op<bitwise_or_op>(vData, src->vData, count);
+            trim();
+        }
+
+        void bitset::bitwise_xor(const bitset *src)
+        {
+            size_t count    = lsp_min(words(), src->words());
+            if (count <= 0)
+                return;
+
+            bulk_op<bitwise_xor_op>(vData, src->vData, count);
+            trim();
+        }
+
+        void bitset::bitwise_andnot(const bitset *src)
+        {
+            size_t count    = lsp_min(words(), src->words());
+            bulk_op<bitwise_andnot_op>(vData, src->vData, count);
+        }
+
+        size_t bitset::count() const
+        {
+            size_t result   = 0;
+            for (size_t i=0, n=words(); i<n; ++i)
+                result         += bit_count(vData[i]);
+
+            return result;
+        }
+
+        ssize_t bitset::find(size_t index, umword_t invert) const
+        {
+            if (index >= nSize)
+                return -1;
+
+            // Check the first word
+            size_t n        = words();
+            size_t i        = index / UMWORD_BITS;
+            umword_t w      = (vData[i] ^ invert) & (UMWORD_MAX << (index % UMWORD_BITS));
+
+            // Skip words which do not contain matching bits
+            if (w == 0)
+            {
+                ++i;
+                i              += skip_words(&vData[i], n - i, invert);
+                if (i >= n)
+                    return -1;
+                w               = vData[i] ^ invert;
+            }
+
+            // Unused bits of the last word are always zero
+            index           = i * UMWORD_BITS + first_bit(w);
+            return (index < nSize) ? index : -1;
+        }
+
         void bitset::swap(bitset *dst)
         {
             lsp::swap(nSize, dst->nSize);
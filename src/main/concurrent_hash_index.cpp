@@ -0,0 +1,670 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/lltl/concurrent_hash_index.h>
+#include <lsp-plug.in/common/atomic.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static uatomic_t reader_slots       = 0;
+
+        static inline size_t reader_slot()
+        {
+            // Each thread gets it's own counter slot to reduce contention between readers
+            static thread_local size_t slot = size_t(atomic_add(&reader_slots, 1)) % raw_concurrent_hash_readers;
+            return slot;
+        }
+
+        void raw_concurrent_hash_index::init()
+        {
+            table       = NULL;
+            size        = 0;
+            epoch       = 0;
+            for (size_t i=0; i<raw_concurrent_hash_stripes; ++i)
+                atomic_init(locks[i]);
+            atomic_init(gc_lock);
+            retired     = NULL;
+            collected   = NULL;
+            pending     = NULL;
+            for (size_t i=0; i<2; ++i)
+                for (size_t j=0; j<raw_concurrent_hash_readers; ++j)
+                    readers[i][j].value     = 0;
+            ksize       = 0;
+        }
+
+        raw_concurrent_hash_index::counter_t *raw_concurrent_hash_index::read_lock()
+        {
+            const size_t slot   = reader_slot();
+
+            while (true)
+            {
+                // Announce the reader in the counter of current epoch, and ensure that
+                // epoch did not change while announcing
+                const uatomic_t e   = atomic_load(&epoch);
+                counter_t *c        = &readers[e & 1][slot];
+                atomic_add(&c->value, 1);
+                if (atomic_load(&epoch) == e)
+                    return c;
+                atomic_add(&c->value, -1);
+            }
+        }
+
+        void raw_concurrent_hash_index::read_unlock(counter_t *counter)
+        {
+            atomic_add(&counter->value, -1);
+        }
+
+        size_t raw_concurrent_hash_index::active_readers(size_t parity)
+        {
+            size_t count        = 0;
+            for (size_t i=0; i<raw_concurrent_hash_readers; ++i)
+                count              += atomic_load(&readers[parity][i].value);
+            return count;
+        }
+
+        void raw_concurrent_hash_index::lock(size_t hash)
+        {
+            atomic_t *lk        = &locks[hash & (raw_concurrent_hash_stripes - 1)];
+            while (!atomic_trylock(*lk))
+                /* spin */ ;
+        }
+
+        void raw_concurrent_hash_index::unlock(size_t hash)
+        {
+            atomic_unlock(locks[hash & (raw_concurrent_hash_stripes - 1)]);
+        }
+
+        void raw_concurrent_hash_index::lock_all()
+        {
+            // Always lock stripes in the same order to avoid dead locks
+            for (size_t i=0; i<raw_concurrent_hash_stripes; ++i)
+                lock(i);
+        }
+
+        void raw_concurrent_hash_index::unlock_all()
+        {
+            for (size_t i=raw_concurrent_hash_stripes; i > 0; )
+                unlock(--i);
+        }
+
+        void raw_concurrent_hash_index::retire(void *ptr)
+        {
+            garbage_t *g        = static_cast<garbage_t *>(ptr);
+            garbage_t *head;
+
+            do
+            {
+                head                = atomic_load(&retired);
+                g->next             = head;
+            } while (!atomic_cas(&retired, head, g));
+        }
+
+        void raw_concurrent_hash_index::free_list(garbage_t *list)
+        {
+            while (list != NULL)
+            {
+                garbage_t *next     = list->next;
+                ::free(list);
+                list                = next;
+            }
+        }
+
+        void raw_concurrent_hash_index::gc()
+        {
+            if (!atomic_trylock(gc_lock))
+                return;
+            lsp_finally { atomic_unlock(gc_lock); };
+
+            // Move retired objects to the list of current epoch
+            garbage_t *list     = atomic_swap(&retired, static_cast<garbage_t *>(NULL));
+            while (list != NULL)
+            {
+                garbage_t *next     = list->next;
+                list->next          = collected;
+                collected           = list;
+                list                = next;
+            }
+
+            // Objects retired in previous epoch can be freed when all readers
+            // that entered in previous epoch have left
+            for (size_t i=0; i<2; ++i)
+            {
+                if (pending != NULL)
+                {
+                    const uatomic_t prev    = atomic_load(&epoch) - 1;
+                    if (active_readers(prev & 1) > 0)
+                        return;
+
+                    free_list(pending);
+                    pending             = NULL;
+                }
+
+                // Start new epoch for objects retired in current epoch
+                if (collected == NULL)
+                    return;
+                pending             = collected;
+                collected           = NULL;
+                atomic_add(&epoch, 1);
+            }
+        }
+
+        raw_concurrent_hash_index::table_t *raw_concurrent_hash_index::alloc_table(size_t cap)
+        {
+            table_t *t          = static_cast<table_t *>(::malloc(sizeof(table_t) + cap * sizeof(chain_t *)));
+            if (t == NULL)
+                return NULL;
+
+            t->gc.next          = NULL;
+            t->cap              = cap;
+            for (size_t i=0; i<cap; ++i)
+                t->bins[i]          = NULL;
+
+            return t;
+        }
+
+        raw_concurrent_hash_index::table_t *raw_concurrent_hash_index::acquire_table()
+        {
+            table_t *t          = atomic_load(&table);
+            if (t != NULL)
+                return t;
+
+            // Minimum capacity is equal to the number of stripes, so each bin is
+            // always covered by exactly one stripe
+            t                   = alloc_table(raw_concurrent_hash_stripes);
+            if (t == NULL)
+                return NULL;
+            if (atomic_cas(&table, static_cast<table_t *>(NULL), t))
+                return t;
+
+            // Another thread has created the table
+            ::free(t);
+            return atomic_load(&table);
+        }
+
+        raw_concurrent_hash_index::chain_t *raw_concurrent_hash_index::alloc_chain(size_t count)
+        {
+            const size_t nodes  = (count + raw_hash_node_size - 1) / raw_hash_node_size;
+            chain_t *c          = static_cast<chain_t *>(::malloc(sizeof(chain_t) + nodes * sizeof(node_t)));
+            if (c == NULL)
+                return NULL;
+
+            // Link nodes in the same way as hash_index does
+            c->gc.next          = NULL;
+            c->size             = 0;
+            for (size_t i=0; i<nodes; ++i)
+            {
+                node_t *node        = &c->nodes[i];
+                node->prev          = (i > 0) ? &c->nodes[i-1] : NULL;
+                node->next          = (i + 1 < nodes) ? &c->nodes[i+1] : NULL;
+            }
+
+            return c;
+        }
+
+        raw_pair_t *raw_concurrent_hash_index::item_at(chain_t *chain, size_t index)
+        {
+            return &chain->nodes[index / raw_hash_node_size].v[index % raw_hash_node_size];
+        }
+
+        size_t &raw_concurrent_hash_index::hash_at(chain_t *chain, size_t index)
+        {
+            return chain->nodes[index / raw_hash_node_size].hash[index % raw_hash_node_size];
+        }
+
+        void raw_concurrent_hash_index::append(chain_t *chain, size_t hash, const raw_pair_t *item)
+        {
+            const size_t index  = chain->size++;
+            hash_at(chain, index)   = hash;
+            *item_at(chain, index)  = *item;
+        }
+
+        ssize_t raw_concurrent_hash_index::index_of(chain_t *chain, const void *key, size_t hash)
+        {
+            if (chain == NULL)
+                return -1;
+
+            const size_t size   = chain->size;
+            for (size_t i=0; i<size; ++i)
+            {
+                const raw_pair_t *p = item_at(chain, i);
+                if (key != NULL)
+                {
+                    if ((hash_at(chain, i) == hash) && (p->key != NULL) && (cmp.compare(key, p->key, ksize) == 0))
+                        return i;
+                }
+                else if (p->key == NULL)
+                    return i;
+            }
+
+            return -1;
+        }
+
+        raw_pair_t *raw_concurrent_hash_index::find(const void *key, size_t hash)
+        {
+            table_t *t          = atomic_load(&table);
+            if (t == NULL)
+                return NULL;
+
+            chain_t *c          = atomic_load(&t->bins[hash & (t->cap - 1)]);
+            const ssize_t index = index_of(c, key, hash);
+            return (index >= 0) ? item_at(c, index) : NULL;
+        }
+
+        bool raw_concurrent_hash_index::copy_chain(chain_t **dst, chain_t *src, size_t skip, size_t extra)
+        {
+            const size_t count  = (src != NULL) ? src->size : 0;
+            const size_t total  = count + extra - ((skip < count) ? 1 : 0);
+            if (total <= 0)
+            {
+                *dst                = NULL;
+                return true;
+            }
+
+            chain_t *c          = alloc_chain(total);
+            if (c == NULL)
+                return false;
+
+            for (size_t i=0; i<count; ++i)
+            {
+                if (i != skip)
+                    append(c, hash_at(src, i), item_at(src, i));
+            }
+
+            *dst                = c;
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::grow()
+        {
+            lock_all();
+            lsp_finally { unlock_all(); };
+
+            // Check that the table still needs to grow
+            table_t *t          = atomic_load(&table);
+            if ((t == NULL) || (atomic_load(&size) < t->cap * 4))
+                return true;
+
+            const size_t ncap   = t->cap << 1;
+            table_t *nt         = alloc_table(ncap);
+            if (nt == NULL)
+                return false;
+
+            // Split each chain into two chains of the new table
+            for (size_t i=0; i<t->cap; ++i)
+            {
+                chain_t *src        = t->bins[i];
+                if (src == NULL)
+                    continue;
+
+                size_t ny           = 0;
+                for (size_t j=0; j<src->size; ++j)
+                    if (hash_at(src, j) & t->cap)
+                        ++ny;
+
+                chain_t *x          = (src->size > ny) ? alloc_chain(src->size - ny) : NULL;
+                chain_t *y          = (ny > 0) ? alloc_chain(ny) : NULL;
+                if (((x == NULL) && (src->size > ny)) || ((y == NULL) && (ny > 0)))
+                {
+                    if (x != NULL)
+                        ::free(x);
+                    if (y != NULL)
+                        ::free(y);
+                    for (size_t j=0; j<ncap; ++j)
+                        if (nt->bins[j] != NULL)
+                            ::free(nt->bins[j]);
+                    ::free(nt);
+                    return false;
+                }
+
+                for (size_t j=0; j<src->size; ++j)
+                {
+                    const size_t h      = hash_at(src, j);
+                    append((h & t->cap) ? y : x, h, item_at(src, j));
+                }
+
+                nt->bins[i]         = x;
+                nt->bins[i + t->cap]= y;
+            }
+
+            // Publish the new table and retire the old one
+            atomic_store(&table, nt);
+            for (size_t i=0; i<t->cap; ++i)
+                if (t->bins[i] != NULL)
+                    retire(t->bins[i]);
+            retire(t);
+
+            return true;
+        }
+
+        void raw_concurrent_hash_index::flush()
+        {
+            table_t *t          = table;
+            if (t != NULL)
+            {
+                for (size_t i=0; i<t->cap; ++i)
+                    if (t->bins[i] != NULL)
+                        ::free(t->bins[i]);
+                ::free(t);
+                table               = NULL;
+            }
+
+            free_list(retired);
+            free_list(collected);
+            free_list(pending);
+            retired             = NULL;
+            collected           = NULL;
+            pending             = NULL;
+            size                = 0;
+        }
+
+        void raw_concurrent_hash_index::clear()
+        {
+            {
+                lock_all();
+                lsp_finally { unlock_all(); };
+
+                table_t *t          = atomic_load(&table);
+                if (t == NULL)
+                    return;
+
+                // Detach all chains from the table
+                for (size_t i=0; i<t->cap; ++i)
+                {
+                    chain_t *c          = atomic_swap(&t->bins[i], static_cast<chain_t *>(NULL));
+                    if (c != NULL)
+                        retire(c);
+                }
+                atomic_store(&size, 0);
+            }
+
+            gc();
+        }
+
+        void *raw_concurrent_hash_index::get(const void *key, void *dfl)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+
+            counter_t *c        = read_lock();
+            raw_pair_t *p       = find(key, h);
+            void *value         = (p != NULL) ? atomic_load(&p->value) : dfl;
+            read_unlock(c);
+
+            return value;
+        }
+
+        void *raw_concurrent_hash_index::key(const void *key, void *dfl)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+
+            counter_t *c        = read_lock();
+            raw_pair_t *p       = find(key, h);
+            void *res           = (p != NULL) ? p->key : dfl;
+            read_unlock(c);
+
+            return res;
+        }
+
+        bool raw_concurrent_hash_index::contains(const void *key)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+
+            counter_t *c        = read_lock();
+            const bool res      = find(key, h) != NULL;
+            read_unlock(c);
+
+            return res;
+        }
+
+        bool raw_concurrent_hash_index::put(const void *key, void *value, void **ov)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+            if (acquire_table() == NULL)
+                return false;
+
+            size_t count;
+            {
+                lock(h);
+                lsp_finally { unlock(h); };
+
+                // The table can not be replaced while the stripe is locked
+                table_t *t          = atomic_load(&table);
+                chain_t **bin       = &t->bins[h & (t->cap - 1)];
+                chain_t *src        = *bin;
+
+                // Replace the value in place if the key exists
+                const ssize_t index = index_of(src, key, h);
+                if (index >= 0)
+                {
+                    void *old           = atomic_swap(&item_at(src, index)->value, value);
+                    if (ov != NULL)
+                        *ov                 = old;
+                    return true;
+                }
+
+                // Publish the copy of the chain with new item
+                chain_t *dst;
+                if (!copy_chain(&dst, src, size_t(-1), 1))
+                    return false;
+                const raw_pair_t item = { const_cast<void *>(key), value };
+                append(dst, h, &item);
+
+                atomic_store(bin, dst);
+                if (src != NULL)
+                    retire(src);
+                if (ov != NULL)
+                    *ov                 = NULL;
+
+                count               = atomic_add(&size, 1) + 1;
+                if (count < t->cap * 4)
+                    count               = 0;
+            }
+
+            if (count > 0)
+                grow();
+            gc();
+
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::create(const void *key, void *value)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+            if (acquire_table() == NULL)
+                return false;
+
+            size_t count;
+            {
+                lock(h);
+                lsp_finally { unlock(h); };
+
+                table_t *t          = atomic_load(&table);
+                chain_t **bin       = &t->bins[h & (t->cap - 1)];
+                chain_t *src        = *bin;
+                if (index_of(src, key, h) >= 0)
+                    return false;
+
+                chain_t *dst;
+                if (!copy_chain(&dst, src, size_t(-1), 1))
+                    return false;
+                const raw_pair_t item = { const_cast<void *>(key), value };
+                append(dst, h, &item);
+
+                atomic_store(bin, dst);
+                if (src != NULL)
+                    retire(src);
+
+                count               = atomic_add(&size, 1) + 1;
+                if (count < t->cap * 4)
+                    count               = 0;
+            }
+
+            if (count > 0)
+                grow();
+            gc();
+
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::replace(const void *key, void *value, void **ov)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+            if (atomic_load(&table) == NULL)
+                return false;
+
+            lock(h);
+            lsp_finally { unlock(h); };
+
+            table_t *t          = atomic_load(&table);
+            chain_t *src        = t->bins[h & (t->cap - 1)];
+            const ssize_t index = index_of(src, key, h);
+            if (index < 0)
+                return false;
+
+            void *old           = atomic_swap(&item_at(src, index)->value, value);
+            if (ov != NULL)
+                *ov                 = old;
+
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::remove(const void *key, void **ov)
+        {
+            const size_t h      = (key != NULL) ? hash.compute(key, ksize) : 0;
+            if (atomic_load(&table) == NULL)
+                return false;
+
+            {
+                lock(h);
+                lsp_finally { unlock(h); };
+
+                table_t *t          = atomic_load(&table);
+                chain_t **bin       = &t->bins[h & (t->cap - 1)];
+                chain_t *src        = *bin;
+                const ssize_t index = index_of(src, key, h);
+                if (index < 0)
+                    return false;
+
+                // Publish the copy of the chain without the item
+                chain_t *dst;
+                if (!copy_chain(&dst, src, index, 0))
+                    return false;
+                if (ov != NULL)
+                    *ov                 = item_at(src, index)->value;
+
+                atomic_store(bin, dst);
+                retire(src);
+                atomic_add(&size, -1);
+            }
+
+            gc();
+
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::keys(raw_parray *k)
+        {
+            raw_parray kt;
+            kt.init();
+            lsp_finally { kt.flush(); };
+
+            counter_t *c        = read_lock();
+            lsp_finally { read_unlock(c); };
+
+            table_t *t          = atomic_load(&table);
+            if (t != NULL)
+            {
+                for (size_t i=0; i<t->cap; ++i)
+                {
+                    chain_t *ch         = atomic_load(&t->bins[i]);
+                    for (size_t j=0, n=(ch != NULL) ? ch->size : 0; j<n; ++j)
+                        if (kt.append(item_at(ch, j)->key) == NULL)
+                            return false;
+                }
+            }
+
+            kt.swap(k);
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::values(raw_parray *v)
+        {
+            raw_parray vt;
+            vt.init();
+            lsp_finally { vt.flush(); };
+
+            counter_t *c        = read_lock();
+            lsp_finally { read_unlock(c); };
+
+            table_t *t          = atomic_load(&table);
+            if (t != NULL)
+            {
+                for (size_t i=0; i<t->cap; ++i)
+                {
+                    chain_t *ch         = atomic_load(&t->bins[i]);
+                    for (size_t j=0, n=(ch != NULL) ? ch->size : 0; j<n; ++j)
+                        if (vt.append(atomic_load(&item_at(ch, j)->value)) == NULL)
+                            return false;
+                }
+            }
+
+            vt.swap(v);
+            return true;
+        }
+
+        bool raw_concurrent_hash_index::items(raw_parray *k, raw_parray *v)
+        {
+            raw_parray kt, vt;
+            kt.init();
+            vt.init();
+            lsp_finally {
+                kt.flush();
+                vt.flush();
+            };
+
+            counter_t *c        = read_lock();
+            lsp_finally { read_unlock(c); };
+
+            table_t *t          = atomic_load(&table);
+            if (t != NULL)
+            {
+                for (size_t i=0; i<t->cap; ++i)
+                {
+                    chain_t *ch         = atomic_load(&t->bins[i]);
+                    for (size_t j=0, n=(ch != NULL) ? ch->size : 0; j<n; ++j)
+                    {
+                        raw_pair_t *p       = item_at(ch, j);
+                        if (kt.append(p->key) == NULL)
+                            return false;
+                        if (vt.append(atomic_load(&p->value)) == NULL)
+                            return false;
+                    }
+                }
+            }
+
+            kt.swap(k);
+            vt.swap(v);
+            return true;
+        }
+
+    } /* namespace lltl */
+} /* namespace lsp */
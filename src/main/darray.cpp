@@ -19,6 +19,7 @@
  * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <lsp-plug.in/common/alloc.h>
 #include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/stdlib/stdlib.h>
 
@@ -28,6 +29,49 @@ namespace lsp
     {
         inline size_t nonzero(size_t count, size_t n) { return ((count + n) > 0) ? n : 1; }
 
+        static uint8_t *alloc_items(size_t bytes, size_t align)
+        {
+            if (align == 0)
+                return static_cast<uint8_t *>(::malloc(bytes));
+
+            // Store pointer to the allocated block just before the aligned data
+            uint8_t *raw    = static_cast<uint8_t *>(::malloc(bytes + align + sizeof(void *)));
+            if (raw == NULL)
+                return NULL;
+            uint8_t *ptr    = static_cast<uint8_t *>(align_ptr(&raw[sizeof(void *)], align));
+            reinterpret_cast<void **>(ptr)[-1]  = raw;
+
+            return ptr;
+        }
+
+        static void free_items(uint8_t *ptr, size_t align)
+        {
+            if (ptr == NULL)
+                return;
+            if (align == 0)
+                ::free(ptr);
+            else
+                ::free(reinterpret_cast<void **>(ptr)[-1]);
+        }
+
+        static uint8_t *realloc_items(uint8_t *ptr, size_t used, size_t bytes, size_t align)
+        {
+            if (align == 0)
+                return static_cast<uint8_t *>(::realloc(ptr, bytes));
+
+            // The offset of aligned data may change, so allocate new block
+            uint8_t *res    = alloc_items(bytes, align);
+            if (res == NULL)
+                return NULL;
+            if (ptr != NULL)
+            {
+                ::memcpy(res, ptr, lsp_min(used, bytes));
+                free_items(ptr, align);
+            }
+
+            return res;
+        }
+
         const iter_vtbl_t raw_darray::iterator_vtbl =
         {
             iter_move,
@@ -43,6 +87,72 @@ namespace lsp
             vItems      = NULL;
             nCapacity   = 0;
             nSizeOf     = n_sizeof;
+            nAlign      = 0;
+            vInline     = NULL;
+            nInline     = 0;
+        }
+
+        void raw_darray::init(size_t n_sizeof, size_t align)
+        {
+            nItems      = 0;
+            vItems      = NULL;
+            nCapacity   = 0;
+            nSizeOf     = n_sizeof;
+            nAlign      = align;
+            vInline     = NULL;
+            nInline     = 0;
+        }
+
+        void raw_darray::init(size_t n_sizeof, uint8_t *buf, size_t capacity)
+        {
+            nItems      = 0;
+            vItems      = buf;
+            nCapacity   = capacity;
+            nSizeOf     = n_sizeof;
+            nAlign      = 0;
+            vInline     = buf;
+            nInline     = capacity;
+        }
+
+        bool raw_darray::detach()
+        {
+            if ((vInline == NULL) || (vItems != vInline))
+                return true;
+
+            // Empty array does not need any storage
+            if (nItems <= 0)
+            {
+                vItems          = NULL;
+                nCapacity       = 0;
+                return true;
+            }
+
+            // Move data from the inline storage to the heap
+            const size_t capacity = lsp_max(nItems, size_t(32));
+            uint8_t *ptr    = alloc_items(nSizeOf * capacity, nAlign);
+            if (ptr == NULL)
+                return false;
+            ::memcpy(ptr, vItems, nItems * nSizeOf);
+
+            vItems          = ptr;
+            nCapacity       = capacity;
+            return true;
+        }
+
+        void raw_darray::attach()
+        {
+            if ((vInline == NULL) || (vItems == vInline) || (nItems > nInline))
+                return;
+
+            // Move data from the heap to the inline storage
+            if (vItems != NULL)
+            {
+                ::memcpy(vInline, vItems, nItems * nSizeOf);
+                free_items(vItems, nAlign);
+            }
+
+            vItems          = vInline;
+            nCapacity       = nInline;
         }
 
         bool raw_darray::grow(size_t capacity)
@@ -50,8 +160,24 @@ namespace lsp
             if (capacity < 32)
                 capacity        = 32;
 
+            // Spill data from the inline storage to the heap
+            if ((vInline != NULL) && (vItems == vInline))
+            {
+                if (capacity <= nInline)
+                    return true;
+
+                uint8_t *ptr    = alloc_items(nSizeOf * capacity, nAlign);
+                if (ptr == NULL)
+                    return false;
+                ::memcpy(ptr, vItems, nItems * nSizeOf);
+
+                vItems          = ptr;
+                nCapacity       = capacity;
+                return true;
+            }
+
             // Do aligned (re)allocation
-            uint8_t *ptr    = reinterpret_cast<uint8_t *>(::realloc(vItems, nSizeOf * capacity));
+            uint8_t *ptr    = realloc_items(vItems, nItems * nSizeOf, nSizeOf * capacity, nAlign);
             if (ptr == NULL)
                 return false;
 
@@ -63,6 +189,15 @@ namespace lsp
 
         bool raw_darray::truncate(size_t capacity)
         {
+            // Use the inline storage if data fits into it
+            if ((vInline != NULL) && ((vItems == vInline) || (capacity <= nInline)))
+            {
+                if (nItems > capacity)
+                    nItems          = capacity;
+                attach();
+                return true;
+            }
+
             if (capacity < 32)
             {
                 if (capacity == 0)
@@ -76,7 +211,7 @@ namespace lsp
                 return true;
 
             // Do aligned (re)allocation
-            uint8_t *ptr    = reinterpret_cast<uint8_t *>(::realloc(vItems, nSizeOf * capacity));
+            uint8_t *ptr    = realloc_items(vItems, nItems * nSizeOf, nSizeOf * capacity, nAlign);
             if (ptr == NULL)
                 return false;
 
@@ -88,6 +223,34 @@ namespace lsp
             return true;
         }
 
+        uint8_t *raw_darray::release()
+        {
+            // Data stored in the inline storage should be moved to the heap first
+            if (!detach())
+                return NULL;
+
+            uint8_t *ptr    = vItems;
+            if ((nAlign != 0) && (ptr != NULL))
+            {
+                // The caller frees the memory with ::free(), so aligned data should be copied
+                const size_t bytes  = nItems * nSizeOf;
+                ptr             = static_cast<uint8_t *>(::malloc(lsp_max(bytes, nSizeOf)));
+                if (ptr == NULL)
+                {
+                    attach();
+                    return NULL;
+                }
+                ::memcpy(ptr, vItems, bytes);
+                free_items(vItems, nAlign);
+            }
+
+            vItems          = vInline;
+            nCapacity       = nInline;
+            nItems          = 0;
+
+            return ptr;
+        }
+
         uint8_t *raw_darray::slice(size_t idx, size_t size)
         {
             if (size <= 0)
@@ -248,22 +411,41 @@ namespace lsp
             return res;
         }
 
-        void raw_darray::swap(raw_darray *src)
+        bool raw_darray::swap(raw_darray *src)
         {
-            raw_darray tmp;
-            tmp     = *this;
-            *this   = *src;
-            *src    = tmp;
+            // Alignment travels with the data but the inline storage does not guarantee it
+            if ((nAlign != src->nAlign) && ((vInline != NULL) || (src->vInline != NULL)))
+                return false;
+
+            // Inline storages are not exchanged, so move data to the heap first
+            if (!detach())
+                return false;
+            if (!src->detach())
+            {
+                attach();
+                return false;
+            }
+
+            lsp::swap(nItems, src->nItems);
+            lsp::swap(vItems, src->vItems);
+            lsp::swap(nCapacity, src->nCapacity);
+            lsp::swap(nSizeOf, src->nSizeOf);
+            lsp::swap(nAlign, src->nAlign);
+
+            // Return data back to the inline storage if possible
+            attach();
+            src->attach();
+
+            return true;
         }
 
         void raw_darray::flush()
         {
-            if (vItems != NULL)
-            {
-                ::free(vItems);
-                vItems      = NULL;
-            }
-            nCapacity   = 0;
+            if (vItems != vInline)
+                free_items(vItems, nAlign);
+
+            vItems      = vInline;
+            nCapacity   = nInline;
             nItems      = 0;
         }
 
@@ -495,6 +677,78 @@ namespace lsp
             lsp::ssort_r(vItems, nItems, nSizeOf, raw_cmp, xf.p);
         }
 
+        void raw_darray::pqsort(sort_closure_t *c, executor_iface *executor)
+        {
+            parallel_sort(vItems, nItems, nSizeOf, closure_cmp, c, false, executor);
+        }
+
+        void raw_darray::pqsort(cmp_func_t f, executor_iface *executor)
+        {
+            union
+            {
+                cmp_func_t f;
+                void *p;
+            } xf;
+            xf.f = f;
+            parallel_sort(vItems, nItems, nSizeOf, raw_cmp, xf.p, false, executor);
+        }
+
+        void raw_darray::pssort(sort_closure_t *c, executor_iface *executor)
+        {
+            parallel_sort(vItems, nItems, nSizeOf, closure_cmp, c, true, executor);
+        }
+
+        void raw_darray::pssort(cmp_func_t f, executor_iface *executor)
+        {
+            union
+            {
+                cmp_func_t f;
+                void *p;
+            } xf;
+            xf.f = f;
+            parallel_sort(vItems, nItems, nSizeOf, raw_cmp, xf.p, true, executor);
+        }
+
+        bool raw_darray::rsort(size_t offset, const radix_iface *key)
+        {
+            if ((key->size != 1) && (key->size != 2) && (key->size != 4) && (key->size != 8))
+                return false;
+            if ((key->type == RADIX_FLOAT) && (key->size != 4) && (key->size != 8))
+                return false;
+            if ((offset + key->size) > nSizeOf)
+                return false;
+            if (nItems <= 1)
+                return true;
+
+            // Allocate buffers for sorting items and reordering data
+            const size_t items_size = nItems * sizeof(radix_item_t);
+            uint8_t *ptr    = static_cast<uint8_t *>(::malloc(items_size * 2 + nItems * nSizeOf));
+            if (ptr == NULL)
+                return false;
+            lsp_finally { ::free(ptr); };
+
+            radix_item_t *items = reinterpret_cast<radix_item_t *>(ptr);
+            radix_item_t *tmp   = &items[nItems];
+            uint8_t *data       = &ptr[items_size * 2];
+
+            // Extract keys and sort
+            const uint8_t *src  = &vItems[offset];
+            for (size_t i=0; i<nItems; ++i, src += nSizeOf)
+            {
+                items[i].key        = radix_key(src, key->size, key->type);
+                items[i].value      = i;
+            }
+            items               = radix_sort(items, tmp, nItems, key->size);
+
+            // Reorder data
+            uint8_t *dst        = data;
+            for (size_t i=0; i<nItems; ++i, dst += nSizeOf)
+                ::memcpy(dst, &vItems[items[i].value * nSizeOf], nSizeOf);
+            ::memcpy(vItems, data, nItems * nSizeOf);
+
+            return true;
+        }
+
         raw_iterator raw_darray::iter()
         {
             if (nItems <= 0)
@@ -62,6 +62,76 @@ namespace lsp
             nUnused         = 0;
             nSizeOf         = n_sizeof;
             nChunkSize      = chunk_capacity;
+            vDir            = NULL;
+            nDirCap         = 0;
+            nDirHead        = 0;
+            nDirSize        = 0;
+        }
+
+        bool raw_ddeque::dir_reserve(size_t count)
+        {
+            const size_t size       = nDirSize + count;
+            if (size <= nDirCap)
+                return true;
+
+            size_t cap              = lsp_max(nDirCap, size_t(0x10));
+            while (cap < size)
+                cap                   <<= 1;
+
+            chunk_t **dir           = static_cast<chunk_t **>(malloc(cap * sizeof(chunk_t *)));
+            if (dir == NULL)
+                return false;
+
+            // Store chunks starting at the beginning of new directory
+            for (size_t i=0; i<nDirSize; ++i)
+                dir[i]                  = dir_at(i);
+            if (vDir != NULL)
+                free(vDir);
+
+            vDir                    = dir;
+            nDirCap                 = cap;
+            nDirHead                = 0;
+
+            return true;
+        }
+
+        void raw_ddeque::dir_push_back(chunk_t *chunk)
+        {
+            vDir[(nDirHead + nDirSize) & (nDirCap - 1)] = chunk;
+            ++nDirSize;
+        }
+
+        void raw_ddeque::dir_push_front(chunk_t *chunk)
+        {
+            nDirHead                = (nDirHead - 1) & (nDirCap - 1);
+            vDir[nDirHead]          = chunk;
+            ++nDirSize;
+        }
+
+        void raw_ddeque::dir_pop_back()
+        {
+            --nDirSize;
+        }
+
+        void raw_ddeque::dir_pop_front()
+        {
+            nDirHead                = (nDirHead + 1) & (nDirCap - 1);
+            --nDirSize;
+        }
+
+        raw_ddeque::chunk_t *raw_ddeque::dir_at(size_t index) const
+        {
+            return vDir[(nDirHead + index) & (nDirCap - 1)];
+        }
+
+        raw_ddeque::chunk_t *raw_ddeque::locate(size_t index, size_t *offset) const
+        {
+            // All chunks except head start at zero offset, all chunks except tail are full,
+            // so the position of element relative to the beginning of the head chunk
+            // uniquely identifies the chunk.
+            const size_t position   = pHead->nHead + index;
+            *offset                 = position % nChunkSize;
+            return dir_at(position / nChunkSize);
         }
 
         void raw_ddeque::free_chunk_list(chunk_t *head)
@@ -153,6 +223,16 @@ namespace lsp
 
         void raw_ddeque::clear()
         {
+            // Reset state of chunks
+            for (size_t i=0; i<nDirSize; ++i)
+            {
+                chunk_t *chunk          = dir_at(i);
+                chunk->nHead            = 0;
+                chunk->nTail            = 0;
+            }
+            nDirHead        = 0;
+            nDirSize        = 0;
+
             if (pTail != NULL)
             {
                 if (pUnused != NULL)
@@ -183,6 +263,8 @@ namespace lsp
         {
             free_chunk_list(pHead);
             free_chunk_list(pUnused);
+            if (vDir != NULL)
+                free(vDir);
 
             // Reset state
             pHead           = NULL;
@@ -191,6 +273,10 @@ namespace lsp
             nItems          = 0;
             nChunks         = 0;
             nUnused         = 0;
+            vDir            = NULL;
+            nDirCap         = 0;
+            nDirHead        = 0;
+            nDirSize        = 0;
         }
 
         raw_ddeque::chunk_t *raw_ddeque::acquire_chunk()
@@ -278,16 +364,21 @@ namespace lsp
             // Check that we have tail chunk
             if (pTail == NULL)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 pTail               = acquire_chunk();
                 if (pTail == NULL)
                     return NULL;
 
                 pHead               = pTail;
+                dir_push_back(pTail);
             }
 
             // Check that tail chunk has place to store data
             if (pTail->nTail >= nChunkSize)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 chunk_t *chunk      = acquire_chunk();
                 if (chunk == NULL)
                     return NULL;
@@ -295,6 +386,7 @@ namespace lsp
                 chunk->pPrev        = pTail;
                 pTail->pNext        = chunk;
                 pTail               = chunk;
+                dir_push_back(chunk);
             }
 
             // Place data
@@ -309,16 +401,21 @@ namespace lsp
             // Check that we have tail chunk
             if (pTail == NULL)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 pTail               = acquire_chunk();
                 if (pTail == NULL)
                     return NULL;
 
                 pHead               = pTail;
+                dir_push_back(pTail);
             }
 
             // Check that tail chunk has place to store data
             if (pTail->nTail >= nChunkSize)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 chunk_t *chunk      = acquire_chunk();
                 if (chunk == NULL)
                     return NULL;
@@ -326,6 +423,7 @@ namespace lsp
                 chunk->pPrev        = pTail;
                 pTail->pNext        = chunk;
                 pTail               = chunk;
+                dir_push_back(chunk);
             }
 
             // Place data
@@ -339,6 +437,8 @@ namespace lsp
             // Check that we have tail chunk
             if (pHead == NULL)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 pHead               = acquire_chunk();
                 if (pHead == NULL)
                     return NULL;
@@ -347,11 +447,14 @@ namespace lsp
                 pHead->nTail        = nChunkSize;
 
                 pTail               = pHead;
+                dir_push_front(pHead);
             }
 
             // Check that head chunk has place to store data
             if (pHead->nHead <= 0)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 chunk_t *chunk      = acquire_chunk();
                 if (chunk == NULL)
                     return NULL;
@@ -362,6 +465,7 @@ namespace lsp
                 chunk->pNext        = pHead;
                 pHead->pPrev        = chunk;
                 pHead               = chunk;
+                dir_push_front(chunk);
             }
 
             // Place data
@@ -376,6 +480,8 @@ namespace lsp
             // Check that we have tail chunk
             if (pHead == NULL)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 pHead               = acquire_chunk();
                 if (pHead == NULL)
                     return NULL;
@@ -384,11 +490,14 @@ namespace lsp
                 pHead->nTail        = nChunkSize;
 
                 pTail               = pHead;
+                dir_push_front(pHead);
             }
 
             // Check that head chunk has place to store data
             if (pHead->nHead <= 0)
             {
+                if (!dir_reserve(1))
+                    return NULL;
                 chunk_t *chunk      = acquire_chunk();
                 if (chunk == NULL)
                     return NULL;
@@ -399,6 +508,7 @@ namespace lsp
                 chunk->pNext        = pHead;
                 pHead->pPrev        = chunk;
                 pHead               = chunk;
+                dir_push_front(chunk);
             }
 
             // Place data
@@ -452,6 +562,8 @@ namespace lsp
             if (pTail == NULL)
             {
                 n_chunks                = chunks_count(count);
+                if (!dir_reserve(n_chunks))
+                    return NULL;
                 chunks                  = acquire_chunk_list(n_chunks);
                 if (chunks == NULL)
                     return NULL;
@@ -459,16 +571,20 @@ namespace lsp
                 pTail                   = chunks->pPrev;
                 pHead                   = chunks;
                 chunks->pPrev           = NULL;     // Remove pointer to the tail
+                for (chunk_t *curr = chunks; curr != NULL; curr = curr->pNext)
+                    dir_push_back(curr);
 
                 return chunks;
             }
 
             // Check that tail has enough elements to store
-            if ((pTail->nTail + count) < nChunkSize)
+            if ((pTail->nTail + count) <= nChunkSize)
                 return pTail;
 
             // Allocate extra chunks and place them after tail
             n_chunks                = chunks_count(count + pTail->nTail - nChunkSize);
+            if (!dir_reserve(n_chunks))
+                return NULL;
             chunks                  = acquire_chunk_list(n_chunks);
             if (chunks == NULL)
                 return NULL;
@@ -477,6 +593,8 @@ namespace lsp
             old_tail->pNext         = chunks;
             pTail                   = chunks->pPrev;
             chunks->pPrev           = old_tail;
+            for (chunk_t *curr = chunks; curr != NULL; curr = curr->pNext)
+                dir_push_back(curr);
 
             return old_tail;
         }
@@ -490,6 +608,8 @@ namespace lsp
             if (pHead == NULL)
             {
                 n_chunks                = chunks_count(count);
+                if (!dir_reserve(n_chunks))
+                    return NULL;
                 chunks                  = acquire_chunk_list(n_chunks);
                 if (chunks == NULL)
                     return NULL;
@@ -497,11 +617,14 @@ namespace lsp
                 pTail                   = chunks->pPrev;
                 pHead                   = chunks;
                 chunks->pPrev           = NULL;     // Remove pointer to the tail
+                for (chunk_t *curr = chunks; curr != NULL; curr = curr->pNext)
+                    dir_push_back(curr);
 
-                pHead->nTail            = nChunkSize;
-                pHead->nHead            = nChunkSize;
+                // Data is filled from the end of the tail chunk
+                pTail->nTail            = nChunkSize;
+                pTail->nHead            = nChunkSize;
 
-                return chunks;
+                return pTail;
             }
 
             // Check that head has enough elements to store
@@ -510,6 +633,8 @@ namespace lsp
 
             // Allocate extra chunks and place them before head
             n_chunks                = chunks_count(count - pHead->nHead);
+            if (!dir_reserve(n_chunks))
+                return NULL;
             chunks                  = acquire_chunk_list(n_chunks);
             if (chunks == NULL)
                 return NULL;
@@ -521,12 +646,17 @@ namespace lsp
             old_head->pPrev         = tail;
             pHead                   = chunks;
             chunks->pPrev           = NULL;
+            for (chunk_t *curr = tail; curr != NULL; curr = curr->pPrev)
+                dir_push_front(curr);
 
             return old_head;
         }
 
         bool raw_ddeque::push_back(const void *data, size_t count)
         {
+            if (count <= 0)
+                return true;
+
             chunk_t *tail           = preallocate_back(count);
             if (tail == NULL)
                 return false;
@@ -560,6 +690,9 @@ namespace lsp
 
         bool raw_ddeque::prepend(const void *data, size_t count)
         {
+            if (count <= 0)
+                return true;
+
             chunk_t *head           = preallocate_front(count);
             if (head == NULL)
                 return false;
@@ -594,6 +727,9 @@ namespace lsp
 
         bool raw_ddeque::push_front(const void *data, size_t count)
         {
+            if (count <= 0)
+                return true;
+
             chunk_t *head           = preallocate_front(count);
             if (head == NULL)
                 return false;
@@ -642,6 +778,7 @@ namespace lsp
                     pHead                       = NULL;
                 else
                     pTail->pNext                = NULL;
+                dir_pop_back();
                 release_chunk(chunk);
             }
 
@@ -663,6 +800,7 @@ namespace lsp
                     pHead                       = NULL;
                 else
                     pTail->pNext                = NULL;
+                dir_pop_back();
                 release_chunk(chunk);
             }
 
@@ -686,6 +824,7 @@ namespace lsp
                     pTail                       = NULL;
                 else
                     pHead->pPrev                = NULL;
+                dir_pop_front();
                 release_chunk(chunk);
             }
 
@@ -707,6 +846,7 @@ namespace lsp
                     pTail                       = NULL;
                 else
                     pHead->pPrev                = NULL;
+                dir_pop_front();
                 release_chunk(chunk);
             }
 
@@ -715,48 +855,24 @@ namespace lsp
 
         void *raw_ddeque::get(size_t index)
         {
-            const size_t half = nItems >> 1;
-            if (index < half)
-            {
-                // Search from the head
-                for (chunk_t * curr = pHead; curr != NULL; curr = curr->pNext)
-                {
-                    const size_t used   = curr->nTail - curr->nHead;
-                    if (index < used)
-                        return &curr->vData[(curr->nHead + index) * nSizeOf];
-
-                    index          -= used;
-                }
-            }
-            else if (index < nItems)
-            {
-                index = nItems - index - 1;
-
-                // Search from the tail
-                for (chunk_t * curr = pTail; curr != NULL; curr = curr->pPrev)
-                {
-                    const size_t used   = curr->nTail - curr->nHead;
-                    if (index < used)
-                        return &curr->vData[(curr->nTail - index - 1) * nSizeOf];
-
-                    index          -= used;
-                }
-            }
+            if (index >= nItems)
+                return NULL;
 
-            return NULL;
+            size_t offset;
+            chunk_t *chunk = locate(index, &offset);
+            return &chunk->vData[offset * nSizeOf];
         }
 
         ssize_t raw_ddeque::index_of(const void *ptr)
         {
-            size_t index = 0;
             const uint8_t *xptr = static_cast<const uint8_t *>(ptr);
             const size_t end = nChunkSize * nSizeOf;
 
-            // Search from the head
-            for (const chunk_t * curr = pHead; curr != NULL; curr = curr->pNext)
+            // Search the chunk in the directory
+            for (size_t i=0; i<nDirSize; ++i)
             {
                 // Check that pointer belongs to this chunk
-                const size_t used   = curr->nTail - curr->nHead;
+                const chunk_t *curr = dir_at(i);
                 if ((xptr >= curr->vData) && (xptr < &curr->vData[end]))
                 {
                     size_t offset = (xptr - curr->vData) / nSizeOf;
@@ -764,11 +880,11 @@ namespace lsp
                         return -2;
                     if (offset >= curr->nTail)
                         return -3;
+                    if (xptr != &curr->vData[offset * nSizeOf])
+                        return -4;
 
-                    return (xptr == &curr->vData[offset * nSizeOf]) ? index + offset - curr->nHead : -4;
+                    return i * nChunkSize + offset - pHead->nHead;
                 }
-
-                index          += used;
             }
 
             return -1;
@@ -801,6 +917,7 @@ namespace lsp
                         pTail                       = NULL;
                     else
                         pHead->pPrev                = NULL;
+                    dir_pop_front();
                     release_chunk(chunk);
                 }
             }
@@ -837,6 +954,7 @@ namespace lsp
                         pHead                       = NULL;
                     else
                         pTail->pNext                = NULL;
+                    dir_pop_back();
                     release_chunk(chunk);
                 }
             }
@@ -873,6 +991,7 @@ namespace lsp
                         pHead                       = NULL;
                     else
                         pTail->pNext                = NULL;
+                    dir_pop_back();
                     release_chunk(chunk);
                 }
             }
@@ -916,50 +1035,22 @@ namespace lsp
 
         void raw_ddeque::iter_move(raw_iterator *i, ssize_t n)
         {
+            raw_ddeque *self    = static_cast<raw_ddeque *>(i->container);
             chunk_t *chunk      = static_cast<chunk_t *>(i->item);
-            size_t offset       = i->offset;
-            size_t index        = i->index;
-
-            while (n > 0)
+            const ssize_t index = ssize_t(i->index) + n;
+            if ((index < 0) || (size_t(index) >= self->nItems))
             {
-                const size_t to_do  = lsp_min(chunk->nTail - offset, size_t(n));
-                offset             += to_do;
-                index              += to_do;
-                if (offset >= chunk->nTail)
-                {
-                    chunk               = chunk->pNext;
-                    if (chunk == NULL)
-                    {
-                        *i                  = raw_iterator::INVALID;
-                        return;
-                    }
-                    offset              = chunk->nHead;
-                }
-
-                n                  -= to_do;
+                *i                  = raw_iterator::INVALID;
+                return;
             }
 
-            while (n < 0)
-            {
-                if (offset <= chunk->nHead)
-                {
-                    chunk               = chunk->pPrev;
-                    if (chunk == NULL)
-                    {
-                        *i                  = raw_iterator::INVALID;
-                        return;
-                    }
-                    offset              = chunk->nTail;
-                }
-
-                const size_t to_do  = lsp_min(offset - chunk->nHead, size_t(-n));
-                offset             -= to_do;
-                index              -= to_do;
-                n                  += to_do;
-            }
+            // Check that iterator stays within the same chunk
+            const ssize_t offset= ssize_t(i->offset) + n;
+            if ((offset >= ssize_t(chunk->nHead)) && (offset < ssize_t(chunk->nTail)))
+                i->offset           = offset;
+            else
+                i->item             = self->locate(index, &i->offset);
 
-            i->item             = chunk;
-            i->offset           = offset;
             i->index            = index;
         }
 
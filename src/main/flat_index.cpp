@@ -0,0 +1,608 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/lltl/flat_index.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define LLTL_FLAT_INDEX_SSE2
+#endif /* __SSE2__ */
+
+namespace lsp
+{
+    namespace lltl
+    {
+        constexpr uint8_t raw_flat_index::CTRL_EMPTY;
+        constexpr uint8_t raw_flat_index::CTRL_DELETED;
+
+        const iter_vtbl_t raw_flat_index::key_iterator_vtbl =
+        {
+            iter_move,
+            iter_get_key,
+            iter_compare,
+            iter_compare,
+            iter_count
+        };
+
+        const iter_vtbl_t raw_flat_index::value_iterator_vtbl =
+        {
+            iter_move,
+            iter_get_value,
+            iter_compare,
+            iter_compare,
+            iter_count
+        };
+
+        const iter_vtbl_t raw_flat_index::pair_iterator_vtbl =
+        {
+            iter_move,
+            iter_get_pair,
+            iter_compare,
+            iter_compare,
+            iter_count
+        };
+
+        // Each bit of the returned mask corresponds to the control byte of the group
+    #ifdef LLTL_FLAT_INDEX_SSE2
+        static inline uint32_t group_match(const uint8_t *group, uint8_t tag)
+        {
+            const __m128i ctl   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(ctl, _mm_set1_epi8(char(tag))));
+        }
+
+        static inline uint32_t group_match_free(const uint8_t *group)
+        {
+            // Both empty and deleted control bytes have the highest bit set
+            const __m128i ctl   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+            return _mm_movemask_epi8(ctl);
+        }
+    #else
+        static inline uint32_t group_match(const uint8_t *group, uint8_t tag)
+        {
+            uint32_t mask = 0;
+            for (size_t i=0; i<raw_flat_group_size; ++i)
+                mask   |= uint32_t(group[i] == tag) << i;
+            return mask;
+        }
+
+        static inline uint32_t group_match_free(const uint8_t *group)
+        {
+            uint32_t mask = 0;
+            for (size_t i=0; i<raw_flat_group_size; ++i)
+                mask   |= uint32_t(group[i] >> 7) << i;
+            return mask;
+        }
+    #endif /* LLTL_FLAT_INDEX_SSE2 */
+
+        static inline size_t first_bit(uint32_t mask)
+        {
+        #if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(mask);
+        #else
+            size_t index = 0;
+            for ( ; !(mask & 1); mask >>= 1)
+                ++index;
+            return index;
+        #endif
+        }
+
+        static inline bool is_full(uint8_t ctrl)
+        {
+            return !(ctrl & 0x80);
+        }
+
+        size_t raw_flat_index::mix_hash(size_t hash)
+        {
+            // Weak hash functions (like identity) tend to produce clusters, scatter bits
+            // of the value. All operations are reversible, so distinct hash values remain distinct.
+        #ifdef ARCH_64BIT
+            hash       ^= hash >> 32;
+            hash       *= size_t(0x9e3779b97f4a7c15ULL);
+            hash       ^= hash >> 29;
+        #else
+            hash       ^= hash >> 16;
+            hash       *= size_t(0x9e3779b9UL);
+            hash       ^= hash >> 15;
+        #endif /* ARCH_64BIT */
+            return hash;
+        }
+
+        size_t raw_flat_index::hash_of(const void *key) const
+        {
+            return mix_hash((key != NULL) ? hash.compute(key, ksize) : 0);
+        }
+
+        ssize_t raw_flat_index::find_slot(const void *key, size_t hash) const
+        {
+            if (ctrl == NULL)
+                return -1;
+
+            // Lower 7 bits of hash are stored in control byte, the rest bits select the group
+            const uint8_t tag       = hash & 0x7f;
+            const size_t gmask      = cap / raw_flat_group_size - 1;
+            size_t group            = (hash >> 7) & gmask;
+
+            for (size_t step=0; step <= gmask; )
+            {
+                const size_t first      = group * raw_flat_group_size;
+                const uint8_t *gctrl    = &ctrl[first];
+
+                for (uint32_t mask = group_match(gctrl, tag); mask != 0; mask &= mask - 1)
+                {
+                    const size_t index      = first + first_bit(mask);
+                    const slot_t *s         = &slots[index];
+                    if (s->hash != hash)
+                        continue;
+
+                    if (key != NULL)
+                    {
+                        if ((s->v.key != NULL) && (cmp.compare(key, s->v.key, ksize) == 0))
+                            return index;
+                    }
+                    else if (s->v.key == NULL)
+                        return index;
+                }
+
+                // The probe sequence never goes beyond a group having empty slots
+                if (group_match(gctrl, CTRL_EMPTY))
+                    break;
+
+                // Use triangular probing, it visits all groups if number of groups is a power of 2
+                group                   = (group + (++step)) & gmask;
+            }
+
+            return -1;
+        }
+
+        size_t raw_flat_index::find_free(const uint8_t *ctrl, size_t cap, size_t hash)
+        {
+            const size_t gmask      = cap / raw_flat_group_size - 1;
+            size_t group            = (hash >> 7) & gmask;
+
+            for (size_t step=0; ; )
+            {
+                const size_t first      = group * raw_flat_group_size;
+                const uint32_t mask     = group_match_free(&ctrl[first]);
+                if (mask != 0)
+                    return first + first_bit(mask);
+
+                group                   = (group + (++step)) & gmask;
+            }
+        }
+
+        bool raw_flat_index::rehash(size_t ncap)
+        {
+            // Allocate control bytes and slots in one memory chunk, capacity is always
+            // a multiple of group size, so slots remain properly aligned
+            uint8_t *nctrl          = static_cast<uint8_t *>(::malloc(ncap * (sizeof(uint8_t) + sizeof(slot_t))));
+            if (nctrl == NULL)
+                return false;
+            slot_t *nslots          = reinterpret_cast<slot_t *>(&nctrl[ncap]);
+            ::memset(nctrl, CTRL_EMPTY, ncap * sizeof(uint8_t));
+
+            // Move all items, keys are unique so there is no need to compare them
+            for (size_t i=0; i<cap; ++i)
+            {
+                if (!is_full(ctrl[i]))
+                    continue;
+
+                const slot_t *s         = &slots[i];
+                const size_t index      = find_free(nctrl, ncap, s->hash);
+                nctrl[index]            = s->hash & 0x7f;
+                nslots[index]           = *s;
+            }
+
+            // Replace the storage
+            if (ctrl != NULL)
+                ::free(ctrl);
+            ctrl                    = nctrl;
+            slots                   = nslots;
+            cap                     = ncap;
+            tombs                   = 0;
+
+            return true;
+        }
+
+        raw_pair_t *raw_flat_index::create_item(const void *key, size_t hash)
+        {
+            // Keep the load factor below 7/8
+            if ((size + tombs + 1) > ((cap * 7) >> 3))
+            {
+                // Just drop deleted slots if there is enough free space, grow otherwise
+                size_t ncap             = lsp_max(cap, raw_flat_group_size);
+                if ((size + 1) > ((ncap * 7) >> 4))
+                    ncap                  <<= 1;
+                if (!rehash(ncap))
+                    return NULL;
+            }
+
+            const size_t index      = find_free(ctrl, cap, hash);
+            if (ctrl[index] == CTRL_DELETED)
+                --tombs;
+
+            ctrl[index]             = hash & 0x7f;
+            slot_t *s               = &slots[index];
+            s->hash                 = hash;
+            s->v.key                = const_cast<void *>(key);
+            ++size;
+
+            return &s->v;
+        }
+
+        void raw_flat_index::remove_slot(size_t index)
+        {
+            // If the group still has empty slots, no probe sequence passed through it
+            // and the slot can be marked as empty. Otherwise leave the tombstone.
+            const size_t first      = index & ~(raw_flat_group_size - 1);
+            if (group_match(&ctrl[first], CTRL_EMPTY))
+                ctrl[index]             = CTRL_EMPTY;
+            else
+            {
+                ctrl[index]             = CTRL_DELETED;
+                ++tombs;
+            }
+
+            --size;
+        }
+
+        void **raw_flat_index::create(const void *key, void *value)
+        {
+            const size_t h  = hash_of(key);
+            if (find_slot(key, h) >= 0)
+                return NULL;
+
+            // Create new element
+            raw_pair_t *dst = create_item(key, h);
+            if (dst == NULL)
+                return NULL;
+
+            dst->value      = value;
+            return &dst->value;
+        }
+
+        bool raw_flat_index::remove(const void *key, void **ov)
+        {
+            const ssize_t index = find_slot(key, hash_of(key));
+            if (index < 0)
+                return false;
+
+            if (ov != NULL)
+                *ov             = slots[index].v.value;
+            remove_slot(index);
+
+            return true;
+        }
+
+        void **raw_flat_index::replace(const void *key, void *value, void **ov)
+        {
+            const ssize_t index = find_slot(key, hash_of(key));
+            if (index < 0)
+                return NULL;
+
+            // Replace value if it exists
+            raw_pair_t *p   = &slots[index].v;
+            if (ov != NULL)
+                *ov             = p->value;
+
+            p->value        = value;
+            return &p->value;
+        }
+
+        void **raw_flat_index::put(const void *key, void *value, void **ov)
+        {
+            const size_t h  = hash_of(key);
+            const ssize_t index = find_slot(key, h);
+            if (index >= 0)
+            {
+                raw_pair_t *p   = &slots[index].v;
+                if (ov != NULL)
+                    *ov             = p->value;
+
+                p->value        = value;
+                return &p->value;
+            }
+
+            // Create new element
+            raw_pair_t *dst = create_item(key, h);
+            if (dst == NULL)
+                return NULL;
+
+            dst->value      = value;
+            if (ov != NULL)
+                *ov             = NULL;
+
+            return &dst->value;
+        }
+
+        void **raw_flat_index::wbget(const void *key)
+        {
+            const ssize_t index = find_slot(key, hash_of(key));
+            return (index >= 0) ? &slots[index].v.value : NULL;
+        }
+
+        void *raw_flat_index::get(const void *key, void *dfl)
+        {
+            const ssize_t index = find_slot(key, hash_of(key));
+            return (index >= 0) ? slots[index].v.value : dfl;
+        }
+
+        void *raw_flat_index::key(const void *key, void *dfl)
+        {
+            const ssize_t index = find_slot(key, hash_of(key));
+            return (index >= 0) ? slots[index].v.key : dfl;
+        }
+
+        bool raw_flat_index::keys(raw_parray *k) const
+        {
+            raw_parray kt;
+
+            // Initialize collection
+            kt.init();
+            if (!kt.grow(size))
+                return false;
+
+            // Make a snapshot
+            for (size_t i=0; i<cap; ++i)
+            {
+                if (!is_full(ctrl[i]))
+                    continue;
+                if (!kt.append(slots[i].v.key))
+                    return false;
+            }
+
+            // Return collection data
+            kt.swap(k);
+
+            return true;
+        }
+
+        bool raw_flat_index::values(raw_parray *v) const
+        {
+            raw_parray kv;
+
+            // Initialize collection
+            kv.init();
+            if (!kv.grow(size))
+                return false;
+
+            // Make a snapshot
+            for (size_t i=0; i<cap; ++i)
+            {
+                if (!is_full(ctrl[i]))
+                    continue;
+                if (!kv.append(slots[i].v.value))
+                    return false;
+            }
+
+            // Return collection data
+            kv.swap(v);
+
+            return true;
+        }
+
+        bool raw_flat_index::items(raw_parray *k, raw_parray *v) const
+        {
+            raw_parray kt, vt;
+
+            // Initialize collections
+            kt.init();
+            vt.init();
+
+            if (!kt.grow(size))
+                return false;
+            if (!vt.grow(size))
+                return false;
+
+            // Make a snapshot
+            for (size_t i=0; i<cap; ++i)
+            {
+                if (!is_full(ctrl[i]))
+                    continue;
+                if (!kt.append(slots[i].v.key))
+                    return false;
+                if (!vt.append(slots[i].v.value))
+                    return false;
+            }
+
+            // Return collection data
+            kt.swap(k);
+            vt.swap(v);
+
+            return true;
+        }
+
+        static inline size_t slot_capacity(size_t count)
+        {
+            size_t cap          = raw_flat_group_size;
+            while (((cap * 7) >> 3) < count)
+                cap               <<= 1;
+            return cap;
+        }
+
+        bool raw_flat_index::reserve(size_t count)
+        {
+            // Also drop deleted slots to delay the next rehash as much as possible
+            const size_t ncap   = slot_capacity(count);
+            if ((ncap <= cap) && (tombs <= 0))
+                return true;
+
+            return rehash(lsp_max(ncap, cap));
+        }
+
+        bool raw_flat_index::shrink_to_fit()
+        {
+            if (size <= 0)
+            {
+                flush();
+                return true;
+            }
+
+            const size_t ncap   = slot_capacity(size);
+            if ((ncap >= cap) && (tombs <= 0))
+                return true;
+
+            return rehash(lsp_min(ncap, cap));
+        }
+
+        void raw_flat_index::flush()
+        {
+            if (ctrl != NULL)
+            {
+                ::free(ctrl);
+                ctrl    = NULL;
+                slots   = NULL;
+            }
+
+            size    = 0;
+            cap     = 0;
+            tombs   = 0;
+        }
+
+        void raw_flat_index::clear()
+        {
+            if (ctrl != NULL)
+                ::memset(ctrl, CTRL_EMPTY, cap * sizeof(uint8_t));
+
+            size    = 0;
+            tombs   = 0;
+        }
+
+        void raw_flat_index::swap(raw_flat_index *src)
+        {
+            raw_flat_index tmp  = *this;
+            *this               = *src;
+            *src                = tmp;
+        }
+
+        raw_iterator raw_flat_index::iter(const iter_vtbl_t *vtbl)
+        {
+            if (size <= 0)
+                return raw_iterator::INVALID;
+
+            // Find first item and return iterator record
+            for (size_t i=0; i<cap; ++i)
+            {
+                if (is_full(ctrl[i]))
+                    return raw_iterator {
+                        vtbl,
+                        this,
+                        &slots[i],
+                        0,
+                        i,
+                        0,
+                        false
+                    };
+            }
+
+            return raw_iterator::INVALID;
+        }
+
+        raw_iterator raw_flat_index::riter(const iter_vtbl_t *vtbl)
+        {
+            if (size <= 0)
+                return raw_iterator::INVALID;
+
+            // Find last item and return iterator record
+            for (size_t i=cap; (i--) > 0;)
+            {
+                if (is_full(ctrl[i]))
+                    return raw_iterator {
+                        vtbl,
+                        this,
+                        &slots[i],
+                        size - 1,
+                        i,
+                        0,
+                        true
+                    };
+            }
+
+            return raw_iterator::INVALID;
+        }
+
+        void raw_flat_index::iter_move(raw_iterator *i, ssize_t n)
+        {
+            // Ensure that we don't get out of bounds
+            raw_flat_index *self    = static_cast<raw_flat_index *>(i->container);
+            const ssize_t new_idx   = i->index + n;
+            if ((new_idx < 0) || (size_t(new_idx) >= self->size))
+            {
+                *i = raw_iterator::INVALID;
+                return;
+            }
+
+            // item   = pointer to current slot
+            // index  = item position in container
+            // offset = slot index
+            const uint8_t *ctrl     = self->ctrl;
+            size_t offset           = i->offset;
+
+            for ( ; n > 0; --n)
+            {
+                do {
+                    ++offset;
+                } while (!is_full(ctrl[offset]));
+            }
+            for ( ; n < 0; ++n)
+            {
+                do {
+                    --offset;
+                } while (!is_full(ctrl[offset]));
+            }
+
+            i->item                 = &self->slots[offset];
+            i->index                = new_idx;
+            i->offset               = offset;
+        }
+
+        void *raw_flat_index::iter_get_key(raw_iterator *i)
+        {
+            slot_t *s = static_cast<slot_t *>(i->item);
+            return s->v.key;
+        }
+
+        void *raw_flat_index::iter_get_value(raw_iterator *i)
+        {
+            slot_t *s = static_cast<slot_t *>(i->item);
+            return s->v.value;
+        }
+
+        void *raw_flat_index::iter_get_pair(raw_iterator *i)
+        {
+            slot_t *s = static_cast<slot_t *>(i->item);
+            return &s->v;
+        }
+
+        ssize_t raw_flat_index::iter_compare(const raw_iterator *a, const raw_iterator *b)
+        {
+            return a->index - b->index;
+        }
+
+        size_t raw_flat_index::iter_count(const raw_iterator *i)
+        {
+            raw_flat_index *self  = static_cast<raw_flat_index *>(i->container);
+            return self->size;
+        }
+
+    } /* namespace lltl */
+} /* namespace lsp */
+
+
@@ -21,6 +21,8 @@
 
 #include <lsp-plug.in/lltl/hash_index.h>
 
+#include <private/lltl/hash.h>
+
 namespace lsp
 {
     namespace lltl
@@ -52,7 +54,65 @@ namespace lsp
             iter_count
         };
 
-        bool raw_hash_index::add_to_bin(bin_t *bin, node_t **free_list, size_t hash, const raw_pair_t *data)
+        static inline size_t nodes_required(size_t count, size_t cap)
+        {
+            // Each non-empty bin may contain at most one partially filled node
+            return count / raw_hash_node_size + lsp_min(count, cap);
+        }
+
+        raw_hash_index::node_t *raw_hash_index::alloc_node()
+        {
+            node_t *node    = pool;
+            if (node == NULL)
+                return static_cast<node_t *>(::malloc(sizeof(node_t)));
+
+            pool            = node->next;
+            --pooled;
+            return node;
+        }
+
+        void raw_hash_index::free_node(node_t *node)
+        {
+            node->next      = pool;
+            pool            = node;
+            ++pooled;
+        }
+
+        bool raw_hash_index::alloc_nodes(size_t count)
+        {
+            for ( ; count > 0; --count)
+            {
+                node_t *node    = static_cast<node_t *>(::malloc(sizeof(node_t)));
+                if (node == NULL)
+                    return false;
+                free_node(node);
+            }
+
+            return true;
+        }
+
+        void raw_hash_index::destroy_pool()
+        {
+            for (node_t *curr = pool; curr != NULL; )
+            {
+                node_t *next    = curr->next;
+                ::free(curr);
+                curr            = next;
+            }
+
+            pool            = NULL;
+            pooled          = 0;
+        }
+
+        size_t raw_hash_index::used_nodes() const
+        {
+            size_t count    = 0;
+            for (size_t i=0; i<cap; ++i)
+                count          += (bins[i].size + raw_hash_node_size - 1) / raw_hash_node_size;
+            return count;
+        }
+
+        bool raw_hash_index::add_to_bin(bin_t *bin, size_t hash, const raw_pair_t *data)
         {
             // Add item to the bin
             size_t index    = bin->size % raw_hash_node_size;
@@ -61,15 +121,9 @@ namespace lsp
             if ((curr == NULL) || (index == 0))
             {
                 // Create new node
-                node_t *node    = *free_list;
+                node_t *node    = alloc_node();
                 if (node == NULL)
-                {
-                    node        = static_cast<node_t *>(malloc(sizeof(node_t)));
-                    if (node == NULL)
-                        return false;
-                }
-                else
-                    *free_list      = (*free_list)->next;
+                    return false;
 
                 // Initialize node
                 node->next      = NULL;
@@ -92,10 +146,9 @@ namespace lsp
             return true;
         }
 
-        void raw_hash_index::free_nodes(bin_t *bin, node_t **free_list, node_t *node)
+        void raw_hash_index::release_nodes(bin_t *bin, node_t *node)
         {
-            bin->tail->next     = *free_list;
-            *free_list          = node;
+            node_t *tail        = bin->tail;
 
             if (bin->head == node)
             {
@@ -107,6 +160,89 @@ namespace lsp
                 node->prev->next    = NULL;
                 bin->tail           = node->prev;
             }
+
+            // Put nodes to the pool
+            while (node != NULL)
+            {
+                node_t *next        = (node != tail) ? node->next : NULL;
+                free_node(node);
+                node                = next;
+            }
+        }
+
+        bool raw_hash_index::rehash(size_t ncap)
+        {
+            // Ensure that there are enough free nodes to build the new layout
+            const size_t required   = nodes_required(size, ncap);
+            if ((pooled < required) && (!alloc_nodes(required - pooled)))
+                return false;
+
+            bin_t *nbins            = static_cast<bin_t *>(::malloc(ncap * sizeof(bin_t)));
+            if (nbins == NULL)
+                return false;
+
+            for (size_t i=0; i<ncap; ++i)
+            {
+                bin_t *bin              = &nbins[i];
+                bin->size               = 0;
+                bin->head               = NULL;
+                bin->tail               = NULL;
+            }
+
+            // Move items bin by bin, the pool contains enough nodes, so there are no failures
+            for (size_t i=0; i<cap; ++i)
+            {
+                bin_t *bin              = &bins[i];
+                size_t size             = bin->size;
+
+                for (node_t *node = bin->head; node != NULL; node = node->next)
+                {
+                    const size_t count      = lsp_min(size, raw_hash_node_size);
+                    size                   -= count;
+
+                    for (size_t j=0; j<count; ++j)
+                        add_to_bin(&nbins[node->hash[j] & (ncap - 1)], node->hash[j], &node->v[j]);
+                }
+
+                if (bin->head != NULL)
+                    release_nodes(bin, bin->head);
+                bin->size               = 0;
+            }
+
+            if (bins != NULL)
+                ::free(bins);
+            bins                    = nbins;
+            cap                     = ncap;
+
+            return true;
+        }
+
+        bool raw_hash_index::reserve(size_t count)
+        {
+            const size_t ncap       = bin_capacity(count);
+            if ((ncap > cap) && (!rehash(ncap)))
+                return false;
+
+            // Each non-empty bin may contain at most one partially filled node
+            const size_t required   = nodes_required(count, cap);
+            const size_t avail      = used_nodes() + pooled;
+            return (required <= avail) ? true : alloc_nodes(required - avail);
+        }
+
+        bool raw_hash_index::shrink_to_fit()
+        {
+            if (size <= 0)
+            {
+                flush();
+                return true;
+            }
+
+            const size_t ncap       = bin_capacity(size);
+            if ((ncap < cap) && (!rehash(ncap)))
+                return false;
+            destroy_pool();
+
+            return true;
         }
 
         bool raw_hash_index::grow()
@@ -138,17 +274,6 @@ namespace lsp
             if (xbin == NULL)
                 return false; // Very bad things?
 
-            // Now we need to split data
-            node_t *free_list       = NULL; // List of free nodes
-            lsp_finally {
-                while (free_list != NULL)
-                {
-                    node_t *next        = free_list->next;
-                    free(free_list);
-                    free_list           = next;
-                }
-            };
-
             // Now we need to split data
             const size_t mask   = (ncap - 1) ^ (cap - 1); // mask indicates the bit which has been set
             bins                = xbin;
@@ -179,7 +304,7 @@ namespace lsp
                 {
                     if (src->hash[src_index] & mask)
                     {
-                        if (!add_to_bin(ybin, &free_list, src->hash[src_index], &src->v[src_index]))
+                        if (!add_to_bin(ybin, src->hash[src_index], &src->v[src_index]))
                             return false;
                     }
                     else
@@ -212,7 +337,7 @@ namespace lsp
                     dst             = dst->next;
 
                 if (dst != NULL)
-                    free_nodes(xbin, &free_list, dst);
+                    release_nodes(xbin, dst);
 
                 // Decrease the size of bin
                 xbin->size             -= ybin->size;
@@ -228,8 +353,11 @@ namespace lsp
         {
             if (bins == NULL)
                 return lookup_t { NULL, 0 };
-            bin_t *bin = &bins[hash & (cap - 1)];
+            return find_in_bin(&bins[hash & (cap - 1)], key, hash);
+        }
 
+        raw_hash_index::lookup_t raw_hash_index::find_in_bin(const bin_t *bin, const void *key, size_t hash)
+        {
             size_t size = bin->size;
             if (key != NULL)
             {
@@ -262,6 +390,47 @@ namespace lsp
             return lookup_t { NULL, 0 };
         }
 
+        size_t raw_hash_index::lookup_n(size_t n, const void * const *keys, lookup_t *found)
+        {
+            // The batch should not exceed raw_hash_batch_size items
+            if (bins == NULL)
+            {
+                for (size_t i=0; i<n; ++i)
+                    found[i]            = lookup_t { NULL, 0 };
+                return 0;
+            }
+
+            size_t hashes[raw_hash_batch_size];
+            const size_t mask   = cap - 1;
+            size_t count        = 0;
+
+            // Pass 1: compute hashes and prefetch bins
+            for (size_t i=0; i<n; ++i)
+            {
+                const size_t h      = (keys[i] != NULL) ? hash.compute(keys[i], ksize) : 0;
+                hashes[i]           = h;
+                prefetch(&bins[h & mask]);
+            }
+
+            // Pass 2: prefetch hashes of the first node in each bin
+            for (size_t i=0; i<n; ++i)
+            {
+                const node_t *node  = bins[hashes[i] & mask].head;
+                if (node != NULL)
+                    prefetch(node->hash);
+            }
+
+            // Pass 3: resolve keys
+            for (size_t i=0; i<n; ++i)
+            {
+                found[i]            = find_in_bin(&bins[hashes[i] & mask], keys[i], hashes[i]);
+                if (found[i].node != NULL)
+                    ++count;
+            }
+
+            return count;
+        }
+
         raw_pair_t *raw_hash_index::create_item(const void *key, size_t hash)
         {
             // Need to grow?
@@ -280,7 +449,7 @@ namespace lsp
             if ((curr == NULL) || (index == 0))
             {
                 // Create new node
-                node_t *node    = static_cast<node_t *>(malloc(sizeof(node_t)));
+                node_t *node    = alloc_node();
                 if (node == NULL)
                     return NULL;
 
@@ -307,7 +476,7 @@ namespace lsp
 
         void **raw_hash_index::create(const void *key, void *value)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find node
             lookup_t pos    = find_node(key, h);
@@ -327,7 +496,7 @@ namespace lsp
 
         bool raw_hash_index::remove(const void *key, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find node
             lookup_t pos    = find_node(key, h);
@@ -376,6 +545,7 @@ namespace lsp
                     bin->head       = NULL;
                 if (bin->tail != NULL)
                     bin->tail->next = NULL;
+                free_node(node);
             }
 
             --bin->size;
@@ -386,7 +556,7 @@ namespace lsp
 
         void **raw_hash_index::replace(const void *key, void *value, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find node
             lookup_t pos    = find_node(key, h);
@@ -404,7 +574,7 @@ namespace lsp
 
         void **raw_hash_index::put(const void *key, void *value, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find node
             lookup_t pos    = find_node(key, h);
@@ -433,23 +603,58 @@ namespace lsp
 
         void **raw_hash_index::wbget(const void *key)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             lookup_t pos    = find_node(key, h);
             return (pos.node != NULL) ? &pos.node->v[pos.index].value : NULL;
         }
 
         void *raw_hash_index::get(const void *key, void *dfl)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             lookup_t pos    = find_node(key, h);
-            return (pos.node != NULL) ? pos.node->v[pos.index].value : NULL;
+            return (pos.node != NULL) ? pos.node->v[pos.index].value : dfl;
+        }
+
+        size_t raw_hash_index::get_n(size_t n, const void * const *keys, void **values, void *dfl)
+        {
+            lookup_t pos[raw_hash_batch_size];
+            size_t count        = 0;
+
+            for (size_t off=0; off < n; off += raw_hash_batch_size)
+            {
+                const size_t batch      = lsp_min(n - off, raw_hash_batch_size);
+                count                  += lookup_n(batch, &keys[off], pos);
+                for (size_t i=0; i<batch; ++i)
+                    values[off + i]         = (pos[i].node != NULL) ? pos[i].node->v[pos[i].index].value : dfl;
+            }
+
+            return count;
+        }
+
+        size_t raw_hash_index::contains_n(size_t n, const void * const *keys, bool *found)
+        {
+            lookup_t pos[raw_hash_batch_size];
+            size_t count        = 0;
+
+            for (size_t off=0; off < n; off += raw_hash_batch_size)
+            {
+                const size_t batch      = lsp_min(n - off, raw_hash_batch_size);
+                count                  += lookup_n(batch, &keys[off], pos);
+                if (found != NULL)
+                {
+                    for (size_t i=0; i<batch; ++i)
+                        found[off + i]          = pos[i].node != NULL;
+                }
+            }
+
+            return count;
         }
 
         void *raw_hash_index::key(const void *key, void *dfl)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             lookup_t pos    = find_node(key, h);
-            return (pos.node != NULL) ? pos.node->v[pos.index].key: NULL;
+            return (pos.node != NULL) ? pos.node->v[pos.index].key : dfl;
         }
 
         bool raw_hash_index::keys(raw_parray *k) const
@@ -571,6 +776,7 @@ namespace lsp
                 ::free(bins);
                 bins    = NULL;
             }
+            destroy_pool();
 
             size    = 0;
             cap     = 0;
@@ -593,7 +799,7 @@ namespace lsp
             for (node_t *curr = bin->head; curr != NULL; )
             {
                 node_t *next    = curr->next;
-                ::free(curr);
+                free_node(curr);
                 curr            = next;
             }
             bin->size   = 0;
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/hstring.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        LSP_LLTL_LIB_PUBLIC
+        hstring *hstring_init(void *buf, const char *s, size_t length)
+        {
+            hstring *res    = static_cast<hstring *>(buf);
+            res->hash       = fast_hash_func(s, length);
+            res->length     = length;
+            ::memcpy(res->data, s, length);
+            res->data[length]   = '\0';
+
+            return res;
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        hstring *hstring_create(const char *s, size_t length)
+        {
+            void *buf       = ::malloc(hstring_size(length));
+            return (buf != NULL) ? hstring_init(buf, s, length) : NULL;
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        hstring *hstring_create(const char *s)
+        {
+            return hstring_create(s, ::strlen(s));
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        void hstring_free(hstring *s)
+        {
+            if (s != NULL)
+                ::free(s);
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t hstring_hash_func(const void *ptr, size_t size)
+        {
+            return static_cast<const hstring *>(ptr)->hash;
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t hstring_seeded_hash_func(const void *ptr, size_t size, uint64_t seed)
+        {
+            const hstring *s = static_cast<const hstring *>(ptr);
+            return fast_seeded_hash_func(s->data, s->length, seed);
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        ssize_t hstring_cmp_func(const void *a, const void *b, size_t size)
+        {
+            const hstring *sa = static_cast<const hstring *>(a);
+            const hstring *sb = static_cast<const hstring *>(b);
+
+            if (sa->length != sb->length)
+                return (sa->length < sb->length) ? -1 : 1;
+            return ::memcmp(sa->data, sb->data, sa->length);
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        void *hstring_clone_func(const void *ptr, size_t size)
+        {
+            const hstring *s    = static_cast<const hstring *>(ptr);
+            const size_t bytes  = hstring_size(s->length);
+            void *res           = ::malloc(bytes);
+            if (res != NULL)
+                ::memcpy(res, s, bytes);
+            return res;
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/mpmc_queue.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static inline size_t align_value(size_t value, size_t align)
+        {
+            return (value + align - 1) & (~(align - 1));
+        }
+
+        void raw_mpmc_queue::init(size_t n_sizeof)
+        {
+            nEnqueue        = 0;
+            nDequeue        = 0;
+            vData           = NULL;
+            vCells          = NULL;
+            nCapacity       = 0;
+            nStride         = 0;
+            nHeader         = 0;
+            nSizeOf         = n_sizeof;
+        }
+
+        bool raw_mpmc_queue::init(size_t n_sizeof, size_t capacity)
+        {
+            size_t cap          = 2;
+            while (cap < capacity)
+                cap               <<= 1;
+
+            const size_t header = align_value(sizeof(cell_t), DEFAULT_ALIGN);
+            const size_t stride = align_value(header + n_sizeof, DEFAULT_ALIGN);
+            uint8_t *data       = static_cast<uint8_t *>(malloc(cap * stride + DEFAULT_ALIGN));
+            if (data == NULL)
+                return false;
+
+            // Replace previously allocated data
+            flush();
+
+            vData               = data;
+            vCells              = static_cast<uint8_t *>(align_ptr(data, DEFAULT_ALIGN));
+            nCapacity           = cap;
+            nStride             = stride;
+            nHeader             = header;
+            nSizeOf             = n_sizeof;
+
+            // Each cell is initially free for writing at the position equal to its index
+            for (size_t i=0; i<cap; ++i)
+                cell(i)->nSeq       = i;
+
+            return true;
+        }
+
+        void raw_mpmc_queue::flush()
+        {
+            if (vData != NULL)
+                free(vData);
+
+            nEnqueue        = 0;
+            nDequeue        = 0;
+            vData           = NULL;
+            vCells          = NULL;
+            nCapacity       = 0;
+        }
+
+        raw_mpmc_queue::cell_t *raw_mpmc_queue::cell(size_t position) const
+        {
+            return reinterpret_cast<cell_t *>(&vCells[(position & (nCapacity - 1)) * nStride]);
+        }
+
+        bool raw_mpmc_queue::push(const void *data)
+        {
+            if (vCells == NULL)
+                return false;
+
+            cell_t *c;
+            size_t pos          = atomic_load(&nEnqueue);
+
+            while (true)
+            {
+                c                   = cell(pos);
+                const ssize_t diff  = ssize_t(atomic_load(&c->nSeq) - pos);
+                if (diff == 0)
+                {
+                    // The cell is free, try to reserve it
+                    if (atomic_cas(&nEnqueue, pos, pos + 1))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;   // The queue is full
+
+                pos                 = atomic_load(&nEnqueue);
+            }
+
+            memcpy(reinterpret_cast<uint8_t *>(c) + nHeader, data, nSizeOf);
+            atomic_store(&c->nSeq, pos + 1);
+
+            return true;
+        }
+
+        size_t raw_mpmc_queue::push(const void *data, size_t count)
+        {
+            if ((vCells == NULL) || (count <= 0))
+                return 0;
+
+            size_t n;
+            size_t pos          = atomic_load(&nEnqueue);
+
+            while (true)
+            {
+                // Count number of consecutive free cells
+                for (n = 0; n < count; ++n)
+                {
+                    if (atomic_load(&cell(pos + n)->nSeq) != (pos + n))
+                        break;
+                }
+
+                if (n > 0)
+                {
+                    // Try to reserve all free cells at once
+                    if (atomic_cas(&nEnqueue, pos, pos + n))
+                        break;
+                }
+                else if (ssize_t(atomic_load(&cell(pos)->nSeq) - pos) < 0)
+                    return 0;       // The queue is full
+
+                pos                 = atomic_load(&nEnqueue);
+            }
+
+            // Store data and publish cells
+            const uint8_t *src  = static_cast<const uint8_t *>(data);
+            for (size_t i=0; i<n; ++i, src += nSizeOf)
+            {
+                cell_t *c           = cell(pos + i);
+                memcpy(reinterpret_cast<uint8_t *>(c) + nHeader, src, nSizeOf);
+                atomic_store(&c->nSeq, pos + i + 1);
+            }
+
+            return n;
+        }
+
+        bool raw_mpmc_queue::pop(void *data)
+        {
+            if (vCells == NULL)
+                return false;
+
+            cell_t *c;
+            size_t pos          = atomic_load(&nDequeue);
+
+            while (true)
+            {
+                c                   = cell(pos);
+                const ssize_t diff  = ssize_t(atomic_load(&c->nSeq) - (pos + 1));
+                if (diff == 0)
+                {
+                    // The cell contains data, try to reserve it
+                    if (atomic_cas(&nDequeue, pos, pos + 1))
+                        break;
+                }
+                else if (diff < 0)
+                    return false;   // The queue is empty
+
+                pos                 = atomic_load(&nDequeue);
+            }
+
+            memcpy(data, reinterpret_cast<uint8_t *>(c) + nHeader, nSizeOf);
+            atomic_store(&c->nSeq, pos + nCapacity);
+
+            return true;
+        }
+
+        size_t raw_mpmc_queue::pop(void *data, size_t count)
+        {
+            if ((vCells == NULL) || (count <= 0))
+                return 0;
+
+            size_t n;
+            size_t pos          = atomic_load(&nDequeue);
+
+            while (true)
+            {
+                // Count number of consecutive cells containing data
+                for (n = 0; n < count; ++n)
+                {
+                    if (atomic_load(&cell(pos + n)->nSeq) != (pos + n + 1))
+                        break;
+                }
+
+                if (n > 0)
+                {
+                    // Try to reserve all cells at once
+                    if (atomic_cas(&nDequeue, pos, pos + n))
+                        break;
+                }
+                else if (ssize_t(atomic_load(&cell(pos)->nSeq) - (pos + 1)) < 0)
+                    return 0;       // The queue is empty
+
+                pos                 = atomic_load(&nDequeue);
+            }
+
+            // Read data and release cells
+            uint8_t *dst        = static_cast<uint8_t *>(data);
+            for (size_t i=0; i<n; ++i, dst += nSizeOf)
+            {
+                cell_t *c           = cell(pos + i);
+                memcpy(dst, reinterpret_cast<uint8_t *>(c) + nHeader, nSizeOf);
+                atomic_store(&c->nSeq, pos + i + nCapacity);
+            }
+
+            return n;
+        }
+
+        size_t raw_mpmc_queue::size() const
+        {
+            const size_t dequeued   = atomic_load(&nDequeue);
+            const size_t enqueued   = atomic_load(&nEnqueue);
+            const ssize_t size      = ssize_t(enqueued - dequeued);
+            return (size > 0) ? lsp_min(size_t(size), nCapacity) : 0;
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/mvstate.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        void raw_mvstate::init()
+        {
+            init_readers();
+            deleter2    = NULL;
+            deleter1    = NULL;
+        }
+
+        void raw_mvstate::init(deleter1_t deleter)
+        {
+            init_readers();
+            set_deleter(deleter);
+        }
+
+        void raw_mvstate::init(deleter2_t deleter, void *arg)
+        {
+            init_readers();
+            set_deleter(deleter, arg);
+        }
+
+        void raw_mvstate::set_deleter(deleter1_t deleter)
+        {
+            deleter2    = NULL;
+            deleter1    = deleter;
+        }
+
+        void raw_mvstate::set_deleter(deleter2_t deleter, void *arg)
+        {
+            deleter2    = deleter;
+            params      = arg;
+        }
+
+        void raw_mvstate::init_readers()
+        {
+            current     = NULL;
+            retired     = NULL;
+            spare       = NULL;
+            atomic_init(gc_lock);
+
+            for (size_t i=0; i<raw_mvstate_readers; ++i)
+            {
+                readers[i].hazard   = NULL;
+                readers[i].busy     = 0;
+            }
+        }
+
+        void raw_mvstate::cleanup(void *garbage)
+        {
+            if (garbage == NULL)
+                return;
+
+            if (deleter2 != NULL)
+                deleter2(garbage, params);
+            else if (deleter1 != NULL)
+                deleter1(garbage);
+        }
+
+        bool raw_mvstate::is_protected(const void *ptr)
+        {
+            for (size_t i=0; i<raw_mvstate_readers; ++i)
+            {
+                if (atomic_load(&readers[i].hazard) == ptr)
+                    return true;
+            }
+            return false;
+        }
+
+        raw_mvstate::retired_t *raw_mvstate::alloc_retired()
+        {
+            retired_t *item = atomic_swap(&spare, static_cast<retired_t *>(NULL));
+            if (item == NULL)
+                item            = static_cast<retired_t *>(malloc(sizeof(retired_t)));
+            return item;
+        }
+
+        void raw_mvstate::free_retired(retired_t *item)
+        {
+            if (!atomic_cas(&spare, static_cast<retired_t *>(NULL), item))
+                free(item);
+        }
+
+        void raw_mvstate::retire(retired_t *list)
+        {
+            retired_t *tail = list;
+            while (tail->next != NULL)
+                tail            = tail->next;
+
+            retired_t *head;
+            do
+            {
+                head            = atomic_load(&retired);
+                tail->next      = head;
+            } while (!atomic_cas(&retired, head, list));
+        }
+
+        void raw_mvstate::clear()
+        {
+            cleanup(atomic_swap(&current, static_cast<void *>(NULL)));
+
+            retired_t *list = atomic_swap(&retired, static_cast<retired_t *>(NULL));
+            while (list != NULL)
+            {
+                retired_t *next = list->next;
+                cleanup(list->ptr);
+                free(list);
+                list            = next;
+            }
+
+            retired_t *item = atomic_swap(&spare, static_cast<retired_t *>(NULL));
+            if (item != NULL)
+                free(item);
+        }
+
+        void raw_mvstate::destroy()
+        {
+            clear();
+
+            deleter2    = NULL;
+            deleter1    = NULL;
+        }
+
+        void raw_mvstate::gc()
+        {
+            if (!atomic_trylock(gc_lock))
+                return;
+            lsp_finally { atomic_unlock(gc_lock); };
+
+            // Destroy all states which are not held by readers
+            retired_t *list = atomic_swap(&retired, static_cast<retired_t *>(NULL));
+            retired_t *keep = NULL;
+            while (list != NULL)
+            {
+                retired_t *next = list->next;
+                if (is_protected(list->ptr))
+                {
+                    list->next      = keep;
+                    keep            = list;
+                }
+                else
+                {
+                    cleanup(list->ptr);
+                    free_retired(list);
+                }
+                list            = next;
+            }
+
+            // Return states still held by readers back
+            if (keep != NULL)
+                retire(keep);
+        }
+
+        bool raw_mvstate::publish(void *new_state)
+        {
+            // Allocate item before the state is replaced to never lose the previous state
+            retired_t *item = alloc_retired();
+            if (item == NULL)
+                return false;
+
+            void *old       = atomic_swap(&current, new_state);
+            if ((old == NULL) || (!is_protected(old)))
+            {
+                free_retired(item);
+                cleanup(old);
+            }
+            else
+            {
+                item->next      = NULL;
+                item->ptr       = old;
+                retire(item);
+            }
+
+            // Destroy states released by readers
+            gc();
+
+            return true;
+        }
+
+        void *raw_mvstate::get() const
+        {
+            return atomic_load(&current);
+        }
+
+        raw_mvstate::reader_t *raw_mvstate::attach()
+        {
+            for (size_t i=0; i<raw_mvstate_readers; ++i)
+            {
+                reader_t *r     = &readers[i];
+                if ((atomic_load(&r->busy) == 0) && (atomic_cas(&r->busy, 0, 1)))
+                    return r;
+            }
+
+            return NULL;
+        }
+
+        void raw_mvstate::detach(reader_t *reader)
+        {
+            if (reader == NULL)
+                return;
+
+            atomic_store(&reader->hazard, static_cast<void *>(NULL));
+            atomic_store(&reader->busy, 0);
+        }
+
+        void *raw_mvstate::acquire(reader_t *reader)
+        {
+            // Announce the state being read and ensure that it has not been replaced meanwhile
+            void *ptr       = atomic_load(&current);
+            while (true)
+            {
+                atomic_store(&reader->hazard, ptr);
+                void *curr      = atomic_load(&current);
+                if (curr == ptr)
+                    return ptr;
+                ptr             = curr;
+            }
+        }
+
+        void raw_mvstate::release(reader_t *reader)
+        {
+            atomic_store(&reader->hazard, static_cast<void *>(NULL));
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -514,6 +514,79 @@ namespace lsp
             lsp::ssort_r(vItems, nItems, sizeof(void *), raw_cmp, xf.p);
         }
 
+        void raw_parray::pqsort(sort_closure_t *c, executor_iface *executor)
+        {
+            parallel_sort(vItems, nItems, sizeof(void *), closure_cmp, c, false, executor);
+        }
+
+        void raw_parray::pqsort(cmp_func_t f, executor_iface *executor)
+        {
+            union
+            {
+                cmp_func_t f;
+                void *p;
+            } xf;
+            xf.f = f;
+            parallel_sort(vItems, nItems, sizeof(void *), raw_cmp, xf.p, false, executor);
+        }
+
+        void raw_parray::pssort(sort_closure_t *c, executor_iface *executor)
+        {
+            parallel_sort(vItems, nItems, sizeof(void *), closure_cmp, c, true, executor);
+        }
+
+        void raw_parray::pssort(cmp_func_t f, executor_iface *executor)
+        {
+            union
+            {
+                cmp_func_t f;
+                void *p;
+            } xf;
+            xf.f = f;
+            parallel_sort(vItems, nItems, sizeof(void *), raw_cmp, xf.p, true, executor);
+        }
+
+        bool raw_parray::rsort(size_t offset, const radix_iface *key)
+        {
+            if ((key->size != 1) && (key->size != 2) && (key->size != 4) && (key->size != 8))
+                return false;
+            if ((key->type == RADIX_FLOAT) && (key->size != 4) && (key->size != 8))
+                return false;
+            if (nItems <= 1)
+                return true;
+
+            radix_item_t *items = static_cast<radix_item_t *>(::malloc(nItems * sizeof(radix_item_t) * 2));
+            if (items == NULL)
+                return false;
+            lsp_finally { ::free(items); };
+            radix_item_t *tmp   = &items[nItems];
+
+            // Extract keys, NULL pointers are placed to the beginning of the array
+            size_t count        = 0, nulls = 0;
+            for (size_t i=0; i<nItems; ++i)
+            {
+                uint8_t *ptr        = static_cast<uint8_t *>(vItems[i]);
+                if (ptr == NULL)
+                {
+                    ++nulls;
+                    continue;
+                }
+
+                radix_item_t *item  = &items[count++];
+                item->key           = radix_key(&ptr[offset], key->size, key->type);
+                item->value         = reinterpret_cast<uintptr_t>(ptr);
+            }
+
+            // Sort and store the result
+            items               = radix_sort(items, tmp, count, key->size);
+            for (size_t i=0; i<nulls; ++i)
+                vItems[i]           = NULL;
+            for (size_t i=0; i<count; ++i)
+                vItems[nulls + i]   = reinterpret_cast<void *>(items[i].value);
+
+            return true;
+        }
+
         raw_iterator raw_parray::iter()
         {
             if (nItems <= 0)
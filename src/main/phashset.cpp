@@ -21,6 +21,8 @@
 
 #include <lsp-plug.in/lltl/phashset.h>
 
+#include <private/lltl/hash.h>
+
 namespace lsp
 {
     namespace lltl
@@ -34,12 +36,138 @@ namespace lsp
             iter_count
         };
 
+        bool raw_phashset::alloc_slab(size_t count)
+        {
+            slab_t *slab    = static_cast<slab_t *>(::malloc(sizeof(slab_t) + count * sizeof(tuple_t)));
+            if (slab == NULL)
+                return false;
+
+            // Link slab and put all it's tuples to the pool
+            slab->next      = slabs;
+            slab->count     = count;
+            slabs           = slab;
+
+            for (size_t i=count; i > 0; )
+            {
+                tuple_t *t      = &slab->data[--i];
+                t->next         = pool;
+                pool            = t;
+            }
+            pooled         += count;
+
+            return true;
+        }
+
+        raw_phashset::tuple_t *raw_phashset::alloc_tuple()
+        {
+            // Allocate new slab if the pool is empty, slabs grow with the hash
+            if (pool == NULL)
+            {
+                if (!alloc_slab(lsp_max(size >> 1, size_t(0x10))))
+                    return NULL;
+            }
+
+            tuple_t *t      = pool;
+            pool            = t->next;
+            --pooled;
+
+            return t;
+        }
+
+        void raw_phashset::free_tuple(tuple_t *tuple)
+        {
+            tuple->next     = pool;
+            pool            = tuple;
+            ++pooled;
+        }
+
+        void raw_phashset::destroy_slabs()
+        {
+            for (slab_t *curr = slabs; curr != NULL; )
+            {
+                slab_t *next    = curr->next;
+                ::free(curr);
+                curr            = next;
+            }
+
+            slabs           = NULL;
+            pool            = NULL;
+            pooled          = 0;
+        }
+
+        void raw_phashset::trim_slabs()
+        {
+            pooled         -= trim_slab_pool(&slabs, &pool);
+        }
+
+        bool raw_phashset::rehash(size_t ncap)
+        {
+            bin_t *nbins        = static_cast<bin_t *>(::malloc(ncap * sizeof(bin_t)));
+            if (nbins == NULL)
+                return false;
+
+            for (size_t i=0; i<ncap; ++i)
+            {
+                nbins[i].size       = 0;
+                nbins[i].data       = NULL;
+            }
+
+            // Move all tuples to the new array of bins
+            for (size_t i=0; i<cap; ++i)
+            {
+                for (tuple_t *curr = bins[i].data; curr != NULL; )
+                {
+                    tuple_t *next       = curr->next;
+                    bin_t *dst          = &nbins[curr->hash & (ncap - 1)];
+                    curr->next          = dst->data;
+                    dst->data           = curr;
+                    ++dst->size;
+                    curr                = next;
+                }
+            }
+
+            if (bins != NULL)
+                ::free(bins);
+            bins                = nbins;
+            cap                 = ncap;
+
+            return true;
+        }
+
+        bool raw_phashset::reserve(size_t count)
+        {
+            // Each bin holds 4 tuples in average before the hash grows
+            const size_t ncap   = bin_capacity(count);
+            if ((ncap > cap) && (!rehash(ncap)))
+                return false;
+
+            const size_t avail  = size + pooled;
+            return (count <= avail) ? true : alloc_slab(count - avail);
+        }
+
+        bool raw_phashset::shrink_to_fit()
+        {
+            if (size <= 0)
+            {
+                flush();
+                return true;
+            }
+
+            // Reduce the number of bins and release unused slabs
+            const size_t ncap   = bin_capacity(size);
+            if ((ncap < cap) && (!rehash(ncap)))
+                return false;
+            trim_slabs();
+
+            return true;
+        }
+
         void raw_phashset::destroy_bin(bin_t *bin)
         {
             for (tuple_t *curr = bin->data; curr != NULL; )
             {
                 tuple_t *next   = curr->next;
-                ::free(curr);
+                free_tuple(curr);
                 curr            = next;
             }
             bin->size   = 0;
@@ -115,7 +243,7 @@ namespace lsp
         raw_phashset::tuple_t *raw_phashset::create_tuple(size_t hash)
         {
             // Allocate tuple
-            tuple_t *tuple  = static_cast<tuple_t *>(::malloc(sizeof(tuple_t)));
+            tuple_t *tuple  = alloc_tuple();
             if (tuple == NULL)
                 return NULL;
 
@@ -124,7 +252,7 @@ namespace lsp
             {
                 if (!grow())
                 {
-                    ::free(tuple);
+                    free_tuple(tuple);
                     return NULL;
                 }
             }
@@ -214,6 +342,7 @@ namespace lsp
                 ::free(bins);
                 bins    = NULL;
             }
+            destroy_slabs();
 
             size    = 0;
             cap     = 0;
@@ -240,21 +369,21 @@ namespace lsp
 
         void *raw_phashset::get(const void *value, void *dfl)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
             tuple_t *tuple  = find_tuple(value, h);
             return (tuple != NULL) ? tuple->value : dfl;
         }
 
         void **raw_phashset::wbget(const void *value)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
             tuple_t *tuple  = find_tuple(value, h);
             return (tuple != NULL) ? &tuple->value : NULL;
         }
 
         void **raw_phashset::put(void *value, void **ret)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
 
             // Find tuple
             tuple_t *tuple  = find_tuple(value, h);
@@ -295,14 +424,14 @@ namespace lsp
 
         bool raw_phashset::toggle(void *value)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
 
             // Try to remove tuple
             tuple_t *tuple  = remove_tuple(value, h);
             if (tuple != NULL)
             {
                 // Free tuple data
-                ::free(tuple);
+                free_tuple(tuple);
             }
             else
             {
@@ -319,7 +448,7 @@ namespace lsp
 
         void **raw_phashset::create(void *value)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
 
             // Find tuple
             tuple_t *tuple  = find_tuple(value, h);
@@ -338,7 +467,7 @@ namespace lsp
 
         bool raw_phashset::remove(const void *value, void **ov)
         {
-            size_t h        = (value != NULL) ? hash.hash(value, vsize) : 0;
+            size_t h        = (value != NULL) ? hash.compute(value, vsize) : 0;
 
             // Find tuple
             tuple_t *tuple  = remove_tuple(value, h);
@@ -349,7 +478,7 @@ namespace lsp
                 *ov         = tuple->value;
 
             // Free tuple data
-            ::free(tuple);
+            free_tuple(tuple);
             return true;
         }
 
@@ -22,6 +22,8 @@
 #include <lsp-plug.in/lltl/pphash.h>
 #include <lsp-plug.in/stdlib/stdlib.h>
 
+#include <private/lltl/hash.h>
+
 namespace lsp
 {
     namespace lltl
@@ -53,6 +55,139 @@ namespace lsp
             iter_count
         };
 
+        bool raw_pphash::alloc_slab(size_t count)
+        {
+            slab_t *slab    = static_cast<slab_t *>(::malloc(sizeof(slab_t) + count * sizeof(tuple_t)));
+            if (slab == NULL)
+                return false;
+
+            // Link slab and put all it's tuples to the pool
+            slab->next      = slabs;
+            slab->count     = count;
+            slabs           = slab;
+
+            for (size_t i=count; i > 0; )
+            {
+                tuple_t *t      = &slab->data[--i];
+                t->next         = pool;
+                pool            = t;
+            }
+            pooled         += count;
+
+            return true;
+        }
+
+        raw_pphash::tuple_t *raw_pphash::alloc_tuple()
+        {
+            // Allocate new slab if the pool is empty, slabs grow with the hash
+            if (pool == NULL)
+            {
+                if (!alloc_slab(lsp_max(size >> 1, size_t(0x10))))
+                    return NULL;
+            }
+
+            tuple_t *t      = pool;
+            pool            = t->next;
+            --pooled;
+
+            return t;
+        }
+
+        void raw_pphash::free_tuple(tuple_t *tuple)
+        {
+            tuple->next     = pool;
+            pool            = tuple;
+            ++pooled;
+        }
+
+        void raw_pphash::destroy_slabs()
+        {
+            for (slab_t *curr = slabs; curr != NULL; )
+            {
+                slab_t *next    = curr->next;
+                ::free(curr);
+                curr            = next;
+            }
+
+            slabs           = NULL;
+            pool            = NULL;
+            pooled          = 0;
+        }
+
+        void raw_pphash::trim_slabs()
+        {
+            pooled         -= trim_slab_pool(&slabs, &pool);
+        }
+
+        bool raw_pphash::rehash(size_t ncap)
+        {
+            bin_t *nbins        = static_cast<bin_t *>(::malloc(ncap * sizeof(bin_t)));
+            if (nbins == NULL)
+                return false;
+
+            for (size_t i=0; i<ncap; ++i)
+            {
+                nbins[i].size       = 0;
+                nbins[i].data       = NULL;
+            }
+
+            // Move all tuples to the new array of bins
+            for (size_t i=0; i<cap; ++i)
+            {
+                for (tuple_t *curr = bins[i].data; curr != NULL; )
+                {
+                    tuple_t *next       = curr->next;
+                    bin_t *dst          = &nbins[curr->hash & (ncap - 1)];
+                    curr->next          = dst->data;
+                    dst->data           = curr;
+                    ++dst->size;
+                    curr                = next;
+                }
+            }
+
+            if (bins != NULL)
+                ::free(bins);
+            bins                = nbins;
+            cap                 = ncap;
+
+            return true;
+        }
+
+        bool raw_pphash::reserve(size_t count)
+        {
+            // Complete the pending rehash to avoid further allocations
+            if (obins != NULL)
+                finish_rehash();
+
+            // Each bin holds 4 tuples in average before the hash grows
+            const size_t ncap   = bin_capacity(count);
+            if ((ncap > cap) && (!rehash(ncap)))
+                return false;
+
+            const size_t avail  = size + pooled;
+            return (count <= avail) ? true : alloc_slab(count - avail);
+        }
+
+        bool raw_pphash::shrink_to_fit()
+        {
+            if (size <= 0)
+            {
+                flush();
+                return true;
+            }
+
+            if (obins != NULL)
+                finish_rehash();
+
+            // Reduce the number of bins and release unused slabs
+            const size_t ncap   = bin_capacity(size);
+            if ((ncap < cap) && (!rehash(ncap)))
+                return false;
+            trim_slabs();
+
+            return true;
+        }
+
         void raw_pphash::destroy_bin(bin_t *bin)
         {
             for (tuple_t *curr = bin->data; curr != NULL; )
@@ -60,22 +195,59 @@ namespace lsp
                 tuple_t *next   = curr->next;
                 if (curr->v.key != NULL)
                     alloc.free(curr->v.key);
-                ::free(curr);
+                free_tuple(curr);
                 curr            = next;
             }
             bin->size   = 0;
             bin->data   = NULL;
         }
 
+        raw_pphash::bin_t *raw_pphash::bin_of(size_t hash)
+        {
+            if (obins != NULL)
+            {
+                const size_t index  = hash & (ocap - 1);
+                if (index >= moved)
+                    return &obins[index];
+            }
+
+            return &bins[hash & (cap - 1)];
+        }
+
+        size_t raw_pphash::bin_count() const
+        {
+            return cap + ocap;
+        }
+
+        const raw_pphash::bin_t *raw_pphash::bin_at(size_t index) const
+        {
+            if (obins == NULL)
+                return &bins[index];
+
+            // Bins in range [0, ocap) refer to the old array, the rest refer to the new array,
+            // return NULL for bins that have been migrated or not initialized yet
+            if (index < ocap)
+                return (index >= moved) ? &obins[index] : NULL;
+
+            index          -= ocap;
+            return ((index & (ocap - 1)) < moved) ? &bins[index] : NULL;
+        }
+
         raw_pphash::tuple_t *raw_pphash::find_tuple(const void *key, size_t hash)
         {
             if (bins == NULL)
                 return NULL;
-            bin_t *bin = &bins[hash & (cap - 1)];
 
+            // Lookups do not advance the pending incremental rehash, so concurrent
+            // const lookups do not modify the hash
+            return find_in_list(bin_of(hash)->data, key, hash);
+        }
+
+        raw_pphash::tuple_t *raw_pphash::find_in_list(tuple_t *curr, const void *key, size_t hash)
+        {
             if (key != NULL)
             {
-                for (tuple_t *curr = bin->data; curr != NULL; curr = curr->next)
+                for ( ; curr != NULL; curr = curr->next)
                 {
                     if ((curr->hash == hash) && (cmp.compare(key, curr->v.key, ksize) == 0))
                         return curr;
@@ -83,7 +255,7 @@ namespace lsp
             }
             else
             {
-                for (tuple_t *curr = bin->data; curr != NULL; curr = curr->next)
+                for ( ; curr != NULL; curr = curr->next)
                 {
                     if (curr->v.key == NULL)
                         return curr;
@@ -92,11 +264,60 @@ namespace lsp
             return NULL;
         }
 
+        size_t raw_pphash::lookup_n(size_t n, const void * const *keys, tuple_t **found)
+        {
+            // The batch should not exceed raw_hash_batch_size items
+            if (bins == NULL)
+            {
+                for (size_t i=0; i<n; ++i)
+                    found[i]        = NULL;
+                return 0;
+            }
+
+            size_t hashes[raw_hash_batch_size];
+            bin_t *vbins[raw_hash_batch_size];
+            size_t count        = 0;
+
+            // Pass 1: compute hashes and prefetch bins
+            for (size_t i=0; i<n; ++i)
+            {
+                const size_t h      = (keys[i] != NULL) ? hash.compute(keys[i], ksize) : 0;
+                hashes[i]           = h;
+                vbins[i]            = bin_of(h);
+                prefetch(vbins[i]);
+            }
+
+            // Pass 2: fetch list heads and prefetch first tuples
+            for (size_t i=0; i<n; ++i)
+            {
+                tuple_t *t          = vbins[i]->data;
+                found[i]            = t;
+                if (t != NULL)
+                    prefetch(t);
+            }
+
+            // Pass 3: resolve keys
+            for (size_t i=0; i<n; ++i)
+            {
+                tuple_t *t          = (found[i] != NULL) ? find_in_list(found[i], keys[i], hashes[i]) : NULL;
+                found[i]            = t;
+                if (t != NULL)
+                    ++count;
+            }
+
+            return count;
+        }
+
         raw_pphash::tuple_t *raw_pphash::remove_tuple(const void *key, size_t hash)
         {
             if (bins == NULL)
                 return NULL;
-            bin_t *bin = &bins[hash & (cap - 1)];
+
+            // Each removal advances the pending incremental rehash
+            if (obins != NULL)
+                migrate(step);
+
+            bin_t *bin = bin_of(hash);
 
             if (key != NULL)
             {
@@ -135,8 +356,12 @@ namespace lsp
 
         raw_pphash::tuple_t *raw_pphash::create_tuple(const void *key, size_t hash)
         {
+            // Each insertion advances the pending incremental rehash
+            if (obins != NULL)
+                migrate(step);
+
             // Allocate tuple
-            tuple_t *tuple  = reinterpret_cast<tuple_t *>(::malloc(sizeof(tuple_t)));
+            tuple_t *tuple  = alloc_tuple();
             if (tuple == NULL)
                 return NULL;
 
@@ -146,7 +371,7 @@ namespace lsp
             {
                 if ((kcopy = alloc.clone(key, ksize)) == NULL)
                 {
-                    ::free(tuple);
+                    free_tuple(tuple);
                     return NULL;
                 }
             }
@@ -156,7 +381,7 @@ namespace lsp
             {
                 if (!grow())
                 {
-                    ::free(tuple);
+                    free_tuple(tuple);
                     if (kcopy != NULL)
                         alloc.free(kcopy);
                     return NULL;
@@ -164,7 +389,7 @@ namespace lsp
             }
 
             // Initialize tuple
-            bin_t *bin      = &bins[hash & (cap - 1)];
+            bin_t *bin      = bin_of(hash);
             ++bin->size;
             ++size;
 
@@ -199,8 +424,28 @@ namespace lsp
                 return true;
             }
 
+            // Complete previous incremental rehash if it is still pending
+            if (obins != NULL)
+                finish_rehash();
+
             // Twice increase the capacity of hash
             ncap            = cap << 1;
+            if (step > 0)
+            {
+                // Allocate new array of bins, each bin will be initialized on migration
+                xbin            = reinterpret_cast<bin_t *>(::malloc(ncap * sizeof(bin_t)));
+                if (xbin == NULL)
+                    return false;
+
+                obins           = bins;
+                ocap            = cap;
+                moved           = 0;
+                bins            = xbin;
+                cap             = ncap;
+
+                return true;
+            }
+
             xbin            = reinterpret_cast<bin_t *>(::realloc(bins, ncap * sizeof(bin_t)));
             if (xbin == NULL)
                 return false; // Very bad things?
@@ -239,19 +484,79 @@ namespace lsp
             return true;
         }
 
+        void raw_pphash::migrate(size_t count)
+        {
+            // Each bin of the old array is split into two bins of the new array
+            for ( ; (count > 0) && (moved < ocap); --count, ++moved)
+            {
+                bin_t *src      = &obins[moved];
+                bin_t *xbin     = &bins[moved];
+                bin_t *ybin     = &bins[moved + ocap];
+
+                xbin->size      = 0;
+                xbin->data      = NULL;
+                ybin->size      = 0;
+                ybin->data      = NULL;
+
+                for (tuple_t *curr = src->data; curr != NULL; )
+                {
+                    tuple_t *next   = curr->next;
+                    bin_t *dst      = (curr->hash & ocap) ? ybin : xbin;
+                    curr->next      = dst->data;
+                    dst->data       = curr;
+                    ++dst->size;
+                    curr            = next;
+                }
+            }
+
+            // Drop the old array if all bins have been migrated
+            if (moved >= ocap)
+            {
+                ::free(obins);
+                obins           = NULL;
+                ocap            = 0;
+                moved           = 0;
+            }
+        }
+
+        void raw_pphash::finish_rehash()
+        {
+            if (obins != NULL)
+                migrate(ocap - moved);
+        }
+
+        void raw_pphash::set_rehash_step(size_t step)
+        {
+            this->step      = step;
+            if (step == 0)
+                finish_rehash();
+        }
+
         void raw_pphash::flush()
         {
             // Drop all bins
             if (bins != NULL)
             {
-                for (size_t i=0; i<cap; ++i)
-                    destroy_bin(&bins[i]);
+                for (size_t i=0, n=bin_count(); i<n; ++i)
+                {
+                    const bin_t *bin = bin_at(i);
+                    if (bin != NULL)
+                        destroy_bin(const_cast<bin_t *>(bin));
+                }
                 ::free(bins);
                 bins    = NULL;
             }
+            if (obins != NULL)
+            {
+                ::free(obins);
+                obins   = NULL;
+            }
+            destroy_slabs();
 
             size    = 0;
             cap     = 0;
+            ocap    = 0;
+            moved   = 0;
         }
 
         void raw_pphash::clear()
@@ -259,8 +564,27 @@ namespace lsp
             // Just reset the size value for each bin
             if (bins != NULL)
             {
+                for (size_t i=0, n=bin_count(); i<n; ++i)
+                {
+                    const bin_t *bin = bin_at(i);
+                    if (bin != NULL)
+                        destroy_bin(const_cast<bin_t *>(bin));
+                }
+            }
+
+            // Drop the pending rehash
+            if (obins != NULL)
+            {
+                ::free(obins);
+                obins   = NULL;
+                ocap    = 0;
+                moved   = 0;
+
                 for (size_t i=0; i<cap; ++i)
-                    destroy_bin(&bins[i]);
+                {
+                    bins[i].size    = 0;
+                    bins[i].data    = NULL;
+                }
             }
 
             size    = 0;
@@ -275,28 +599,63 @@ namespace lsp
 
         void *raw_pphash::get(const void *key, void *dfl)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             tuple_t *tuple  = find_tuple(key, h);
             return (tuple != NULL) ? tuple->v.value : dfl;
         }
 
         void *raw_pphash::key(const void *key, void *dfl)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             tuple_t *tuple  = find_tuple(key, h);
             return (tuple != NULL) ? tuple->v.key : dfl;
         }
 
         void **raw_pphash::wbget(const void *key)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
             tuple_t *tuple  = find_tuple(key, h);
             return (tuple != NULL) ? &tuple->v.value : NULL;
         }
 
+        size_t raw_pphash::get_n(size_t n, const void * const *keys, void **values, void *dfl)
+        {
+            tuple_t *tuples[raw_hash_batch_size];
+            size_t count        = 0;
+
+            for (size_t off=0; off < n; off += raw_hash_batch_size)
+            {
+                const size_t batch      = lsp_min(n - off, raw_hash_batch_size);
+                count                  += lookup_n(batch, &keys[off], tuples);
+                for (size_t i=0; i<batch; ++i)
+                    values[off + i]         = (tuples[i] != NULL) ? tuples[i]->v.value : dfl;
+            }
+
+            return count;
+        }
+
+        size_t raw_pphash::contains_n(size_t n, const void * const *keys, bool *found)
+        {
+            tuple_t *tuples[raw_hash_batch_size];
+            size_t count        = 0;
+
+            for (size_t off=0; off < n; off += raw_hash_batch_size)
+            {
+                const size_t batch      = lsp_min(n - off, raw_hash_batch_size);
+                count                  += lookup_n(batch, &keys[off], tuples);
+                if (found != NULL)
+                {
+                    for (size_t i=0; i<batch; ++i)
+                        found[off + i]          = tuples[i] != NULL;
+                }
+            }
+
+            return count;
+        }
+
         void **raw_pphash::put(const void *key, void *value, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find tuple
             tuple_t *tuple  = find_tuple(key, h);
@@ -322,7 +681,7 @@ namespace lsp
 
         void **raw_pphash::create(const void *key, void *value)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find tuple
             tuple_t *tuple  = find_tuple(key, h);
@@ -341,7 +700,7 @@ namespace lsp
 
         void **raw_pphash::replace(const void *key, void *value, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find tuple
             tuple_t *tuple  = find_tuple(key, h);
@@ -356,7 +715,7 @@ namespace lsp
 
         bool raw_pphash::remove(const void *key, void **ov)
         {
-            size_t h        = (key != NULL) ? hash.hash(key, ksize) : 0;
+            size_t h        = (key != NULL) ? hash.compute(key, ksize) : 0;
 
             // Find tuple
             tuple_t *tuple  = remove_tuple(key, h);
@@ -369,7 +728,7 @@ namespace lsp
             // Free tuple data
             if (tuple->v.key != NULL)
                 alloc.free(tuple->v.key);
-            ::free(tuple);
+            free_tuple(tuple);
             return true;
         }
 
@@ -383,8 +742,13 @@ namespace lsp
                 return false;
 
             // Make a snapshot
-            for (size_t i=0; i<cap; ++i)
-                for (tuple_t *t = bins[i].data; t != NULL; t = t->next)
+            for (size_t i=0, n=bin_count(); i<n; ++i)
+            {
+                const bin_t *bin = bin_at(i);
+                if (bin == NULL)
+                    continue;
+
+                for (tuple_t *t = bin->data; t != NULL; t = t->next)
                 {
                     if (!kt.append(t->v.key))
                     {
@@ -392,6 +756,7 @@ namespace lsp
                         return false;
                     }
                 }
+            }
 
             // Return collection data
             kt.swap(k);
@@ -410,8 +775,13 @@ namespace lsp
                 return false;
 
             // Make a snapshot
-            for (size_t i=0; i<cap; ++i)
-                for (tuple_t *t = bins[i].data; t != NULL; t = t->next)
+            for (size_t i=0, n=bin_count(); i<n; ++i)
+            {
+                const bin_t *bin = bin_at(i);
+                if (bin == NULL)
+                    continue;
+
+                for (tuple_t *t = bin->data; t != NULL; t = t->next)
                 {
                     if (!kv.append(t->v.value))
                     {
@@ -419,6 +789,7 @@ namespace lsp
                         return false;
                     }
                 }
+            }
 
             // Return collection data
             kv.swap(v);
@@ -444,10 +815,13 @@ namespace lsp
             }
 
             // Make a snapshot
-            for (size_t i=0; i<cap; ++i)
+            for (size_t i=0, n=bin_count(); i<n; ++i)
             {
-                tuple_t *t = bins[i].data;
-                for (; t != NULL; t = t->next)
+                const bin_t *bin = bin_at(i);
+                if (bin == NULL)
+                    continue;
+
+                for (tuple_t *t = bin->data; t != NULL; t = t->next)
                 {
                     if ((!kt.append(t->v.key)) ||
                         (!vt.append(t->v.value)))
@@ -471,6 +845,9 @@ namespace lsp
 
         raw_iterator raw_pphash::iter(const iter_vtbl_t *vtbl)
         {
+            // Iterators do not support split array of bins
+            finish_rehash();
+
             if (size <= 0)
                 return raw_iterator::INVALID;
 
@@ -495,6 +872,9 @@ namespace lsp
 
         raw_iterator raw_pphash::riter(const iter_vtbl_t *vtbl)
         {
+            // Iterators do not support split array of bins
+            finish_rehash();
+
             if (size <= 0)
                 return raw_iterator::INVALID;
 
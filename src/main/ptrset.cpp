@@ -21,6 +21,8 @@
 
 #include <lsp-plug.in/lltl/ptrset.h>
 
+#include <private/lltl/hash.h>
+
 namespace lsp
 {
     namespace lltl
@@ -127,7 +129,7 @@ namespace lsp
                 for (size_t i=0; i<bin->size; ++i)
                 {
                     void *value         = bin->data[i];
-                    size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+                    size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
                     bin_t *dbin         = (hval & mask) ? ybin : xbin;
                     if (!append(dbin, value))
                         return false;
@@ -140,6 +142,108 @@ namespace lsp
             return true;
         }
 
+        bool raw_ptrset::rehash(size_t ncap)
+        {
+            raw_ptrset tmp;
+            tmp.bins        = static_cast<bin_t *>(::malloc(ncap * sizeof(bin_t)));
+            if (tmp.bins == NULL)
+                return false;
+            tmp.size        = size;
+            tmp.cap         = ncap;
+            tmp.hash        = hash;
+
+            for (size_t i=0; i<ncap; ++i)
+            {
+                bin_t *bin      = &tmp.bins[i];
+                bin->size       = 0;
+                bin->cap        = 0;
+                bin->data       = NULL;
+            }
+            lsp_finally {
+                tmp.flush();
+            };
+
+            // Distribute values between new bins, several source bins may be merged
+            // into one target bin, so keep the target bin sorted
+            for (size_t i=0; i<cap; ++i)
+            {
+                bin_t *bin      = &bins[i];
+                for (size_t j=0; j<bin->size; ++j)
+                {
+                    void *value         = bin->data[j];
+                    size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
+                    bin_t *dbin         = &tmp.bins[hval & (ncap - 1)];
+                    ssize_t idx         = insert_index_of(dbin, value);
+                    if ((idx >= 0) && (!insert(dbin, value, idx)))
+                        return false;
+                }
+            }
+
+            // Commit new state
+            tmp.swap(this);
+
+            return true;
+        }
+
+        bool raw_ptrset::reserve(size_t count)
+        {
+            const size_t ncap   = bin_capacity(count);
+            if ((ncap > cap) && (!rehash(ncap)))
+                return false;
+
+            // Preallocate storage in each bin
+            for (size_t i=0; i<cap; ++i)
+            {
+                bin_t *bin          = &bins[i];
+                if (bin->cap >= ptrset_tuple_items)
+                    continue;
+
+                void **data         = static_cast<void **>(::realloc(bin->data, ptrset_tuple_items * sizeof(void *)));
+                if (data == NULL)
+                    return false;
+
+                bin->data           = data;
+                bin->cap            = ptrset_tuple_items;
+            }
+
+            return true;
+        }
+
+        bool raw_ptrset::shrink_to_fit()
+        {
+            if (size <= 0)
+            {
+                flush();
+                return true;
+            }
+
+            const size_t ncap   = bin_capacity(size);
+            if ((ncap < cap) && (!rehash(ncap)))
+                return false;
+
+            // Release unused storage of each bin
+            for (size_t i=0; i<cap; ++i)
+            {
+                bin_t *bin          = &bins[i];
+                if (bin->size <= 0)
+                {
+                    destroy_bin(bin);
+                    continue;
+                }
+                if (bin->cap <= bin->size)
+                    continue;
+
+                void **data         = static_cast<void **>(::realloc(bin->data, bin->size * sizeof(void *)));
+                if (data == NULL)
+                    return false;
+
+                bin->data           = data;
+                bin->cap            = bin->size;
+            }
+
+            return true;
+        }
+
         void raw_ptrset::flush()
         {
             // Drop all bins
@@ -161,7 +265,7 @@ namespace lsp
             if (bins != NULL)
             {
                 for (size_t i=0; i<cap; ++i)
-                    destroy_bin(&bins[i]);
+                    bins[i].size    = 0;
             }
 
             size    = 0;
@@ -301,7 +405,7 @@ namespace lsp
             if (bins == NULL)
                 return dfl;
 
-            size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+            size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
             bin_t *bin          = &bins[hval & (cap - 1)];
             ssize_t idx         = index_of(bin, value);
             return (idx < 0) ? dfl : bin->data[idx];
@@ -312,7 +416,7 @@ namespace lsp
             if (bins == NULL)
                 return false;
 
-            size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+            size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
             bin_t *bin          = &bins[hval & (cap - 1)];
             ssize_t idx         = index_of(bin, value);
 
@@ -337,7 +441,7 @@ namespace lsp
         bool raw_ptrset::put(void *value)
         {
             // Grow the size of the set if it is too small
-            size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+            size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
             bin_t *bin          = (bins != NULL) ? &bins[hval & (cap - 1)] : NULL;
             if ((bin == NULL) || (bin->size >= (ptrset_tuple_items << 1)))
             {
@@ -365,7 +469,7 @@ namespace lsp
                 return put(value);
 
             // Insert value if the bin is empty
-            size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+            size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
             bin_t *bin          = &bins[hval & (cap - 1)];
             if (bin->size <= 0)
             {
@@ -403,7 +507,7 @@ namespace lsp
                 return false;
 
             // Find tuple
-            size_t hval         = (value != NULL) ? hash.hash(value, sizeof(void *)) : 0;
+            size_t hval         = (value != NULL) ? hash.compute(value, sizeof(void *)) : 0;
             bin_t *bin          = &bins[hval & (cap - 1)];
             ssize_t idx         = index_of(bin, value);
             if (idx < 0)
@@ -23,25 +23,135 @@
 #include <lsp-plug.in/lltl/shbuffer.h>
 #include <lsp-plug.in/stdlib/string.h>
 
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
 namespace lsp
 {
     namespace lltl
     {
-        void *raw_shbuffer::get(size_t offset)
+        typedef struct file_mapping_t
+        {
+            raw_shbuffer::buffer_t  hdr;        // Header of the shared buffer, should be first
+            void                   *base;       // Start address of the mapping
+            size_t                  length;     // Length of the mapping
+        } file_mapping_t;
+
+        static void unmap_file(raw_shbuffer::buffer_t *buf)
+        {
+            file_mapping_t *fm = reinterpret_cast<file_mapping_t *>(buf);
+        #ifdef PLATFORM_WINDOWS
+            UnmapViewOfFile(fm->base);
+        #else
+            munmap(fm->base, fm->length);
+        #endif /* PLATFORM_WINDOWS */
+            free(fm);
+        }
+
+        void raw_shbuffer::init()
+        {
+            ptr             = NULL;
+            offset          = 0;
+            length          = 0;
+        }
+
+        void *raw_shbuffer::get(size_t index)
+        {
+            if ((ptr == NULL) || (index >= length))
+                return NULL;
+            return &ptr->data[offset + index];
+        }
+
+        void raw_shbuffer::assign(raw_shbuffer *src)
+        {
+            const size_t s_offset   = src->offset;
+            const size_t s_length   = src->length;
+
+            reference_down(src->reference_up());
+            offset          = s_offset;
+            length          = s_length;
+        }
+
+        void raw_shbuffer::take(raw_shbuffer *src)
+        {
+            if (src == this)
+                return;
+
+            const size_t s_offset   = src->offset;
+            const size_t s_length   = src->length;
+            buffer_t * const s_ptr  = src->ptr;
+            src->init();
+
+            reference_down(s_ptr);
+            offset          = s_offset;
+            length          = s_length;
+        }
+
+        void raw_shbuffer::slice(raw_shbuffer *dst, size_t first, size_t count, size_t szof)
+        {
+            const size_t total      = length / szof;
+            if ((ptr == NULL) || (first >= total) || (count <= 0))
+            {
+                dst->reference_down(NULL);
+                return;
+            }
+
+            count                   = lsp_min(count, total - first);
+            const size_t s_offset   = offset + first * szof;
+            dst->reference_down(reference_up());
+            dst->offset             = s_offset;
+            dst->length             = count * szof;
+        }
+
+        void raw_shbuffer::swap(raw_shbuffer *src)
         {
-            if ((ptr == NULL) || (offset >= ptr->bytes))
+            lsp::swap(ptr, src->ptr);
+            lsp::swap(offset, src->offset);
+            lsp::swap(length, src->length);
+        }
+
+        void *raw_shbuffer::edit(shbuffer_pool *pool)
+        {
+            if (ptr == NULL)
+                return NULL;
+
+            // The only reference can not be duplicated by another thread, so it is safe to modify data
+            if ((ptr->writable) && (atomic_load(&ptr->references) == 1))
+                return &ptr->data[offset];
+
+            // Copy the referenced window to the new buffer
+            raw_shbuffer tmp;
+            tmp.init();
+            tmp.make(&ptr->data[offset], length, pool);
+            if (tmp.ptr == NULL)
                 return NULL;
+
+            take(&tmp);
             return &ptr->data[offset];
         }
 
-        void raw_shbuffer::map(void *data, size_t length, deleter_t deleter)
+        void raw_shbuffer::map(void *data, size_t length, deleter_t deleter, shbuffer_pool *pool)
         {
             const size_t szof_hdr       = sizeof(buffer_t);
-            buffer_t * const hdr        = static_cast<buffer_t *>(malloc(szof_hdr));
+            buffer_t * hdr              = (pool != NULL) ? pool->allocate(0) : NULL;
+            if (hdr == NULL)
+            {
+                hdr                         = static_cast<buffer_t *>(malloc(szof_hdr));
+                if (hdr != NULL)
+                    hdr->destructor             = NULL;
+            }
             if (hdr != NULL)
             {
                 atomic_store(&hdr->references, 1);
                 hdr->deleter                = deleter;
+                hdr->writable               = false;
                 hdr->bytes                  = length;
                 hdr->data                   = static_cast<uint8_t *>(data);
             }
@@ -49,17 +159,26 @@ namespace lsp
             reference_down(hdr);
         }
 
-        void raw_shbuffer::make(const void *data, size_t length)
+        void raw_shbuffer::make(const void *data, size_t length, shbuffer_pool *pool)
         {
             // Create new data structure
             const size_t szof_hdr       = sizeof(buffer_t);
-            buffer_t * const hdr        = static_cast<buffer_t *>(malloc(szof_hdr + length + DEFAULT_ALIGN));
+            buffer_t * hdr              = ((pool != NULL) && (length > 0)) ? pool->allocate(length) : NULL;
+            if (hdr == NULL)
+            {
+                hdr                         = static_cast<buffer_t *>(malloc(szof_hdr + length + DEFAULT_ALIGN));
+                if (hdr != NULL)
+                {
+                    hdr->destructor             = NULL;
+                    hdr->data                   = reinterpret_cast<uint8_t *>(align_ptr(&hdr[1], DEFAULT_ALIGN));
+                }
+            }
             if (hdr != NULL)
             {
                 atomic_store(&hdr->references, 1);
                 hdr->deleter                = NULL;
+                hdr->writable               = true;
                 hdr->bytes                  = length;
-                hdr->data                   = reinterpret_cast<uint8_t *>(align_ptr(&hdr[1], DEFAULT_ALIGN));
                 memcpy(hdr->data, data, length);
             }
 
@@ -75,6 +194,9 @@ namespace lsp
 
         void raw_shbuffer::reference_down(buffer_t *replace)
         {
+            offset      = 0;
+            length      = (replace != NULL) ? replace->bytes : 0;
+
             if (ptr == NULL)
             {
                 ptr         = replace;
@@ -89,28 +211,375 @@ namespace lsp
             }
 
             // Destroy the memory
-            if (ptr->deleter != NULL)
-                ptr->deleter(ptr->data);
-            free(ptr);
+            if (ptr->destructor != NULL)
+                ptr->destructor(ptr);
+            else
+            {
+                if (ptr->deleter != NULL)
+                    ptr->deleter(ptr->data);
+                free(ptr);
+            }
             ptr     = replace;
         }
 
+    #ifdef PLATFORM_WINDOWS
+        status_t raw_shbuffer::map_file(const char *path, wsize_t offset, wsize_t length, size_t advice)
+        {
+            if (path == NULL)
+                return STATUS_BAD_ARGUMENTS;
+
+            // Convert path to UTF-16
+            int wlen            = MultiByteToWideChar(CP_UTF8, 0, path, -1, NULL, 0);
+            if (wlen <= 0)
+                return STATUS_BAD_ARGUMENTS;
+            WCHAR *wpath        = static_cast<WCHAR *>(malloc(wlen * sizeof(WCHAR)));
+            if (wpath == NULL)
+                return STATUS_NO_MEM;
+            lsp_finally { free(wpath); };
+            MultiByteToWideChar(CP_UTF8, 0, path, -1, wpath, wlen);
+
+            // Open the file
+            HANDLE fd           = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+            if (fd == INVALID_HANDLE_VALUE)
+            {
+                DWORD error         = GetLastError();
+                if ((error == ERROR_FILE_NOT_FOUND) || (error == ERROR_PATH_NOT_FOUND))
+                    return STATUS_NOT_FOUND;
+                return (error == ERROR_ACCESS_DENIED) ? STATUS_PERMISSION_DENIED : STATUS_IO_ERROR;
+            }
+            lsp_finally { CloseHandle(fd); };
+
+            // Check the range
+            LARGE_INTEGER fsize;
+            if (!GetFileSizeEx(fd, &fsize))
+                return STATUS_IO_ERROR;
+            if (offset > wsize_t(fsize.QuadPart))
+                return STATUS_BAD_ARGUMENTS;
+            if (length == 0)
+                length              = fsize.QuadPart - offset;
+            if ((length == 0) || (length > wsize_t(fsize.QuadPart) - offset))
+                return (length == 0) ? STATUS_NO_DATA : STATUS_BAD_ARGUMENTS;
+            if (length > wsize_t(SIZE_MAX))
+                return STATUS_NO_MEM;
+
+            // Map the region aligned to the allocation granularity
+            HANDLE hmap         = CreateFileMappingW(fd, NULL, PAGE_READONLY, 0, 0, NULL);
+            if (hmap == NULL)
+                return STATUS_IO_ERROR;
+            lsp_finally { CloseHandle(hmap); };
+
+            SYSTEM_INFO si;
+            GetSystemInfo(&si);
+            wsize_t delta       = offset % si.dwAllocationGranularity;
+            wsize_t base        = offset - delta;
+            size_t map_length   = length + delta;
+            void *addr          = MapViewOfFile(hmap, FILE_MAP_READ, DWORD(base >> 32), DWORD(base & 0xffffffff), map_length);
+            if (addr == NULL)
+                return STATUS_NO_MEM;
+
+            // Access pattern hints have no equivalent for file views
+            (void)advice;
+
+            file_mapping_t *fm  = static_cast<file_mapping_t *>(malloc(sizeof(file_mapping_t)));
+            if (fm == NULL)
+            {
+                UnmapViewOfFile(addr);
+                return STATUS_NO_MEM;
+            }
+
+            atomic_store(&fm->hdr.references, 1);
+            fm->hdr.deleter     = NULL;
+            fm->hdr.destructor  = unmap_file;
+            fm->hdr.writable    = false;
+            fm->hdr.bytes       = length;
+            fm->hdr.data        = static_cast<uint8_t *>(addr) + delta;
+            fm->base            = addr;
+            fm->length          = map_length;
+
+            reference_down(&fm->hdr);
+            return STATUS_OK;
+        }
+    #else
+        status_t raw_shbuffer::map_file(const char *path, wsize_t offset, wsize_t length, size_t advice)
+        {
+            if (path == NULL)
+                return STATUS_BAD_ARGUMENTS;
+
+            // Open the file
+            int fd              = open(path, O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+            {
+                int error           = errno;
+                if ((error == ENOENT) || (error == ENOTDIR))
+                    return STATUS_NOT_FOUND;
+                return (error == EACCES) ? STATUS_PERMISSION_DENIED : STATUS_IO_ERROR;
+            }
+            lsp_finally { close(fd); };
+
+            // Check the range
+            struct stat st;
+            if (fstat(fd, &st) != 0)
+                return STATUS_IO_ERROR;
+            if (!S_ISREG(st.st_mode))
+                return STATUS_BAD_ARGUMENTS;
+            if (offset > wsize_t(st.st_size))
+                return STATUS_BAD_ARGUMENTS;
+            if (length == 0)
+                length              = st.st_size - offset;
+            if ((length == 0) || (length > wsize_t(st.st_size) - offset))
+                return (length == 0) ? STATUS_NO_DATA : STATUS_BAD_ARGUMENTS;
+            if (length > wsize_t(SIZE_MAX))
+                return STATUS_NO_MEM;
+
+            // Map the region aligned to the page size
+            wsize_t page        = sysconf(_SC_PAGESIZE);
+            wsize_t delta       = offset % page;
+            size_t map_length   = length + delta;
+            void *addr          = mmap(NULL, map_length, PROT_READ, MAP_PRIVATE, fd, off_t(offset - delta));
+            if (addr == MAP_FAILED)
+                return (errno == ENOMEM) ? STATUS_NO_MEM : STATUS_IO_ERROR;
+
+            // Apply access pattern hints
+            if (advice & SHBUFFER_ADVICE_SEQUENTIAL)
+                madvise(addr, map_length, MADV_SEQUENTIAL);
+            else if (advice & SHBUFFER_ADVICE_RANDOM)
+                madvise(addr, map_length, MADV_RANDOM);
+            if (advice & SHBUFFER_ADVICE_WILLNEED)
+                madvise(addr, map_length, MADV_WILLNEED);
+
+            file_mapping_t *fm  = static_cast<file_mapping_t *>(malloc(sizeof(file_mapping_t)));
+            if (fm == NULL)
+            {
+                munmap(addr, map_length);
+                return STATUS_NO_MEM;
+            }
+
+            atomic_store(&fm->hdr.references, 1);
+            fm->hdr.deleter     = NULL;
+            fm->hdr.destructor  = unmap_file;
+            fm->hdr.writable    = false;
+            fm->hdr.bytes       = length;
+            fm->hdr.data        = static_cast<uint8_t *>(addr) + delta;
+            fm->base            = addr;
+            fm->length          = map_length;
+
+            reference_down(&fm->hdr);
+            return STATUS_OK;
+        }
+    #endif /* PLATFORM_WINDOWS */
+
         ptrdiff_t raw_shbuffer::compare(const raw_shbuffer & src)
         {
             if (ptr == src.ptr)
-                return 0;
-            const uint8_t *a = (ptr != NULL) ? ptr->data : NULL;
-            const uint8_t *b = (src.ptr != NULL) ? src.ptr->data : NULL;
+                return (offset != src.offset) ? offset - src.offset : length - src.length;
+            const uint8_t *a = (ptr != NULL) ? &ptr->data[offset] : NULL;
+            const uint8_t *b = (src.ptr != NULL) ? &src.ptr->data[src.offset] : NULL;
             return a - b;
         }
 
         ptrdiff_t raw_shbuffer::compare(const void *p)
         {
-            const uint8_t *a = (ptr != NULL) ? ptr->data : NULL;
+            const uint8_t *a = (ptr != NULL) ? &ptr->data[offset] : NULL;
             const uint8_t *b = reinterpret_cast<const uint8_t *>(p);
             return a - b;
         }
 
+        //-------------------------------------------------------------------------
+        // Pool of shared buffers
+        struct shbuffer_pool::block_t
+        {
+            raw_shbuffer::buffer_t  hdr;        // Header of the shared buffer, should be first
+            block_t                *next;       // Next block in the list
+            shbuffer_pool          *pool;       // Pool the block belongs to
+            size_t                  sclass;     // Size class of the block
+        };
+
+        shbuffer_pool::shbuffer_pool()
+        {
+            for (size_t i=0; i<shbuffer_pool_classes; ++i)
+            {
+                bin_t *bin          = &vBins[i];
+                bin->free           = NULL;
+                bin->returned       = NULL;
+                atomic_init(bin->lock);
+            }
+        }
+
+        shbuffer_pool::~shbuffer_pool()
+        {
+            flush();
+        }
+
+        size_t shbuffer_pool::max_bytes()
+        {
+            return class_bytes(shbuffer_pool_classes - 1);
+        }
+
+        ssize_t shbuffer_pool::size_class(size_t bytes)
+        {
+            // Class 0 holds headers of buffers with external data, next classes
+            // hold the data of 2^(shbuffer_pool_min_shift + class - 1) bytes
+            if (bytes <= 0)
+                return 0;
+            for (size_t i=1; i<shbuffer_pool_classes; ++i)
+                if (bytes <= class_bytes(i))
+                    return i;
+            return -1;
+        }
+
+        size_t shbuffer_pool::class_bytes(size_t sclass)
+        {
+            return (sclass > 0) ? size_t(1) << (shbuffer_pool_min_shift + sclass - 1) : 0;
+        }
+
+        void shbuffer_pool::release(raw_shbuffer::buffer_t *buf)
+        {
+            block_t *block      = reinterpret_cast<block_t *>(buf);
+            if (block->hdr.deleter != NULL)
+                block->hdr.deleter(block->hdr.data);
+
+            // Push the block to the list of returned blocks, lock-free
+            bin_t *bin          = &block->pool->vBins[block->sclass];
+            block_t *head;
+            do
+            {
+                head                = atomic_load(&bin->returned);
+                block->next         = head;
+            } while (!atomic_cas(&bin->returned, head, block));
+        }
+
+        void shbuffer_pool::free_list(block_t *list)
+        {
+            while (list != NULL)
+            {
+                block_t *next       = list->next;
+                free(list);
+                list                = next;
+            }
+        }
+
+        shbuffer_pool::block_t *shbuffer_pool::alloc_block(size_t sclass)
+        {
+            const size_t bytes  = class_bytes(sclass);
+            block_t *block      = static_cast<block_t *>(malloc(sizeof(block_t) + bytes + DEFAULT_ALIGN));
+            if (block == NULL)
+                return NULL;
+
+            block->hdr.destructor   = release;
+            block->hdr.data         = (bytes > 0) ? reinterpret_cast<uint8_t *>(align_ptr(&block[1], DEFAULT_ALIGN)) : NULL;
+            block->next             = NULL;
+            block->pool             = this;
+            block->sclass           = sclass;
+
+            return block;
+        }
+
+        raw_shbuffer::buffer_t *shbuffer_pool::allocate(size_t bytes)
+        {
+            const ssize_t sclass = size_class(bytes);
+            if (sclass < 0)
+                return NULL;
+
+            // Take the block from the free list, pick up returned blocks if the list is empty.
+            // Only the holder of the lock pops blocks, so the lists are not affected by ABA problem.
+            bin_t *bin          = &vBins[sclass];
+            block_t *block      = NULL;
+            if (atomic_trylock(bin->lock))
+            {
+                block               = bin->free;
+                if (block == NULL)
+                    block               = atomic_swap(&bin->returned, static_cast<block_t *>(NULL));
+                if (block != NULL)
+                    bin->free           = block->next;
+                atomic_unlock(bin->lock);
+            }
+
+            // Allocate new block if there is nothing to reuse
+            if (block == NULL)
+            {
+                block               = alloc_block(sclass);
+                if (block == NULL)
+                    return NULL;
+            }
+
+            block->next         = NULL;
+            return &block->hdr;
+        }
+
+        bool shbuffer_pool::reserve(size_t bytes, size_t count)
+        {
+            const ssize_t sclass = size_class(bytes);
+            if (sclass < 0)
+                return false;
+
+            // Allocate the list of blocks
+            block_t *list       = NULL;
+            block_t *tail       = NULL;
+            for (size_t i=0; i<count; ++i)
+            {
+                block_t *block      = alloc_block(sclass);
+                if (block == NULL)
+                {
+                    free_list(list);
+                    return false;
+                }
+                block->next         = list;
+                list                = block;
+                if (tail == NULL)
+                    tail                = block;
+            }
+            if (list == NULL)
+                return true;
+
+            // Append blocks to the free list
+            bin_t *bin          = &vBins[sclass];
+            if (!atomic_trylock(bin->lock))
+            {
+                free_list(list);
+                return false;
+            }
+            tail->next          = bin->free;
+            bin->free           = list;
+            atomic_unlock(bin->lock);
+
+            return true;
+        }
+
+        size_t shbuffer_pool::cached()
+        {
+            size_t count        = 0;
+            for (size_t i=0; i<shbuffer_pool_classes; ++i)
+            {
+                bin_t *bin          = &vBins[i];
+                if (!atomic_trylock(bin->lock))
+                    continue;
+                for (block_t *b = bin->free; b != NULL; b = b->next)
+                    ++count;
+                for (block_t *b = atomic_load(&bin->returned); b != NULL; b = b->next)
+                    ++count;
+                atomic_unlock(bin->lock);
+            }
+            return count;
+        }
+
+        void shbuffer_pool::flush()
+        {
+            for (size_t i=0; i<shbuffer_pool_classes; ++i)
+            {
+                bin_t *bin          = &vBins[i];
+                while (!atomic_trylock(bin->lock))
+                    /* spin */ ;
+
+                block_t *list       = bin->free;
+                block_t *returned   = atomic_swap(&bin->returned, static_cast<block_t *>(NULL));
+                bin->free           = NULL;
+                atomic_unlock(bin->lock);
+
+                free_list(list);
+                free_list(returned);
+            }
+        }
+
 
     } /* namespace lltl */
 } /* namespace lsp */
@@ -0,0 +1,1203 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/sparse_bitset.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/lltl/bits.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        static constexpr size_t sparse_chunk_shift      = 16;
+        static constexpr size_t sparse_chunk_bits       = size_t(1) << sparse_chunk_shift;
+        static constexpr size_t sparse_chunk_mask       = sparse_chunk_bits - 1;
+        static constexpr size_t sparse_bitmap_words     = sparse_chunk_bits / 64;
+        static constexpr size_t sparse_bitmap_bytes     = sparse_bitmap_words * sizeof(uint64_t);
+        static constexpr size_t sparse_array_max        = 4096;
+        static constexpr size_t sparse_min_chunks       = 16;
+        static constexpr size_t sparse_min_items        = 4;
+
+        // Find first set (or unset if invert is set) bit of the bitmap starting with position
+        static size_t bitmap_next(const uint64_t *bits, size_t pos, uint64_t invert)
+        {
+            if (pos >= sparse_chunk_bits)
+                return sparse_chunk_bits;
+
+            size_t i    = pos >> 6;
+            uint64_t w  = (bits[i] ^ invert) & (~uint64_t(0) << (pos & 0x3f));
+            while (w == 0)
+            {
+                if ((++i) >= sparse_bitmap_words)
+                    return sparse_chunk_bits;
+                w           = bits[i] ^ invert;
+            }
+
+            return (i << 6) + first_bit(w);
+        }
+
+        // Modify the range of bits [first, last] of the bitmap
+        static void bitmap_range(uint64_t *bits, size_t first, size_t last, bool set, bool toggle)
+        {
+            size_t fw   = first >> 6;
+            size_t lw   = last >> 6;
+            uint64_t fm = ~uint64_t(0) << (first & 0x3f);
+            uint64_t lm = ~uint64_t(0) >> (0x3f - (last & 0x3f));
+
+            for (size_t i=fw; i<=lw; ++i)
+            {
+                uint64_t mask   = ~uint64_t(0);
+                if (i == fw)
+                    mask           &= fm;
+                if (i == lw)
+                    mask           &= lm;
+
+                if (toggle)
+                    bits[i]        ^= mask;
+                else if (set)
+                    bits[i]        |= mask;
+                else
+                    bits[i]        &= ~mask;
+            }
+        }
+
+        // Get index of the first element which is not less than the value
+        static size_t array_search(const uint16_t *a, size_t n, size_t value)
+        {
+            size_t first = 0, last = n;
+            while (first < last)
+            {
+                size_t mid  = (first + last) >> 1;
+                if (a[mid] < value)
+                    first       = mid + 1;
+                else
+                    last        = mid;
+            }
+            return first;
+        }
+
+        sparse_bitset::sparse_bitset()
+        {
+            nSize       = 0;
+            nChunks     = 0;
+            nCapacity   = 0;
+            vChunks     = NULL;
+        }
+
+        sparse_bitset::~sparse_bitset()
+        {
+            flush();
+        }
+
+        size_t sparse_bitset::item_size(uint32_t type)
+        {
+            switch (type)
+            {
+                case CHUNK_ARRAY:   return sizeof(uint16_t);
+                case CHUNK_RUN:     return sizeof(run_t);
+                default:            break;
+            }
+            return sizeof(uint64_t);
+        }
+
+        ssize_t sparse_bitset::run_search(const run_t *r, size_t n, size_t value)
+        {
+            // Get index of the last run which starts not after the value
+            ssize_t first = 0, last = ssize_t(n) - 1;
+            while (first <= last)
+            {
+                ssize_t mid = (first + last) >> 1;
+                if (r[mid].start <= value)
+                    first       = mid + 1;
+                else
+                    last        = mid - 1;
+            }
+            return last;
+        }
+
+        void sparse_bitset::chunk_free(chunk_t *c)
+        {
+            if (c->data != NULL)
+            {
+                ::free(c->data);
+                c->data     = NULL;
+            }
+            c->type     = CHUNK_ARRAY;
+            c->count    = 0;
+            c->size     = 0;
+            c->cap      = 0;
+        }
+
+        bool sparse_bitset::chunk_reserve(chunk_t *c, size_t size, size_t szof)
+        {
+            if (size <= c->cap)
+                return true;
+
+            size_t cap  = (c->cap > 0) ? c->cap : sparse_min_items;
+            while (cap < size)
+                cap       <<= 1;
+
+            void *data  = ::realloc(c->data, cap * szof);
+            if (data == NULL)
+                return false;
+
+            c->data     = data;
+            c->cap      = cap;
+            return true;
+        }
+
+        void sparse_bitset::to_bitmap(uint64_t *dst, const chunk_t *c)
+        {
+            switch (c->type)
+            {
+                case CHUNK_BITMAP:
+                    ::memcpy(dst, c->data, sparse_bitmap_bytes);
+                    break;
+
+                case CHUNK_ARRAY:
+                {
+                    ::bzero(dst, sparse_bitmap_bytes);
+                    const uint16_t *a = static_cast<const uint16_t *>(c->data);
+                    for (size_t i=0; i<c->size; ++i)
+                        dst[a[i] >> 6]     |= uint64_t(1) << (a[i] & 0x3f);
+                    break;
+                }
+
+                case CHUNK_RUN:
+                {
+                    ::bzero(dst, sparse_bitmap_bytes);
+                    const run_t *r  = static_cast<const run_t *>(c->data);
+                    for (size_t i=0; i<c->size; ++i)
+                        bitmap_range(dst, r[i].start, r[i].start + r[i].length, true, false);
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+
+        bool sparse_bitset::from_bitmap(chunk_t *c, const uint64_t *src)
+        {
+            // Estimate the number of bits and runs
+            size_t count = 0, runs = 0;
+            uint64_t carry = 0;
+            for (size_t i=0; i<sparse_bitmap_words; ++i)
+            {
+                uint64_t w  = src[i];
+                count      += bit_count(w);
+                runs       += bit_count(w & (~((w << 1) | carry)));
+                carry       = w >> 63;
+            }
+
+            if (count == 0)
+            {
+                chunk_free(c);
+                return true;
+            }
+
+            // Select the container which requires less memory
+            size_t abytes   = (count <= sparse_array_max) ? count * sizeof(uint16_t) : sparse_bitmap_bytes;
+            size_t rbytes   = runs * sizeof(run_t);
+            uint32_t type   =
+                (rbytes <= abytes) && (rbytes < sparse_bitmap_bytes) ? CHUNK_RUN :
+                (abytes < sparse_bitmap_bytes) ? CHUNK_ARRAY : CHUNK_BITMAP;
+
+            if ((type == CHUNK_BITMAP) && (c->type == CHUNK_BITMAP))
+            {
+                if (c->data != src)
+                    ::memcpy(c->data, src, sparse_bitmap_bytes);
+                c->count    = count;
+                return true;
+            }
+
+            size_t items    = (type == CHUNK_ARRAY) ? count : (type == CHUNK_RUN) ? runs : sparse_bitmap_words;
+            void *data      = ::malloc(items * item_size(type));
+            if (data == NULL)
+                return false;
+
+            switch (type)
+            {
+                case CHUNK_ARRAY:
+                {
+                    uint16_t *a = static_cast<uint16_t *>(data);
+                    for (size_t i=0, n=0; i<sparse_bitmap_words; ++i)
+                        for (uint64_t w = src[i]; w; w &= w - 1)
+                            a[n++]      = (i << 6) + first_bit(w);
+                    break;
+                }
+
+                case CHUNK_RUN:
+                {
+                    run_t *r    = static_cast<run_t *>(data);
+                    for (size_t pos = bitmap_next(src, 0, 0), n=0; pos < sparse_chunk_bits; ++n)
+                    {
+                        size_t end      = bitmap_next(src, pos, ~uint64_t(0));
+                        r[n].start      = pos;
+                        r[n].length     = end - pos - 1;
+                        pos             = bitmap_next(src, end, 0);
+                    }
+                    break;
+                }
+
+                default:
+                    ::memcpy(data, src, sparse_bitmap_bytes);
+                    break;
+            }
+
+            chunk_free(c);
+            c->type     = type;
+            c->count    = count;
+            c->size     = (type == CHUNK_BITMAP) ? 0 : items;
+            c->cap      = c->size;
+            c->data     = data;
+
+            return true;
+        }
+
+        bool sparse_bitset::reencode(chunk_t *c)
+        {
+            uint64_t *tmp   = static_cast<uint64_t *>(::malloc(sparse_bitmap_bytes));
+            if (tmp == NULL)
+                return false;
+            lsp_finally { ::free(tmp); };
+
+            to_bitmap(tmp, c);
+            return from_bitmap(c, tmp);
+        }
+
+        bool sparse_bitset::run_oversized(const chunk_t *c)
+        {
+            size_t limit    = (c->count <= sparse_array_max) ? c->count * sizeof(uint16_t) : sparse_bitmap_bytes;
+            return c->size * sizeof(run_t) > limit;
+        }
+
+        bool sparse_bitset::chunk_get(const chunk_t *c, size_t low)
+        {
+            switch (c->type)
+            {
+                case CHUNK_ARRAY:
+                {
+                    const uint16_t *a = static_cast<const uint16_t *>(c->data);
+                    size_t i        = array_search(a, c->size, low);
+                    return (i < c->size) && (a[i] == low);
+                }
+
+                case CHUNK_BITMAP:
+                {
+                    const uint64_t *b = static_cast<const uint64_t *>(c->data);
+                    return b[low >> 6] & (uint64_t(1) << (low & 0x3f));
+                }
+
+                case CHUNK_RUN:
+                {
+                    const run_t *r  = static_cast<const run_t *>(c->data);
+                    ssize_t i       = run_search(r, c->size, low);
+                    return (i >= 0) && (low <= size_t(r[i].start + r[i].length));
+                }
+
+                default:
+                    break;
+            }
+
+            return false;
+        }
+
+        bool sparse_bitset::chunk_add(chunk_t *c, size_t low, bool *prev)
+        {
+            *prev       = false;
+
+            switch (c->type)
+            {
+                case CHUNK_ARRAY:
+                {
+                    uint16_t *a     = static_cast<uint16_t *>(c->data);
+                    size_t i        = array_search(a, c->size, low);
+                    if ((i < c->size) && (a[i] == low))
+                    {
+                        *prev           = true;
+                        return true;
+                    }
+
+                    // Convert to bitmap if array becomes too large
+                    if (c->size >= sparse_array_max)
+                    {
+                        uint64_t *b     = static_cast<uint64_t *>(::malloc(sparse_bitmap_bytes));
+                        if (b == NULL)
+                            return false;
+
+                        to_bitmap(b, c);
+                        b[low >> 6]    |= uint64_t(1) << (low & 0x3f);
+                        size_t count    = c->count + 1;
+
+                        chunk_free(c);
+                        c->type         = CHUNK_BITMAP;
+                        c->count        = count;
+                        c->data         = b;
+                        return true;
+                    }
+
+                    if (!chunk_reserve(c, c->size + 1, sizeof(uint16_t)))
+                        return false;
+
+                    a               = static_cast<uint16_t *>(c->data);
+                    ::memmove(&a[i + 1], &a[i], (c->size - i) * sizeof(uint16_t));
+                    a[i]            = low;
+                    ++c->size;
+                    ++c->count;
+                    return true;
+                }
+
+                case CHUNK_BITMAP:
+                {
+                    uint64_t *w     = &static_cast<uint64_t *>(c->data)[low >> 6];
+                    uint64_t mask   = uint64_t(1) << (low & 0x3f);
+                    *prev           = *w & mask;
+                    if (!(*prev))
+                    {
+                        *w             |= mask;
+                        ++c->count;
+                    }
+                    return true;
+                }
+
+                case CHUNK_RUN:
+                {
+                    run_t *r        = static_cast<run_t *>(c->data);
+                    ssize_t i       = run_search(r, c->size, low);
+                    if ((i >= 0) && (low <= size_t(r[i].start + r[i].length)))
+                    {
+                        *prev           = true;
+                        return true;
+                    }
+
+                    bool ext_prev   = (i >= 0) && (size_t(r[i].start + r[i].length + 1) == low);
+                    bool ext_next   = (size_t(i + 1) < c->size) && (r[i + 1].start == low + 1);
+
+                    if ((ext_prev) && (ext_next))
+                    {
+                        // Merge two runs
+                        r[i].length    += r[i + 1].length + 2;
+                        ::memmove(&r[i + 1], &r[i + 2], (c->size - i - 2) * sizeof(run_t));
+                        --c->size;
+                    }
+                    else if (ext_prev)
+                        ++r[i].length;
+                    else if (ext_next)
+                    {
+                        --r[i + 1].start;
+                        ++r[i + 1].length;
+                    }
+                    else
+                    {
+                        // Insert new run
+                        if (!chunk_reserve(c, c->size + 1, sizeof(run_t)))
+                            return false;
+
+                        r               = static_cast<run_t *>(c->data);
+                        ::memmove(&r[i + 2], &r[i + 1], (c->size - i - 1) * sizeof(run_t));
+                        r[i + 1].start  = low;
+                        r[i + 1].length = 0;
+                        ++c->size;
+                    }
+
+                    ++c->count;
+                    if (run_oversized(c))
+                        reencode(c);
+                    return true;
+                }
+
+                default:
+                    break;
+            }
+
+            return false;
+        }
+
+        bool sparse_bitset::chunk_remove(chunk_t *c, size_t low, bool *prev)
+        {
+            *prev       = false;
+
+            switch (c->type)
+            {
+                case CHUNK_ARRAY:
+                {
+                    uint16_t *a     = static_cast<uint16_t *>(c->data);
+                    size_t i        = array_search(a, c->size, low);
+                    if ((i >= c->size) || (a[i] != low))
+                        return true;
+
+                    *prev           = true;
+                    ::memmove(&a[i], &a[i + 1], (c->size - i - 1) * sizeof(uint16_t));
+                    --c->size;
+                    --c->count;
+                    return true;
+                }
+
+                case CHUNK_BITMAP:
+                {
+                    uint64_t *w     = &static_cast<uint64_t *>(c->data)[low >> 6];
+                    uint64_t mask   = uint64_t(1) << (low & 0x3f);
+                    *prev           = *w & mask;
+                    if (!(*prev))
+                        return true;
+
+                    *w             &= ~mask;
+                    --c->count;
+
+                    // Convert to array if it requires less memory, keep bitmap if there is no memory
+                    if (c->count <= sparse_array_max)
+                        from_bitmap(c, static_cast<uint64_t *>(c->data));
+                    return true;
+                }
+
+                case CHUNK_RUN:
+                {
+                    run_t *r        = static_cast<run_t *>(c->data);
+                    ssize_t i       = run_search(r, c->size, low);
+                    if ((i < 0) || (low > size_t(r[i].start + r[i].length)))
+                        return true;
+
+                    size_t start    = r[i].start;
+                    size_t end      = start + r[i].length;
+
+                    if (start == end)
+                    {
+                        // Remove run
+                        ::memmove(&r[i], &r[i + 1], (c->size - i - 1) * sizeof(run_t));
+                        --c->size;
+                    }
+                    else if (low == start)
+                    {
+                        ++r[i].start;
+                        --r[i].length;
+                    }
+                    else if (low == end)
+                        --r[i].length;
+                    else
+                    {
+                        // Split run
+                        if (!chunk_reserve(c, c->size + 1, sizeof(run_t)))
+                            return false;
+
+                        r               = static_cast<run_t *>(c->data);
+                        ::memmove(&r[i + 2], &r[i + 1], (c->size - i - 1) * sizeof(run_t));
+                        r[i].length     = low - start - 1;
+                        r[i + 1].start  = low + 1;
+                        r[i + 1].length = end - low - 1;
+                        ++c->size;
+                    }
+
+                    *prev           = true;
+                    --c->count;
+                    if ((c->count > 0) && (run_oversized(c)))
+                        reencode(c);
+                    return true;
+                }
+
+                default:
+                    break;
+            }
+
+            return false;
+        }
+
+        ssize_t sparse_bitset::chunk_find(const chunk_t *c, size_t low)
+        {
+            switch (c->type)
+            {
+                case CHUNK_ARRAY:
+                {
+                    const uint16_t *a = static_cast<const uint16_t *>(c->data);
+                    size_t i        = array_search(a, c->size, low);
+                    return (i < c->size) ? a[i] : -1;
+                }
+
+                case CHUNK_BITMAP:
+                {
+                    size_t pos      = bitmap_next(static_cast<const uint64_t *>(c->data), low, 0);
+                    return (pos < sparse_chunk_bits) ? pos : -1;
+                }
+
+                case CHUNK_RUN:
+                {
+                    const run_t *r  = static_cast<const run_t *>(c->data);
+                    ssize_t i       = run_search(r, c->size, low);
+                    if ((i >= 0) && (low <= size_t(r[i].start + r[i].length)))
+                        return low;
+                    return (size_t(i + 1) < c->size) ? r[i + 1].start : -1;
+                }
+
+                default:
+                    break;
+            }
+
+            return -1;
+        }
+
+        bool sparse_bitset::chunk_fill(chunk_t *c)
+        {
+            run_t *r    = static_cast<run_t *>(::malloc(sizeof(run_t)));
+            if (r == NULL)
+                return false;
+
+            r->start    = 0;
+            r->length   = sparse_chunk_bits - 1;
+
+            chunk_free(c);
+            c->type     = CHUNK_RUN;
+            c->count    = sparse_chunk_bits;
+            c->size     = 1;
+            c->cap      = 1;
+            c->data     = r;
+
+            return true;
+        }
+
+        bool sparse_bitset::chunk_clone(chunk_t *dst, const chunk_t *src)
+        {
+            size_t items    = (src->type == CHUNK_BITMAP) ? sparse_bitmap_words : src->size;
+            size_t bytes    = items * item_size(src->type);
+            void *data      = ::malloc(bytes);
+            if (data == NULL)
+                return false;
+
+            ::memcpy(data, src->data, bytes);
+            *dst            = *src;
+            dst->cap        = src->size;
+            dst->data       = data;
+
+            return true;
+        }
+
+        bool sparse_bitset::chunk_combine(chunk_t *c, const chunk_t *src, bit_op_t op, uint64_t *tmp)
+        {
+            // Fast paths for array containers
+            switch (op)
+            {
+                case OP_AND:
+                case OP_ANDNOT:
+                    if (c->type == CHUNK_ARRAY)
+                    {
+                        uint16_t *a     = static_cast<uint16_t *>(c->data);
+                        bool keep       = op == OP_AND;
+                        size_t n        = 0;
+                        for (size_t i=0; i<c->size; ++i)
+                        {
+                            if (chunk_get(src, a[i]) == keep)
+                                a[n++]          = a[i];
+                        }
+                        c->size         = n;
+                        c->count        = n;
+                        return true;
+                    }
+                    else if ((op == OP_AND) && (src->type == CHUNK_ARRAY))
+                    {
+                        chunk_t t;
+                        t.key           = c->key;
+                        t.type          = CHUNK_ARRAY;
+                        t.count         = 0;
+                        t.size          = 0;
+                        t.cap           = 0;
+                        t.data          = NULL;
+                        if (!chunk_reserve(&t, src->size, sizeof(uint16_t)))
+                            return false;
+
+                        const uint16_t *s = static_cast<const uint16_t *>(src->data);
+                        uint16_t *a     = static_cast<uint16_t *>(t.data);
+                        for (size_t i=0; i<src->size; ++i)
+                        {
+                            if (chunk_get(c, s[i]))
+                                a[t.size++]     = s[i];
+                        }
+                        t.count         = t.size;
+
+                        chunk_free(c);
+                        *c              = t;
+                        return true;
+                    }
+                    break;
+
+                case OP_OR:
+                    if ((c->type == CHUNK_ARRAY) && (src->type == CHUNK_ARRAY) &&
+                        (c->size + src->size <= sparse_array_max))
+                    {
+                        size_t cap      = c->size + src->size;
+                        uint16_t *a     = static_cast<uint16_t *>(::malloc(cap * sizeof(uint16_t)));
+                        if (a == NULL)
+                            return false;
+
+                        const uint16_t *x = static_cast<const uint16_t *>(c->data);
+                        const uint16_t *y = static_cast<const uint16_t *>(src->data);
+                        size_t i = 0, j = 0, n = 0;
+                        while ((i < c->size) && (j < src->size))
+                        {
+                            if (x[i] < y[j])
+                                a[n++]          = x[i++];
+                            else if (x[i] > y[j])
+                                a[n++]          = y[j++];
+                            else
+                            {
+                                a[n++]          = x[i++];
+                                ++j;
+                            }
+                        }
+                        while (i < c->size)
+                            a[n++]          = x[i++];
+                        while (j < src->size)
+                            a[n++]          = y[j++];
+
+                        chunk_free(c);
+                        c->data         = a;
+                        c->count        = n;
+                        c->size         = n;
+                        c->cap          = cap;
+                        return true;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+
+            // Generic path: perform operation on bitmaps
+            uint64_t *a     = tmp;
+            uint64_t *b     = &tmp[sparse_bitmap_words];
+            to_bitmap(a, c);
+            to_bitmap(b, src);
+
+            switch (op)
+            {
+                case OP_AND:
+                    for (size_t i=0; i<sparse_bitmap_words; ++i)
+                        a[i]       &= b[i];
+                    break;
+                case OP_OR:
+                    for (size_t i=0; i<sparse_bitmap_words; ++i)
+                        a[i]       |= b[i];
+                    break;
+                case OP_XOR:
+                    for (size_t i=0; i<sparse_bitmap_words; ++i)
+                        a[i]       ^= b[i];
+                    break;
+                case OP_ANDNOT:
+                    for (size_t i=0; i<sparse_bitmap_words; ++i)
+                        a[i]       &= ~b[i];
+                    break;
+                default:
+                    break;
+            }
+
+            return from_bitmap(c, a);
+        }
+
+        size_t sparse_bitset::find_chunk(size_t key) const
+        {
+            size_t first = 0, last = nChunks;
+            while (first < last)
+            {
+                size_t mid  = (first + last) >> 1;
+                if (vChunks[mid].key < key)
+                    first       = mid + 1;
+                else
+                    last        = mid;
+            }
+            return first;
+        }
+
+        sparse_bitset::chunk_t *sparse_bitset::insert_chunk(size_t pos, size_t key)
+        {
+            if (nChunks >= nCapacity)
+            {
+                size_t cap      = (nCapacity > 0) ? nCapacity << 1 : sparse_min_chunks;
+                chunk_t *v      = static_cast<chunk_t *>(::realloc(vChunks, cap * sizeof(chunk_t)));
+                if (v == NULL)
+                    return NULL;
+
+                vChunks         = v;
+                nCapacity       = cap;
+            }
+
+            chunk_t *c      = &vChunks[pos];
+            ::memmove(&c[1], c, (nChunks - pos) * sizeof(chunk_t));
+            ++nChunks;
+
+            c->key          = key;
+            c->type         = CHUNK_ARRAY;
+            c->count        = 0;
+            c->size         = 0;
+            c->cap          = 0;
+            c->data         = NULL;
+
+            return c;
+        }
+
+        void sparse_bitset::remove_chunk(size_t pos)
+        {
+            chunk_free(&vChunks[pos]);
+            ::memmove(&vChunks[pos], &vChunks[pos + 1], (nChunks - pos - 1) * sizeof(chunk_t));
+            --nChunks;
+        }
+
+        bool sparse_bitset::truncate(size_t size)
+        {
+            // Remove chunks which are completely out of range
+            size_t keys     = (size + sparse_chunk_mask) >> sparse_chunk_shift;
+            size_t pos      = find_chunk(keys);
+            for (size_t i=pos; i<nChunks; ++i)
+                chunk_free(&vChunks[i]);
+            nChunks         = pos;
+
+            // Clear the tail of the last chunk
+            size_t tail     = size & sparse_chunk_mask;
+            if ((tail == 0) || (nChunks <= 0))
+                return true;
+
+            chunk_t *c      = &vChunks[nChunks - 1];
+            if ((c->key != (size >> sparse_chunk_shift)) || (chunk_find(c, tail) < 0))
+                return true;
+
+            uint64_t *tmp   = static_cast<uint64_t *>(::malloc(sparse_bitmap_bytes));
+            if (tmp == NULL)
+                return false;
+            lsp_finally { ::free(tmp); };
+
+            to_bitmap(tmp, c);
+            bitmap_range(tmp, tail, sparse_chunk_mask, false, false);
+            if (!from_bitmap(c, tmp))
+                return false;
+            if (c->count <= 0)
+                remove_chunk(nChunks - 1);
+
+            return true;
+        }
+
+        void sparse_bitset::flush()
+        {
+            if (vChunks != NULL)
+            {
+                for (size_t i=0; i<nChunks; ++i)
+                    chunk_free(&vChunks[i]);
+                ::free(vChunks);
+                vChunks     = NULL;
+            }
+
+            nSize       = 0;
+            nChunks     = 0;
+            nCapacity   = 0;
+        }
+
+        void sparse_bitset::clear()
+        {
+            truncate(0);
+            nSize       = 0;
+        }
+
+        bool sparse_bitset::resize(size_t size)
+        {
+            if (size == 0)
+            {
+                flush();
+                return true;
+            }
+
+            if ((size < nSize) && (!truncate(size)))
+                return false;
+
+            nSize       = size;
+            return true;
+        }
+
+        bool sparse_bitset::optimize()
+        {
+            for (size_t i=0; i<nChunks; ++i)
+            {
+                if (!reencode(&vChunks[i]))
+                    return false;
+            }
+            return true;
+        }
+
+        size_t sparse_bitset::capacity() const
+        {
+            size_t bytes    = nCapacity * sizeof(chunk_t);
+            for (size_t i=0; i<nChunks; ++i)
+            {
+                const chunk_t *c    = &vChunks[i];
+                bytes          += (c->type == CHUNK_BITMAP) ? sparse_bitmap_bytes : c->cap * item_size(c->type);
+            }
+            return bytes;
+        }
+
+        size_t sparse_bitset::count() const
+        {
+            size_t count    = 0;
+            for (size_t i=0; i<nChunks; ++i)
+                count          += vChunks[i].count;
+            return count;
+        }
+
+        ssize_t sparse_bitset::find(size_t index) const
+        {
+            if (index >= nSize)
+                return -1;
+
+            size_t key      = index >> sparse_chunk_shift;
+            for (size_t pos = find_chunk(key); pos < nChunks; ++pos)
+            {
+                const chunk_t *c    = &vChunks[pos];
+                size_t low          = (c->key == key) ? index & sparse_chunk_mask : 0;
+                ssize_t bit         = chunk_find(c, low);
+                if (bit >= 0)
+                {
+                    index               = (c->key << sparse_chunk_shift) + bit;
+                    return (index < nSize) ? index : -1;
+                }
+            }
+
+            return -1;
+        }
+
+        bool sparse_bitset::get(size_t index) const
+        {
+            if (index >= nSize)
+                return false;
+
+            size_t key      = index >> sparse_chunk_shift;
+            size_t pos      = find_chunk(key);
+            if ((pos >= nChunks) || (vChunks[pos].key != key))
+                return false;
+
+            return chunk_get(&vChunks[pos], index & sparse_chunk_mask);
+        }
+
+        bool sparse_bitset::bit_op(size_t index, bit_op_t op)
+        {
+            if (index >= nSize)
+                return false;
+
+            size_t key      = index >> sparse_chunk_shift;
+            size_t low      = index & sparse_chunk_mask;
+            size_t pos      = find_chunk(key);
+            bool prev       = false;
+
+            // Create new chunk if required
+            if ((pos >= nChunks) || (vChunks[pos].key != key))
+            {
+                if (op == OP_UNSET)
+                    return false;
+
+                chunk_t *c      = insert_chunk(pos, key);
+                if (c == NULL)
+                    return false;
+                if (!chunk_add(c, low, &prev))
+                    remove_chunk(pos);
+                return false;
+            }
+
+            // Modify existing chunk
+            chunk_t *c      = &vChunks[pos];
+            switch (op)
+            {
+                case OP_SET:
+                    chunk_add(c, low, &prev);
+                    break;
+                case OP_UNSET:
+                    chunk_remove(c, low, &prev);
+                    break;
+                case OP_TOGGLE:
+                    if (chunk_get(c, low))
+                        chunk_remove(c, low, &prev);
+                    else
+                        chunk_add(c, low, &prev);
+                    break;
+                default:
+                    break;
+            }
+
+            if (c->count <= 0)
+                remove_chunk(pos);
+
+            return prev;
+        }
+
+        size_t sparse_bitset::range_op(size_t index, size_t count, bit_op_t op)
+        {
+            if (index >= nSize)
+                return 0;
+            if ((index + count) > nSize)
+                count           = nSize - index;
+            if (count == 0)
+                return 0;
+
+            uint64_t *tmp   = NULL;
+            lsp_finally {
+                if (tmp != NULL)
+                    ::free(tmp);
+            };
+
+            size_t last     = index + count - 1;
+            size_t fkey     = index >> sparse_chunk_shift;
+            size_t lkey     = last >> sparse_chunk_shift;
+
+            for (size_t key = fkey; key <= lkey; ++key)
+            {
+                size_t lo       = (key == fkey) ? index & sparse_chunk_mask : 0;
+                size_t hi       = (key == lkey) ? last & sparse_chunk_mask : sparse_chunk_mask;
+                size_t pos      = find_chunk(key);
+                bool exists     = (pos < nChunks) && (vChunks[pos].key == key);
+                bool full       = (lo == 0) && (hi == sparse_chunk_mask);
+
+                if (op == OP_UNSET)
+                {
+                    // Skip missing chunks
+                    if (!exists)
+                    {
+                        if (pos >= nChunks)
+                            break;
+                        key             = vChunks[pos].key - 1;
+                        continue;
+                    }
+                    else if (full)
+                    {
+                        remove_chunk(pos);
+                        continue;
+                    }
+                }
+
+                chunk_t *c      = (exists) ? &vChunks[pos] : insert_chunk(pos, key);
+                if (c == NULL)
+                    return (key << sparse_chunk_shift) + lo - index;
+
+                // Fill the whole chunk
+                if ((full) && ((op == OP_SET) || (c->count <= 0)))
+                {
+                    if (!chunk_fill(c))
+                    {
+                        if (c->count <= 0)
+                            remove_chunk(pos);
+                        return (key << sparse_chunk_shift) + lo - index;
+                    }
+                    continue;
+                }
+
+                // Modify the part of chunk
+                if (tmp == NULL)
+                    tmp             = static_cast<uint64_t *>(::malloc(sparse_bitmap_bytes));
+                if (tmp != NULL)
+                {
+                    to_bitmap(tmp, c);
+                    bitmap_range(tmp, lo, hi, op == OP_SET, op == OP_TOGGLE);
+                }
+                if ((tmp == NULL) || (!from_bitmap(c, tmp)))
+                {
+                    if (c->count <= 0)
+                        remove_chunk(pos);
+                    return (key << sparse_chunk_shift) + lo - index;
+                }
+                if (c->count <= 0)
+                    remove_chunk(pos);
+            }
+
+            return count;
+        }
+
+        bool sparse_bitset::bulk_op(const sparse_bitset *src, bit_op_t op)
+        {
+            if (src == this)
+            {
+                if ((op == OP_XOR) || (op == OP_ANDNOT))
+                    unset_all();
+                return true;
+            }
+
+            size_t total    = nChunks + src->nChunks;
+            if (total <= 0)
+                return true;
+
+            uint64_t *tmp   = static_cast<uint64_t *>(::malloc(sparse_bitmap_bytes * 2));
+            if (tmp == NULL)
+                return false;
+            lsp_finally { ::free(tmp); };
+
+            chunk_t *dst    = static_cast<chunk_t *>(::malloc(total * sizeof(chunk_t)));
+            if (dst == NULL)
+                return false;
+
+            // Merge sorted lists of chunks, ignore chunks of source out of range
+            size_t keys     = (nSize + sparse_chunk_mask) >> sparse_chunk_shift;
+            size_t i = 0, j = 0, n = 0;
+            bool res        = true;
+            while (true)
+            {
+                chunk_t *a          = (i < nChunks) ? &vChunks[i] : NULL;
+                const chunk_t *b    = (j < src->nChunks) ? &src->vChunks[j] : NULL;
+                if ((b != NULL) && (b->key >= keys))
+                    b                   = NULL;
+                if ((a == NULL) && (b == NULL))
+                    break;
+
+                if ((a != NULL) && ((b == NULL) || (a->key < b->key)))
+                {
+                    // Chunk is present only in this bitset
+                    if (op == OP_AND)
+                        chunk_free(a);
+                    else
+                        dst[n++]            = *a;
+                    ++i;
+                }
+                else if ((a == NULL) || (b->key < a->key))
+                {
+                    // Chunk is present only in source bitset
+                    if ((res) && ((op == OP_OR) || (op == OP_XOR)))
+                    {
+                        if (chunk_clone(&dst[n], b))
+                            ++n;
+                        else
+                            res                 = false;
+                    }
+                    ++j;
+                }
+                else
+                {
+                    // Chunk is present in both bitsets
+                    if (res)
+                        res                 = chunk_combine(a, b, op, tmp);
+                    if (a->count > 0)
+                        dst[n++]            = *a;
+                    else
+                        chunk_free(a);
+                    ++i;
+                    ++j;
+                }
+            }
+
+            // Replace chunks
+            if (vChunks != NULL)
+                ::free(vChunks);
+            vChunks         = dst;
+            nChunks         = n;
+            nCapacity       = total;
+
+            // Source bitset may have bits out of range in the last chunk
+            if ((op == OP_OR) || (op == OP_XOR))
+                res             = truncate(nSize) && res;
+
+            return res;
+        }
+
+        void sparse_bitset::set_all()
+        {
+            truncate(0);
+            range_op(0, nSize, OP_SET);
+        }
+
+        bool sparse_bitset::set(size_t index)
+        {
+            return bit_op(index, OP_SET);
+        }
+
+        bool sparse_bitset::set(size_t index, bool value)
+        {
+            return bit_op(index, (value) ? OP_SET : OP_UNSET);
+        }
+
+        size_t sparse_bitset::set(size_t index, size_t count)
+        {
+            return range_op(index, count, OP_SET);
+        }
+
+        size_t sparse_bitset::set(size_t index, size_t count, const bool *values)
+        {
+            if (index >= nSize)
+                return 0;
+            if ((index + count) > nSize)
+                count           = nSize - index;
+
+            for (size_t i=0; i<count; ++i)
+                bit_op(index + i, (values[i]) ? OP_SET : OP_UNSET);
+
+            return count;
+        }
+
+        void sparse_bitset::unset_all()
+        {
+            truncate(0);
+        }
+
+        bool sparse_bitset::unset(size_t index)
+        {
+            return bit_op(index, OP_UNSET);
+        }
+
+        size_t sparse_bitset::unset(size_t index, size_t count)
+        {
+            return range_op(index, count, OP_UNSET);
+        }
+
+        void sparse_bitset::toggle_all()
+        {
+            range_op(0, nSize, OP_TOGGLE);
+        }
+
+        bool sparse_bitset::toggle(size_t index)
+        {
+            return bit_op(index, OP_TOGGLE);
+        }
+
+        size_t sparse_bitset::toggle(size_t index, size_t count)
+        {
+            return range_op(index, count, OP_TOGGLE);
+        }
+
+        bool sparse_bitset::bitwise_and(const sparse_bitset *src)
+        {
+            return bulk_op(src, OP_AND);
+        }
+
+        bool sparse_bitset::bitwise_or(const sparse_bitset *src)
+        {
+            return bulk_op(src, OP_OR);
+        }
+
+        bool sparse_bitset::bitwise_xor(const sparse_bitset *src)
+        {
+            return bulk_op(src, OP_XOR);
+        }
+
+        bool sparse_bitset::bitwise_andnot(const sparse_bitset *src)
+        {
+            return bulk_op(src, OP_ANDNOT);
+        }
+
+        void sparse_bitset::swap(sparse_bitset *dst)
+        {
+            lsp::swap(nSize, dst->nSize);
+            lsp::swap(nChunks, dst->nChunks);
+            lsp::swap(nCapacity, dst->nCapacity);
+            lsp::swap(vChunks, dst->vChunks);
+        }
+
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/spsc_queue.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        void raw_spsc_queue::init(size_t n_sizeof, size_t chunk_capacity)
+        {
+            pHead           = NULL;
+            nPopped         = 0;
+            pTail           = NULL;
+            pFirst          = NULL;
+            pHeadCopy       = NULL;
+            pUnused         = NULL;
+            nPushed         = 0;
+            nChunks         = 0;
+            nUnused         = 0;
+            nSizeOf         = n_sizeof;
+            nChunkSize      = lsp_max(chunk_capacity, size_t(1));
+        }
+
+        void raw_spsc_queue::free_chunk_list(chunk_t *head)
+        {
+            for (chunk_t *curr = head; curr != NULL; )
+            {
+                chunk_t * const next = curr->pNext;
+                free(curr);
+                curr = next;
+            }
+        }
+
+        void raw_spsc_queue::flush()
+        {
+            // All chunks starting with the first recycled one are linked into the list
+            free_chunk_list(pFirst);
+            free_chunk_list(pUnused);
+
+            pHead           = NULL;
+            nPopped         = 0;
+            pTail           = NULL;
+            pFirst          = NULL;
+            pHeadCopy       = NULL;
+            pUnused         = NULL;
+            nPushed         = 0;
+            nChunks         = 0;
+            nUnused         = 0;
+        }
+
+        raw_spsc_queue::chunk_t *raw_spsc_queue::alloc_chunk()
+        {
+            chunk_t *chunk          = static_cast<chunk_t *>(malloc(sizeof(chunk_t) + nChunkSize * nSizeOf));
+            if (chunk == NULL)
+                return chunk;
+
+            ++nChunks;
+            return chunk;
+        }
+
+        raw_spsc_queue::chunk_t *raw_spsc_queue::acquire_chunk()
+        {
+            chunk_t *chunk          = pUnused;
+            if (chunk != NULL)
+            {
+                // Use reserved chunk
+                pUnused                 = chunk->pNext;
+                --nUnused;
+            }
+            else
+            {
+                // Use chunk already read by consumer
+                if (pFirst == pHeadCopy)
+                    pHeadCopy               = atomic_load(&pHead);
+
+                if (pFirst != pHeadCopy)
+                {
+                    chunk                   = pFirst;
+                    pFirst                  = chunk->pNext;
+                }
+                else if ((chunk = alloc_chunk()) == NULL)
+                    return NULL;
+            }
+
+            chunk->pPrev            = NULL;
+            chunk->pNext            = NULL;
+            chunk->nHead            = 0;
+            chunk->nTail            = 0;
+
+            return chunk;
+        }
+
+        void raw_spsc_queue::release_chunks(chunk_t *list)
+        {
+            while (list != NULL)
+            {
+                chunk_t * const next    = list->pNext;
+                list->pNext             = pUnused;
+                pUnused                 = list;
+                ++nUnused;
+                list                    = next;
+            }
+        }
+
+        bool raw_spsc_queue::reserve(size_t capacity)
+        {
+            // One extra chunk is required because consumer and producer may work with different chunks
+            const size_t n_chunks   = (capacity + nChunkSize - 1) / nChunkSize + 1;
+            while (nChunks < n_chunks)
+            {
+                chunk_t *chunk          = alloc_chunk();
+                if (chunk == NULL)
+                    return false;
+
+                chunk->pNext            = pUnused;
+                pUnused                 = chunk;
+                ++nUnused;
+            }
+
+            return true;
+        }
+
+        bool raw_spsc_queue::push_back(const void *data)
+        {
+            chunk_t * const tail    = pTail;
+            const size_t pos        = (tail != NULL) ? tail->nTail : nChunkSize;
+
+            // Check that tail chunk has place to store data
+            if (pos < nChunkSize)
+            {
+                memcpy(&tail->vData[pos * nSizeOf], data, nSizeOf);
+                atomic_store(&nPushed, nPushed + 1);
+                atomic_store(&tail->nTail, pos + 1);
+                return true;
+            }
+
+            // Fill new chunk and publish it
+            chunk_t * const chunk   = acquire_chunk();
+            if (chunk == NULL)
+                return false;
+
+            memcpy(chunk->vData, data, nSizeOf);
+            chunk->nTail            = 1;
+            atomic_store(&nPushed, nPushed + 1);
+
+            if (tail == NULL)
+            {
+                pFirst                  = chunk;
+                pHeadCopy               = chunk;
+                atomic_store(&pHead, chunk);
+            }
+            else
+                atomic_store(&tail->pNext, chunk);
+            pTail                   = chunk;
+
+            return true;
+        }
+
+        bool raw_spsc_queue::push_back(const void *data, size_t count)
+        {
+            if (count <= 0)
+                return true;
+
+            chunk_t * const tail    = pTail;
+            const size_t pos        = (tail != NULL) ? tail->nTail : nChunkSize;
+            const uint8_t *src      = static_cast<const uint8_t *>(data);
+            size_t to_copy          = lsp_min(count, nChunkSize - pos);
+
+            // Acquire all required chunks before publishing any data
+            chunk_t *first          = NULL;
+            chunk_t *last           = NULL;
+            for (size_t rest = count - to_copy; rest > 0; )
+            {
+                chunk_t * const chunk   = acquire_chunk();
+                if (chunk == NULL)
+                {
+                    release_chunks(first);
+                    return false;
+                }
+
+                if (last != NULL)
+                    last->pNext             = chunk;
+                else
+                    first                   = chunk;
+                last                    = chunk;
+                rest                   -= lsp_min(rest, nChunkSize);
+            }
+
+            atomic_store(&nPushed, nPushed + count);
+
+            // Fill the tail chunk
+            if (to_copy > 0)
+            {
+                memcpy(&tail->vData[pos * nSizeOf], src, to_copy * nSizeOf);
+                atomic_store(&tail->nTail, pos + to_copy);
+                src                    += to_copy * nSizeOf;
+                count                  -= to_copy;
+            }
+            if (first == NULL)
+                return true;
+
+            // Fill new chunks and publish them
+            for (chunk_t *chunk = first; chunk != NULL; chunk = chunk->pNext)
+            {
+                to_copy                 = lsp_min(count, nChunkSize);
+                memcpy(chunk->vData, src, to_copy * nSizeOf);
+                chunk->nTail            = to_copy;
+                src                    += to_copy * nSizeOf;
+                count                  -= to_copy;
+            }
+
+            if (tail == NULL)
+            {
+                pFirst                  = first;
+                pHeadCopy               = first;
+                atomic_store(&pHead, first);
+            }
+            else
+                atomic_store(&tail->pNext, first);
+            pTail                   = last;
+
+            return true;
+        }
+
+        bool raw_spsc_queue::pop_front(void *data)
+        {
+            chunk_t *head           = atomic_load(&pHead);
+            if (head == NULL)
+                return false;
+
+            // Move to the next chunk if current one has been read
+            size_t pos              = head->nHead;
+            if (pos >= nChunkSize)
+            {
+                chunk_t * const next    = atomic_load(&head->pNext);
+                if (next == NULL)
+                    return false;
+
+                atomic_store(&pHead, next);
+                head                    = next;
+                pos                     = 0;
+            }
+
+            if (pos >= atomic_load(&head->nTail))
+                return false;
+
+            memcpy(data, &head->vData[pos * nSizeOf], nSizeOf);
+            head->nHead             = pos + 1;
+            atomic_store(&nPopped, nPopped + 1);
+
+            return true;
+        }
+
+        size_t raw_spsc_queue::pop_front(void *data, size_t count)
+        {
+            chunk_t *head           = atomic_load(&pHead);
+            if (head == NULL)
+                return 0;
+
+            uint8_t *dst            = static_cast<uint8_t *>(data);
+            size_t done             = 0;
+
+            while (done < count)
+            {
+                // Move to the next chunk if current one has been read
+                const size_t pos        = head->nHead;
+                if (pos >= nChunkSize)
+                {
+                    chunk_t * const next    = atomic_load(&head->pNext);
+                    if (next == NULL)
+                        break;
+
+                    atomic_store(&pHead, next);
+                    head                    = next;
+                    continue;
+                }
+
+                const size_t avail      = atomic_load(&head->nTail) - pos;
+                if (avail <= 0)
+                    break;
+
+                const size_t to_copy    = lsp_min(avail, count - done);
+                memcpy(dst, &head->vData[pos * nSizeOf], to_copy * nSizeOf);
+                head->nHead             = pos + to_copy;
+                dst                    += to_copy * nSizeOf;
+                done                   += to_copy;
+            }
+
+            if (done > 0)
+                atomic_store(&nPopped, nPopped + done);
+
+            return done;
+        }
+
+        size_t raw_spsc_queue::size() const
+        {
+            // Producer increments the counter before publishing data, so read consumer's counter first
+            const size_t popped     = atomic_load(&nPopped);
+            const size_t pushed     = atomic_load(&nPushed);
+            return pushed - popped;
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -21,6 +21,7 @@
 
 #include <lsp-plug.in/lltl/state.h>
 #include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
 
 namespace lsp
 {
@@ -61,6 +62,86 @@ namespace lsp
         {
             for (size_t i=0; i<B_TOTAL; ++i)
                 bins[i]     = NULL;
+
+            active      = NULL;
+            retired     = NULL;
+            spare       = NULL;
+            deferred    = false;
+            atomic_init(spare_lock);
+        }
+
+        void *raw_state::unwrap(void *ptr) const
+        {
+            if ((!deferred) || (ptr == NULL))
+                return ptr;
+            return static_cast<garbage_t *>(ptr)->ptr;
+        }
+
+        bool raw_state::wrap(void **dst, void *ptr, bool alloc)
+        {
+            if ((!deferred) || (ptr == NULL))
+            {
+                *dst            = ptr;
+                return true;
+            }
+
+            // Take spare item, the list is modified only under the lock so there is no ABA problem
+            garbage_t *item = NULL;
+            if (atomic_trylock(spare_lock))
+            {
+                item            = atomic_load(&spare);
+                if (item != NULL)
+                    atomic_store(&spare, item->next);
+                atomic_unlock(spare_lock);
+            }
+
+            // Allocate new item if it is allowed
+            if (item == NULL)
+            {
+                if (!alloc)
+                    return false;
+                item            = static_cast<garbage_t *>(malloc(sizeof(garbage_t)));
+                if (item == NULL)
+                    return false;
+            }
+
+            item->next      = NULL;
+            item->ptr       = ptr;
+            *dst            = item;
+
+            return true;
+        }
+
+        void raw_state::dispose(void *ptr)
+        {
+            if (ptr == NULL)
+                return;
+            if (!deferred)
+            {
+                cleanup(ptr);
+                return;
+            }
+
+            // Move item to the garbage list
+            garbage_t *item = static_cast<garbage_t *>(ptr);
+            garbage_t *head;
+            do
+            {
+                head            = atomic_load(&retired);
+                item->next      = head;
+            } while (!atomic_cas(&retired, head, item));
+        }
+
+        void raw_state::recycle(garbage_t *item)
+        {
+            if (atomic_trylock(spare_lock))
+            {
+                item->next      = atomic_load(&spare);
+                atomic_store(&spare, item);
+                atomic_unlock(spare_lock);
+            }
+            else
+                free(item);
         }
 
         void raw_state::cleanup(void *garbage)
@@ -76,10 +157,28 @@ namespace lsp
 
         void raw_state::clear()
         {
+            atomic_store(&active, static_cast<void *>(NULL));
             for (size_t i=0; i<B_TOTAL; ++i)
             {
                 void *ptr = atomic_swap(&bins[i], NULL);
-                cleanup(ptr);
+                if ((deferred) && (ptr != NULL))
+                {
+                    garbage_t *item = static_cast<garbage_t *>(ptr);
+                    cleanup(item->ptr);
+                    free(item);
+                }
+                else
+                    cleanup(ptr);
+            }
+
+            collect();
+
+            // Drop all spare items
+            for (garbage_t *item = atomic_swap(&spare, static_cast<garbage_t *>(NULL)); item != NULL; )
+            {
+                garbage_t *next = item->next;
+                free(item);
+                item            = next;
             }
         }
 
@@ -89,6 +188,61 @@ namespace lsp
 
             deleter2    = NULL;
             deleter1    = NULL;
+            deferred    = false;
+        }
+
+        bool raw_state::set_deferred(bool defer)
+        {
+            if (deferred == defer)
+                return true;
+
+            for (size_t i=0; i<B_TOTAL; ++i)
+            {
+                if (atomic_load(&bins[i]) != NULL)
+                    return false;
+            }
+
+            collect();
+            deferred    = defer;
+
+            return true;
+        }
+
+        bool raw_state::reserve(size_t count)
+        {
+            for (size_t i=0; i<count; ++i)
+            {
+                garbage_t *item = static_cast<garbage_t *>(malloc(sizeof(garbage_t)));
+                if (item == NULL)
+                    return false;
+
+                // Do not lose the item if the list is currently locked
+                while (!atomic_trylock(spare_lock))
+                    /* nothing */ ;
+
+                item->next      = atomic_load(&spare);
+                atomic_store(&spare, item);
+                atomic_unlock(spare_lock);
+            }
+
+            return true;
+        }
+
+        size_t raw_state::collect()
+        {
+            size_t count    = 0;
+            garbage_t *list = atomic_swap(&retired, static_cast<garbage_t *>(NULL));
+
+            while (list != NULL)
+            {
+                garbage_t *next = list->next;
+                cleanup(list->ptr);
+                recycle(list);
+                list            = next;
+                ++count;
+            }
+
+            return count;
         }
 
         void raw_state::gc()
@@ -96,17 +250,27 @@ namespace lsp
             // Cleanup garbage
             void *garbage = atomic_swap(&bins[B_GARBAGE], NULL);
             cleanup(garbage);
+
+            if (deferred)
+                collect();
         }
 
-        void raw_state::push(void *new_state)
+        bool raw_state::push(void *new_state)
         {
+            // Wrap the state before any change
+            void *item;
+            if (!wrap(&item, new_state, true))
+                return false;
+
             // Cleanup garbage
             void *garbage = atomic_swap(&bins[B_GARBAGE], NULL);
             cleanup(garbage);
 
             // Replace pending state
-            garbage = atomic_swap(&bins[B_PENDING], new_state);
-            cleanup(garbage);
+            garbage = atomic_swap(&bins[B_PENDING], item);
+            dispose(garbage);
+
+            return true;
         }
 
         void *raw_state::pull()
@@ -118,34 +282,41 @@ namespace lsp
             // Ensure that state didn't change
             void *new_state = atomic_swap(&bins[B_PENDING], NULL);
             if (new_state == NULL)
-                return atomic_load(&bins[B_STATE]);
+                return atomic_load(&active);
 
             // Update state
-            garbage = atomic_swap(&bins[B_STATE], new_state);
-            cleanup(garbage);
+            void *ptr       = unwrap(new_state);
+            garbage         = atomic_swap(&bins[B_STATE], new_state);
+            atomic_store(&active, ptr);
+            dispose(garbage);
 
-            return new_state;
+            return ptr;
         }
 
         void *raw_state::get()
         {
             // Do not update state if garbage is not clean
             if (atomic_load(&bins[B_GARBAGE]) != NULL)
-                return atomic_load(&bins[B_STATE]);
+                return atomic_load(&active);
 
             // Read pending state
             void *new_state = atomic_swap(&bins[B_PENDING], NULL);
             if (new_state == NULL)
-                return atomic_load(&bins[B_STATE]);
+                return atomic_load(&active);
 
             // Replace old state with new one
+            void *ptr       = unwrap(new_state);
             void *garbage   = atomic_swap(&bins[B_STATE], new_state);
+            atomic_store(&active, ptr);
             if (garbage == NULL)
-                return new_state;
+                return ptr;
 
             // Push garbage to queue
-            atomic_swap(&bins[B_GARBAGE], garbage);
-            return new_state;
+            if (deferred)
+                dispose(garbage);
+            else
+                atomic_swap(&bins[B_GARBAGE], garbage);
+            return ptr;
         }
 
         bool raw_state::set(void *new_state)
@@ -154,19 +325,28 @@ namespace lsp
             if (atomic_load(&bins[B_GARBAGE]) != NULL)
                 return false;
 
+            // Wrap the state with the reserved item
+            void *item;
+            if (!wrap(&item, new_state, false))
+                return false;
+
             // Read pending state
-            void *garbage = atomic_swap(&bins[B_PENDING], new_state);
+            void *garbage = atomic_swap(&bins[B_PENDING], item);
             if (garbage == NULL)
                 return true;
 
             // Push garbage to queue
-            atomic_swap(&bins[B_GARBAGE], garbage);
+            if (deferred)
+                dispose(garbage);
+            else
+                atomic_swap(&bins[B_GARBAGE], garbage);
             return true;
         }
 
         void *raw_state::current() const
         {
-            return atomic_load(&bins[B_STATE]);
+            // Do not touch the item of B_STATE bin: it can be retired and recycled concurrently
+            return atomic_load(&active);
         }
 
         bool raw_state::pending() const
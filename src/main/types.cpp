@@ -19,7 +19,16 @@
  * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/stdlib/stdlib.h>
+
+#include <time.h>
+
+#ifndef PLATFORM_WINDOWS
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
 
 namespace lsp
 {
@@ -80,6 +89,205 @@ namespace lsp
             return hash;
         }
 
+        //---------------------------------------------------------------------
+        // Fast hash: 64-bit multiply-mix of the input words
+        static constexpr uint64_t fast_hash_p0      = 0xa0761d6478bd642fULL;
+        static constexpr uint64_t fast_hash_p1      = 0xe7037ed1a0b428dbULL;
+        static constexpr uint64_t fast_hash_p2      = 0x8ebc6af09c88c6e3ULL;
+        static constexpr uint64_t fast_hash_p3      = 0x589965cc75374cc3ULL;
+        static constexpr uint64_t fast_hash_seed    = 0x2d358dccaa6c78a5ULL;
+
+        static inline void fast_hash_mum(uint64_t *a, uint64_t *b)
+        {
+        #if defined(__SIZEOF_INT128__)
+            __uint128_t r   = __uint128_t(*a) * (*b);
+            *a              = uint64_t(r);
+            *b              = uint64_t(r >> 64);
+        #else
+            const uint64_t ha = *a >> 32, la = uint32_t(*a);
+            const uint64_t hb = *b >> 32, lb = uint32_t(*b);
+            const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+            const uint64_t t  = rl + (rm0 << 32);
+            uint64_t c        = (t < rl);
+            const uint64_t lo = t + (rm1 << 32);
+            c              += (lo < t);
+            *a              = lo;
+            *b              = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        #endif
+        }
+
+        static inline uint64_t fast_hash_mix(uint64_t a, uint64_t b)
+        {
+            fast_hash_mum(&a, &b);
+            return a ^ b;
+        }
+
+        static inline uint64_t fast_hash_r8(const uint8_t *p)
+        {
+            uint64_t v;
+            ::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        static inline uint64_t fast_hash_r4(const uint8_t *p)
+        {
+            uint32_t v;
+            ::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        static uint64_t fast_hash(const void *ptr, size_t size, uint64_t seed)
+        {
+            const uint8_t *p    = static_cast<const uint8_t *>(ptr);
+            uint64_t a, b;
+
+            if (size <= 16)
+            {
+                if (size >= 4)
+                {
+                    // Two overlapping pairs of 4-byte words cover the whole key
+                    const size_t off    = (size >> 3) << 2;
+                    a                   = (fast_hash_r4(p) << 32) | fast_hash_r4(p + off);
+                    b                   = (fast_hash_r4(p + size - 4) << 32) | fast_hash_r4(p + size - 4 - off);
+                }
+                else if (size > 0)
+                {
+                    a                   = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+                    b                   = 0;
+                }
+                else
+                    a = b = 0;
+            }
+            else
+            {
+                size_t i            = size;
+                if (i > 48)
+                {
+                    // Three independent lanes to keep the multiplier busy
+                    uint64_t s1         = seed;
+                    uint64_t s2         = seed;
+                    do
+                    {
+                        seed                = fast_hash_mix(fast_hash_r8(p) ^ fast_hash_p1, fast_hash_r8(p + 8) ^ seed);
+                        s1                  = fast_hash_mix(fast_hash_r8(p + 16) ^ fast_hash_p2, fast_hash_r8(p + 24) ^ s1);
+                        s2                  = fast_hash_mix(fast_hash_r8(p + 32) ^ fast_hash_p3, fast_hash_r8(p + 40) ^ s2);
+                        p                  += 48;
+                        i                  -= 48;
+                    } while (i > 48);
+                    seed               ^= s1 ^ s2;
+                }
+
+                for ( ; i > 16; i -= 16, p += 16)
+                    seed                = fast_hash_mix(fast_hash_r8(p) ^ fast_hash_p1, fast_hash_r8(p + 8) ^ seed);
+
+                // The last 16 bytes may overlap already processed data
+                a                   = fast_hash_r8(p + i - 16);
+                b                   = fast_hash_r8(p + i - 8);
+            }
+
+            a                  ^= fast_hash_p1;
+            b                  ^= seed;
+            fast_hash_mum(&a, &b);
+
+            return fast_hash_mix(a ^ fast_hash_p0 ^ size, b ^ fast_hash_p1);
+        }
+
+        static inline size_t fast_hash_fold(uint64_t hash)
+        {
+        #ifdef ARCH_64BIT
+            return size_t(hash);
+        #else
+            return size_t(hash ^ (hash >> 32));
+        #endif /* ARCH_64BIT */
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t fast_hash_func(const void *ptr, size_t size)
+        {
+            return fast_hash_fold(fast_hash(ptr, size, fast_hash_seed));
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t fast_char_hash_func(const void *ptr, size_t size)
+        {
+            const char *s = static_cast<const char *>(ptr);
+            return fast_hash_fold(fast_hash(s, ::strlen(s), fast_hash_seed));
+        }
+
+        static inline uint64_t fast_hash_mix_seed(uint64_t seed)
+        {
+            return seed ^ fast_hash_mix(seed ^ fast_hash_p0, fast_hash_p1);
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t fast_seeded_hash_func(const void *ptr, size_t size, uint64_t seed)
+        {
+            return fast_hash_fold(fast_hash(ptr, size, fast_hash_mix_seed(seed)));
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t fast_seeded_char_hash_func(const void *ptr, size_t size, uint64_t seed)
+        {
+            const char *s = static_cast<const char *>(ptr);
+            return fast_hash_fold(fast_hash(s, ::strlen(s), fast_hash_mix_seed(seed)));
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        size_t ptr_seeded_hash_func(const void *ptr, size_t size, uint64_t seed)
+        {
+            const uint64_t v    = uintptr_t(ptr);
+            return fast_hash_fold(fast_hash_mix(v ^ fast_hash_p1, fast_hash_mix_seed(seed) ^ fast_hash_p2));
+        }
+
+        //---------------------------------------------------------------------
+        // Random seeds for hash functions
+        static atomic_t     hash_seed_lock      = 1;
+        static uatomic_t    hash_seed_ready     = 0;
+        static uatomic_t    hash_seed_counter   = 0;
+        static uint64_t     hash_seed_base      = 0;
+
+        static uint64_t hash_seed_entropy()
+        {
+            uint64_t v          = 0;
+
+        #ifndef PLATFORM_WINDOWS
+            int fd              = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+            if (fd >= 0)
+            {
+                if (read(fd, &v, sizeof(v)) != ssize_t(sizeof(v)))
+                    v                   = 0;
+                close(fd);
+            }
+        #endif /* PLATFORM_WINDOWS */
+
+            // Mix in the current time and addresses randomized by the loader
+            v                  ^= fast_hash_mix(uint64_t(time(NULL)) ^ fast_hash_p0, uint64_t(clock()) ^ fast_hash_p1);
+            v                  ^= fast_hash_mix(uint64_t(uintptr_t(&v)) ^ fast_hash_p2, uint64_t(uintptr_t(&hash_seed_base)) ^ fast_hash_p3);
+
+            return v;
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        uint64_t make_hash_seed()
+        {
+            // Initialize the base seed of the process once
+            if (!atomic_load(&hash_seed_ready))
+            {
+                while (!atomic_trylock(hash_seed_lock))
+                    /* spin */ ;
+                if (!atomic_load(&hash_seed_ready))
+                {
+                    hash_seed_base      = hash_seed_entropy();
+                    atomic_store(&hash_seed_ready, 1);
+                }
+                atomic_unlock(hash_seed_lock);
+            }
+
+            // Derive unique seed from the base seed
+            const uint64_t index = atomic_add(&hash_seed_counter, 1);
+            return fast_hash_mix(hash_seed_base ^ fast_hash_p2, index ^ fast_hash_p3);
+        }
+
         LSP_LLTL_LIB_PUBLIC
         size_t ptr_hash_func(const void *ptr, size_t size)
         {
@@ -120,7 +328,282 @@ namespace lsp
         {
             return ::strdup(static_cast<const char *>(ptr));
         }
-    } /* namespace lltl */
-} /* namespace lsp */
 
+        LSP_LLTL_LIB_PUBLIC
+        uint64_t radix_key(const void *ptr, size_t size, radix_key_t type)
+        {
+            uint64_t v, sign;
 
+            switch (size)
+            {
+                case sizeof(uint8_t):
+                {
+                    uint8_t x;
+                    ::memcpy(&x, ptr, sizeof(x));
+                    v       = x;
+                    break;
+                }
+                case sizeof(uint16_t):
+                {
+                    uint16_t x;
+                    ::memcpy(&x, ptr, sizeof(x));
+                    v       = x;
+                    break;
+                }
+                case sizeof(uint32_t):
+                {
+                    uint32_t x;
+                    ::memcpy(&x, ptr, sizeof(x));
+                    v       = x;
+                    break;
+                }
+                default:
+                {
+                    uint64_t x;
+                    ::memcpy(&x, ptr, sizeof(x));
+                    v       = x;
+                    size    = sizeof(uint64_t);
+                    break;
+                }
+            }
+
+            sign    = uint64_t(1) << (size * 8 - 1);
+            switch (type)
+            {
+                case RADIX_SIGNED:
+                    // Flip the sign bit to make negative values precede positive ones
+                    return v ^ sign;
+                case RADIX_FLOAT:
+                    // Negative values should be inverted to reverse their order
+                    if (v & sign)
+                        return (size < sizeof(uint64_t)) ? v ^ ((sign << 1) - 1) : ~v;
+                    return v ^ sign;
+                default:
+                    break;
+            }
+
+            return v;
+        }
+
+        static void radix_insertion_sort(radix_item_t *items, size_t n)
+        {
+            for (size_t i=1; i<n; ++i)
+            {
+                radix_item_t x  = items[i];
+                size_t j        = i;
+                for ( ; (j > 0) && (items[j-1].key > x.key); --j)
+                    items[j]        = items[j-1];
+                items[j]        = x;
+            }
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        radix_item_t *radix_sort(radix_item_t *items, radix_item_t *tmp, size_t n, size_t size)
+        {
+            if (n <= 32)
+            {
+                radix_insertion_sort(items, n);
+                return items;
+            }
+
+            // Compute histograms for all bytes of the key at once
+            size_t hist[sizeof(uint64_t)][0x100];
+            size = lsp_min(size, sizeof(uint64_t));
+            ::memset(hist, 0, sizeof(hist[0]) * size);
+
+            for (size_t i=0; i<n; ++i)
+            {
+                uint64_t key    = items[i].key;
+                for (size_t j=0; j<size; ++j, key >>= 8)
+                    ++hist[j][key & 0xff];
+            }
+
+            // Perform passes
+            radix_item_t *src   = items;
+            radix_item_t *dst   = tmp;
+            for (size_t j=0; j<size; ++j)
+            {
+                size_t *h       = hist[j];
+                const size_t shift  = j * 8;
+
+                // Skip the pass if all items have the same byte
+                if (h[(src[0].key >> shift) & 0xff] == n)
+                    continue;
+
+                // Compute offsets
+                for (size_t k=0, offset=0; k<0x100; ++k)
+                {
+                    size_t count    = h[k];
+                    h[k]            = offset;
+                    offset         += count;
+                }
+
+                // Scatter items
+                for (size_t i=0; i<n; ++i)
+                {
+                    const radix_item_t *item = &src[i];
+                    dst[h[(item->key >> shift) & 0xff]++]   = *item;
+                }
+
+                lsp::swap(src, dst);
+            }
+
+            return src;
+        }
+
+        typedef struct parallel_sort_t
+        {
+            uint8_t        *src;        // Source data
+            uint8_t        *dst;        // Destination data
+            size_t          size;       // Size of element
+            const size_t   *bounds;     // Bounds of sorted runs
+            size_t          width;      // Number of chunks in each run being merged
+            size_t          parts;      // Number of parts each pair of runs is split to
+            sort_func_t     cmp;        // Comparison function
+            void           *arg;        // Argument of comparison function
+            bool            stable;     // Stable sort flag
+        } parallel_sort_t;
+
+        static void parallel_sort_chunk(void *arg, size_t index)
+        {
+            parallel_sort_t *ps = static_cast<parallel_sort_t *>(arg);
+            const size_t first  = ps->bounds[index];
+            const size_t count  = ps->bounds[index + 1] - first;
+
+            if (ps->stable)
+                lsp::ssort_r(&ps->src[first * ps->size], count, ps->size, ps->cmp, ps->arg);
+            else
+                lsp::qsort_r(&ps->src[first * ps->size], count, ps->size, ps->cmp, ps->arg);
+        }
+
+        /**
+         * Find number of elements taken from the run a when k first elements of the merged
+         * sequence of runs a and b are formed. Elements of a precede equal elements of b.
+         */
+        static size_t parallel_sort_corank(const parallel_sort_t *ps, size_t k, const uint8_t *a, size_t na, const uint8_t *b, size_t nb)
+        {
+            size_t lo   = (k > nb) ? k - nb : 0;
+            size_t hi   = lsp_min(k, na);
+
+            while (lo < hi)
+            {
+                const size_t i  = (lo + hi) >> 1;
+                const size_t j  = k - i;
+                if ((j > 0) && (ps->cmp(&a[i * ps->size], &b[(j - 1) * ps->size], ps->arg) <= 0))
+                    lo      = i + 1;
+                else
+                    hi      = i;
+            }
+
+            return lo;
+        }
+
+        static void parallel_sort_merge(void *arg, size_t index)
+        {
+            parallel_sort_t *ps = static_cast<parallel_sort_t *>(arg);
+            const size_t size   = ps->size;
+            const size_t pair   = index / ps->parts;
+            const size_t part   = index % ps->parts;
+
+            // Locate runs
+            const size_t *bounds= &ps->bounds[pair * ps->width * 2];
+            const size_t first  = bounds[0];
+            const size_t na     = bounds[ps->width] - first;
+            const size_t nb     = bounds[ps->width * 2] - bounds[ps->width];
+            const uint8_t *a    = &ps->src[first * size];
+            const uint8_t *b    = &a[na * size];
+
+            // Compute the part of merged sequence to produce
+            const size_t total  = na + nb;
+            const size_t k0     = (total * part) / ps->parts;
+            const size_t k1     = (total * (part + 1)) / ps->parts;
+            size_t i            = parallel_sort_corank(ps, k0, a, na, b, nb);
+            size_t j            = k0 - i;
+            const size_t ie     = parallel_sort_corank(ps, k1, a, na, b, nb);
+            const size_t je     = k1 - ie;
+
+            // Merge
+            uint8_t *dst        = &ps->dst[(first + k0) * size];
+            while ((i < ie) && (j < je))
+            {
+                const uint8_t *pa   = &a[i * size];
+                const uint8_t *pb   = &b[j * size];
+                if (ps->cmp(pb, pa, ps->arg) < 0)
+                {
+                    ::memcpy(dst, pb, size);
+                    ++j;
+                }
+                else
+                {
+                    ::memcpy(dst, pa, size);
+                    ++i;
+                }
+                dst        += size;
+            }
+            if (i < ie)
+            {
+                ::memcpy(dst, &a[i * size], (ie - i) * size);
+                dst        += (ie - i) * size;
+            }
+            if (j < je)
+                ::memcpy(dst, &b[j * size], (je - j) * size);
+        }
+
+        LSP_LLTL_LIB_PUBLIC
+        void parallel_sort(void *data, size_t n, size_t size, sort_func_t cmp, void *arg, bool stable, executor_iface *executor)
+        {
+            // Compute number of chunks, it should be power of two
+            size_t chunks   = 1;
+            if (executor != NULL)
+            {
+                while ((chunks < executor->workers) && ((chunks * 2 * raw_parallel_sort_chunk) <= n))
+                    chunks    <<= 1;
+            }
+
+            // Allocate buffer for bounds of runs and merging, bounds are stored first to keep them aligned
+            const size_t szof_bounds = align_size((chunks + 1) * sizeof(size_t), DEFAULT_ALIGN);
+            uint8_t *buf    = NULL;
+            if (chunks > 1)
+                buf             = static_cast<uint8_t *>(::malloc(szof_bounds + n * size));
+            if (buf == NULL)
+            {
+                if (stable)
+                    lsp::ssort_r(data, n, size, cmp, arg);
+                else
+                    lsp::qsort_r(data, n, size, cmp, arg);
+                return;
+            }
+            lsp_finally { ::free(buf); };
+
+            size_t *bounds  = reinterpret_cast<size_t *>(buf);
+            for (size_t i=0; i<=chunks; ++i)
+                bounds[i]       = (n * i) / chunks;
+
+            parallel_sort_t ps;
+            ps.src          = static_cast<uint8_t *>(data);
+            ps.dst          = &buf[szof_bounds];
+            ps.size         = size;
+            ps.bounds       = bounds;
+            ps.width        = 1;
+            ps.parts        = 1;
+            ps.cmp          = cmp;
+            ps.arg          = arg;
+            ps.stable       = stable;
+
+            // Sort chunks
+            executor->execute(executor, parallel_sort_chunk, &ps, chunks);
+
+            // Merge runs, each pair of runs is merged by multiple tasks
+            for ( ; ps.width < chunks; ps.width <<= 1)
+            {
+                ps.parts        = ps.width * 2;
+                executor->execute(executor, parallel_sort_merge, &ps, chunks);
+                lsp::swap(ps.src, ps.dst);
+            }
+
+            // Copy the result if needed
+            if (ps.src != data)
+                ::memcpy(data, ps.src, n * size);
+        }
+    } /* namespace lltl */
+} /* namespace lsp */
@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_HELPERS_EXECUTOR_H_
+#define TEST_HELPERS_EXECUTOR_H_
+
+#include <lsp-plug.in/lltl/types.h>
+
+namespace lsp
+{
+    namespace lltl
+    {
+        namespace test
+        {
+            /**
+             * Executor which runs tasks in reverse order in the caller thread
+             *
+             * @param self executor interface
+             * @param task task to execute
+             * @param arg argument passed to the task
+             * @param count number of task indices to execute
+             */
+            static inline void execute_reverse(executor_iface *self, task_func_t task, void *arg, size_t count)
+            {
+                for (size_t i=count; i > 0; )
+                    task(arg, --i);
+            }
+        } /* namespace test */
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* TEST_HELPERS_EXECUTOR_H_ */
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 17 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_HELPERS_THREAD_H_
+#define TEST_HELPERS_THREAD_H_
+
+#include <lsp-plug.in/common/types.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <windows.h>
+#else
+    #include <pthread.h>
+    #include <sched.h>
+#endif /* PLATFORM_WINDOWS */
+
+namespace lsp
+{
+    namespace lltl
+    {
+        namespace test
+        {
+            typedef void (* thread_func_t)(void *arg);
+
+            /**
+             * Minimal thread wrapper for concurrency tests
+             */
+            class thread
+            {
+                private:
+                    thread_func_t       pFunc;
+                    void               *pArg;
+                    bool                bStarted;
+                #ifdef PLATFORM_WINDOWS
+                    HANDLE              hThread;
+                #else
+                    pthread_t           hThread;
+                #endif /* PLATFORM_WINDOWS */
+
+                private:
+                #ifdef PLATFORM_WINDOWS
+                    static DWORD WINAPI run(LPVOID arg)
+                    {
+                        thread *self = static_cast<thread *>(arg);
+                        self->pFunc(self->pArg);
+                        return 0;
+                    }
+                #else
+                    static void *run(void *arg)
+                    {
+                        thread *self = static_cast<thread *>(arg);
+                        self->pFunc(self->pArg);
+                        return NULL;
+                    }
+                #endif /* PLATFORM_WINDOWS */
+
+                public:
+                    thread()
+                    {
+                        pFunc       = NULL;
+                        pArg        = NULL;
+                        bStarted    = false;
+                    }
+
+                    thread(const thread &) = delete;
+                    thread(thread &&) = delete;
+                    thread & operator = (const thread &) = delete;
+                    thread & operator = (thread &&) = delete;
+
+                    ~thread()
+                    {
+                        join();
+                    }
+
+                public:
+                    /**
+                     * Start the thread
+                     * @param func function to execute
+                     * @param arg argument passed to the function
+                     * @return true on success
+                     */
+                    bool start(thread_func_t func, void *arg)
+                    {
+                        if (bStarted)
+                            return false;
+
+                        pFunc       = func;
+                        pArg        = arg;
+                    #ifdef PLATFORM_WINDOWS
+                        hThread     = CreateThread(NULL, 0, run, this, 0, NULL);
+                        bStarted    = hThread != NULL;
+                    #else
+                        bStarted    = pthread_create(&hThread, NULL, run, this) == 0;
+                    #endif /* PLATFORM_WINDOWS */
+
+                        return bStarted;
+                    }
+
+                    /**
+                     * Wait for the thread to finish
+                     */
+                    void join()
+                    {
+                        if (!bStarted)
+                            return;
+
+                    #ifdef PLATFORM_WINDOWS
+                        WaitForSingleObject(hThread, INFINITE);
+                        CloseHandle(hThread);
+                    #else
+                        pthread_join(hThread, NULL);
+                    #endif /* PLATFORM_WINDOWS */
+                        bStarted    = false;
+                    }
+
+                    /**
+                     * Give up the CPU to other threads
+                     */
+                    static inline void yield()
+                    {
+                    #ifdef PLATFORM_WINDOWS
+                        SwitchToThread();
+                    #else
+                        sched_yield();
+                    #endif /* PLATFORM_WINDOWS */
+                    }
+            };
+
+        } /* namespace test */
+    } /* namespace lltl */
+} /* namespace lsp */
+
+#endif /* TEST_HELPERS_THREAD_H_ */
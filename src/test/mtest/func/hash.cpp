@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/mtest.h>
+#include <lsp-plug.in/lltl/hstring.h>
+#include <lsp-plug.in/lltl/pphash.h>
+#include <lsp-plug.in/lltl/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+
+#include <time.h>
+
+MTEST_BEGIN("lltl.func", hash)
+
+    typedef struct func_t
+    {
+        const char         *name;
+        lltl::hash_func_t   func;
+    } func_t;
+
+    typedef struct struct_key_t
+    {
+        int32_t     x;
+        int32_t     y;
+        int64_t     z;
+    } struct_key_t;
+
+    static double now()
+    {
+        return double(clock()) / double(CLOCKS_PER_SEC);
+    }
+
+    void stats(const char *name, const int *p, size_t n)
+    {
+        int min = p[0], max = p[0];
+        size_t empty = 0;
+        double kn = 1.0/double(n);
+        double avg = 0.0, disp = 0.0;
+
+        for (size_t i=0; i<n; ++i)
+        {
+            if (p[i] > max)
+                max = p[i];
+            if (p[i] < min)
+                min = p[i];
+            if (p[i] == 0)
+                ++empty;
+
+            double v = p[i];
+            avg  += v * kn;   // M[x]   = sum{ p[i] / n }
+            disp += v*v * kn; // M[x^2] = sum{ p[i]^2 / n }
+        }
+
+        disp -= avg*avg; // M[x^2] - M[x]^2
+
+        printf("  %-20s 0x%04x bins: min=%d, max=%d, empty=%d, avg=%f, qdisp=%f\n",
+                name, int(n), min, max, int(empty), avg, sqrt(disp));
+    }
+
+    void test_throughput(const func_t *funcs, size_t nfuncs)
+    {
+        static const size_t sizes[] = { 4, 8, 16, 32, 64, 256, 4096, 65536 };
+        static const size_t total   = 0x10000000;
+
+        uint8_t *buf = static_cast<uint8_t *>(malloc(0x10000));
+        MTEST_ASSERT(buf != NULL);
+        lsp_finally { free(buf); };
+        for (size_t i=0; i<0x10000; ++i)
+            buf[i]      = uint8_t(rand());
+
+        printf("Testing throughput of hash functions...\n");
+        for (size_t j=0; j<sizeof(sizes)/sizeof(size_t); ++j)
+        {
+            const size_t size   = sizes[j];
+            const size_t iters  = total / size;
+
+            for (size_t k=0; k<nfuncs; ++k)
+            {
+                const func_t *f     = &funcs[k];
+                size_t hash         = 0;
+                double start        = now();
+                for (size_t i=0; i<iters; ++i)
+                {
+                    buf[0]             ^= uint8_t(hash);
+                    hash               ^= f->func(buf, size);
+                }
+                double time         = now() - start;
+
+                printf("  %-20s size=%6d: %10.2f MB/s, %10.2f Mhash/s (%x)\n",
+                    f->name, int(size),
+                    double(total) / (time * 1048576.0), double(iters) / (time * 1000000.0), unsigned(hash));
+            }
+        }
+    }
+
+    void test_distribution(const func_t *funcs, size_t nfuncs)
+    {
+        static const size_t count   = 0x100000;
+        static const size_t bins    = 0x1000;
+        int *b = static_cast<int *>(malloc(bins * sizeof(int)));
+        MTEST_ASSERT(b != NULL);
+        lsp_finally { free(b); };
+
+        printf("Testing distribution of sequential integer keys...\n");
+        for (size_t k=0; k<nfuncs; ++k)
+        {
+            memset(b, 0, bins * sizeof(int));
+            for (size_t i=0; i<count; ++i)
+            {
+                uint32_t key = uint32_t(i);
+                ++b[funcs[k].func(&key, sizeof(key)) & (bins - 1)];
+            }
+            stats(funcs[k].name, b, bins);
+        }
+
+        printf("Testing distribution of structured keys...\n");
+        for (size_t k=0; k<nfuncs; ++k)
+        {
+            memset(b, 0, bins * sizeof(int));
+            for (size_t i=0; i<count; ++i)
+            {
+                struct_key_t key;
+                key.x       = int32_t(i & 0x3ff) * 16;
+                key.y       = int32_t(i >> 10) * 16;
+                key.z       = int64_t(i & 0xf) << 40;
+                ++b[funcs[k].func(&key, sizeof(key)) & (bins - 1)];
+            }
+            stats(funcs[k].name, b, bins);
+        }
+    }
+
+    void test_string_distribution()
+    {
+        static const size_t count   = 0x100000;
+        static const size_t bins    = 0x1000;
+        static const func_t funcs[] =
+        {
+            { "char_hash_func",         lltl::char_hash_func        },
+            { "fast_char_hash_func",    lltl::fast_char_hash_func   }
+        };
+
+        int *b = static_cast<int *>(malloc(bins * sizeof(int)));
+        MTEST_ASSERT(b != NULL);
+        lsp_finally { free(b); };
+
+        char key[64];
+        printf("Testing distribution and speed of string keys...\n");
+        for (size_t k=0; k<sizeof(funcs)/sizeof(func_t); ++k)
+        {
+            memset(b, 0, bins * sizeof(int));
+            double start = now();
+            for (size_t i=0; i<count; ++i)
+            {
+                snprintf(key, sizeof(key), "/usr/share/presets/preset_%d.cfg", int(i));
+                ++b[funcs[k].func(key, sizeof(char)) & (bins - 1)];
+            }
+            double time = now() - start;
+            stats(funcs[k].name, b, bins);
+            printf("  %-20s %.3f s including formatting of keys\n", funcs[k].name, time);
+        }
+    }
+
+    void test_string_keys()
+    {
+        static const size_t count   = 0x10000;
+        static const size_t rounds  = 0x10;
+        char buf[64];
+
+        char **keys = static_cast<char **>(malloc(count * sizeof(char *)));
+        lltl::hstring **hkeys = static_cast<lltl::hstring **>(malloc(count * sizeof(lltl::hstring *)));
+        MTEST_ASSERT((keys != NULL) && (hkeys != NULL));
+        lsp_finally {
+            for (size_t i=0; i<count; ++i)
+            {
+                free(keys[i]);
+                lltl::hstring_free(hkeys[i]);
+            }
+            free(keys);
+            free(hkeys);
+        };
+
+        lltl::pphash<char, int> ch;
+        lltl::pphash<lltl::hstring, int> hh;
+        for (size_t i=0; i<count; ++i)
+        {
+            snprintf(buf, sizeof(buf), "/usr/share/presets/preset_%d.cfg", int(i));
+            keys[i]     = strdup(buf);
+            hkeys[i]    = lltl::hstring_create(buf);
+            MTEST_ASSERT((keys[i] != NULL) && (hkeys[i] != NULL));
+            MTEST_ASSERT(ch.create(keys[i], NULL) != NULL);
+            MTEST_ASSERT(hh.create(hkeys[i], NULL) != NULL);
+        }
+
+        printf("Testing lookup of repeated string keys...\n");
+        size_t found = 0;
+        double start = now();
+        for (size_t r=0; r<rounds; ++r)
+            for (size_t i=0; i<count; ++i)
+                found      += ch.contains(keys[i]);
+        double time = now() - start;
+        printf("  %-20s %10.2f Mlookup/s (%d)\n", "char *", double(count * rounds) / (time * 1000000.0), int(found));
+
+        found = 0;
+        start = now();
+        for (size_t r=0; r<rounds; ++r)
+            for (size_t i=0; i<count; ++i)
+                found      += hh.contains(hkeys[i]);
+        time = now() - start;
+        printf("  %-20s %10.2f Mlookup/s (%d)\n", "lltl::hstring", double(count * rounds) / (time * 1000000.0), int(found));
+    }
+
+    MTEST_MAIN
+    {
+        static const func_t funcs[] =
+        {
+            { "default_hash_func",      lltl::default_hash_func     },
+            { "fast_hash_func",         lltl::fast_hash_func        }
+        };
+
+        test_throughput(funcs, sizeof(funcs) / sizeof(func_t));
+        test_distribution(funcs, sizeof(funcs) / sizeof(func_t));
+        test_string_distribution();
+        test_string_keys();
+    }
+
+MTEST_END;
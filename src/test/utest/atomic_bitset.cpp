@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/atomic_bitset.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include "../helpers/thread.h"
+
+namespace
+{
+    static constexpr size_t SLOTS           = 70;
+    static constexpr size_t THREADS         = 4;
+    static constexpr size_t MAX_HELD        = 24;
+    static constexpr size_t ITERATIONS      = 20000;
+}
+
+UTEST_BEGIN("lltl", atomic_bitset)
+
+    typedef struct allocator_t
+    {
+        lltl::atomic_bitset    *bits;
+        uatomic_t               owners[SLOTS];  // Number of threads owning each slot
+        uatomic_t               violations;     // Number of slots claimed twice
+        uatomic_t               errors;         // Number of failed releases
+        uatomic_t               claims;         // Overall number of successful claims
+    } allocator_t;
+
+    typedef struct worker_t
+    {
+        allocator_t            *alloc;
+        uint32_t                id;
+    } worker_t;
+
+    static void worker_main(void *arg)
+    {
+        worker_t *w         = static_cast<worker_t *>(arg);
+        allocator_t *a      = w->alloc;
+        size_t held[MAX_HELD];
+        size_t n_held       = 0;
+        uint32_t seed       = w->id + 1;
+
+        for (size_t i=0; i<ITERATIONS; ++i)
+        {
+            seed                = seed * 1103515245 + 12345;
+            const uint32_t rnd  = seed >> 8;
+
+            if ((n_held < MAX_HELD) && (rnd & 1))
+            {
+                // Claim the slot and mark it as owned
+                const ssize_t index = a->bits->claim(rnd % SLOTS);
+                if (index < 0)
+                    continue;
+                if (atomic_add(&a->owners[index], 1) != 0)
+                    atomic_add(&a->violations, 1);
+                atomic_add(&a->claims, 1);
+                held[n_held++]      = index;
+            }
+            else if (n_held > 0)
+            {
+                // Release random slot
+                const size_t k      = (rnd >> 1) % n_held;
+                const size_t index  = held[k];
+                held[k]             = held[--n_held];
+                atomic_add(&a->owners[index], -1);
+                if (!a->bits->unset(index))
+                    atomic_add(&a->errors, 1);
+            }
+
+            if (!(i & 0xff))
+                lltl::test::thread::yield();
+        }
+
+        // Release all slots
+        while (n_held > 0)
+        {
+            const size_t index  = held[--n_held];
+            atomic_add(&a->owners[index], -1);
+            if (!a->bits->unset(index))
+                atomic_add(&a->errors, 1);
+        }
+    }
+
+    void test_single()
+    {
+        printf("Testing single bit operations...\n");
+
+        lltl::atomic_bitset x;
+        UTEST_ASSERT(x.is_empty());
+        UTEST_ASSERT(x.resize(200));
+        UTEST_ASSERT(x.size() == 200);
+        UTEST_ASSERT(x.capacity() > 0);
+
+        for (size_t i=0; i<200; ++i)
+        {
+            UTEST_ASSERT(!x.get(i));
+            UTEST_ASSERT(!x.set(i));
+            UTEST_ASSERT(x.set(i));
+            UTEST_ASSERT(x.get(i));
+        }
+        UTEST_ASSERT(x.count() == 200);
+        UTEST_ASSERT(!x.set(200));
+        UTEST_ASSERT(!x.get(200));
+
+        for (size_t i=0; i<200; i += 2)
+        {
+            UTEST_ASSERT(x.unset(i));
+            UTEST_ASSERT(!x.unset(i));
+        }
+        UTEST_ASSERT(x.count() == 100);
+
+        for (size_t i=0; i<200; ++i)
+            UTEST_ASSERT(x.toggle(i) == bool(i & 1));
+        for (size_t i=0; i<200; ++i)
+            UTEST_ASSERT(x.get(i) == !(i & 1));
+
+        UTEST_ASSERT(!x.try_set(0));
+        UTEST_ASSERT(x.try_set(1));
+        UTEST_ASSERT(!x.try_set(1));
+        UTEST_ASSERT(!x.try_set(200));
+        UTEST_ASSERT(x.set(2, false) == true);
+        UTEST_ASSERT(x.set(2, true) == false);
+
+        x.unset_all();
+        UTEST_ASSERT(x.count() == 0);
+        x.set_all();
+        UTEST_ASSERT(x.count() == 200);
+
+        UTEST_ASSERT(x.resize(100));
+        UTEST_ASSERT(x.count() == 100);
+        UTEST_ASSERT(x.resize(300));
+        UTEST_ASSERT(x.count() == 100);
+        UTEST_ASSERT(!x.get(100));
+    }
+
+    void test_claim()
+    {
+        printf("Testing claim...\n");
+
+        lltl::atomic_bitset x;
+        UTEST_ASSERT(x.claim() < 0);
+        UTEST_ASSERT(x.resize(130));
+
+        // Claim all bits
+        for (size_t i=0; i<130; ++i)
+            UTEST_ASSERT(x.claim() == ssize_t(i));
+        UTEST_ASSERT(x.claim() < 0);
+        UTEST_ASSERT(x.claim(70) < 0);
+        UTEST_ASSERT(x.count() == 130);
+
+        // Release some bits and claim them with hints
+        UTEST_ASSERT(x.unset(5));
+        UTEST_ASSERT(x.unset(66));
+        UTEST_ASSERT(x.unset(129));
+        UTEST_ASSERT(x.claim(70) == 129);
+        UTEST_ASSERT(x.claim(70) == 5);
+        UTEST_ASSERT(x.claim(1000) == 66);
+        UTEST_ASSERT(x.claim(0) < 0);
+
+        // Random claim and release
+        bool used[130];
+        for (size_t i=0; i<130; ++i)
+            used[i]     = true;
+
+        for (size_t i=0; i<10000; ++i)
+        {
+            size_t index    = rand() % 130;
+            if (rand() % 2)
+            {
+                UTEST_ASSERT(x.unset(index) == used[index]);
+                used[index]     = false;
+            }
+            else
+            {
+                ssize_t claimed = x.claim(index);
+                if (claimed < 0)
+                {
+                    for (size_t j=0; j<130; ++j)
+                        UTEST_ASSERT(used[j]);
+                }
+                else
+                {
+                    UTEST_ASSERT(!used[claimed]);
+                    used[claimed]   = true;
+                    for (size_t j=index; j != size_t(claimed); j = (j + 1) % 130)
+                        UTEST_ASSERT(used[j]);
+                }
+            }
+        }
+    }
+
+    void test_concurrent_claim()
+    {
+        printf("Testing concurrent claim by %d threads...\n", int(THREADS));
+
+        lltl::atomic_bitset x;
+        UTEST_ASSERT(x.resize(SLOTS));
+
+        allocator_t a;
+        a.bits          = &x;
+        for (size_t i=0; i<SLOTS; ++i)
+            a.owners[i]     = 0;
+        a.violations    = 0;
+        a.errors        = 0;
+        a.claims        = 0;
+
+        worker_t workers[THREADS];
+        lltl::test::thread threads[THREADS];
+        for (size_t i=0; i<THREADS; ++i)
+        {
+            workers[i].alloc    = &a;
+            workers[i].id       = i;
+            UTEST_ASSERT(threads[i].start(worker_main, &workers[i]));
+        }
+        for (size_t i=0; i<THREADS; ++i)
+            threads[i].join();
+
+        printf("  performed %d claims\n", int(a.claims));
+        UTEST_ASSERT_MSG(a.violations == 0, "%d slots have been claimed twice", int(a.violations));
+        UTEST_ASSERT_MSG(a.errors == 0, "%d owned slots were not set on release", int(a.errors));
+        for (size_t i=0; i<SLOTS; ++i)
+            UTEST_ASSERT(a.owners[i] == 0);
+        UTEST_ASSERT(x.count() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        test_single();
+        test_claim();
+        test_concurrent_claim();
+    }
+
+UTEST_END;
@@ -302,6 +302,132 @@ UTEST_BEGIN("lltl", bitset)
         }
     }
 
+    void fill_random(lltl::bitset *x, bool *buf, size_t size, int density)
+    {
+        for (size_t i=0; i<size; ++i)
+        {
+            buf[i]      = (rand() % 100) < density;
+            x->set(i, buf[i]);
+        }
+    }
+
+    void check_bits(const lltl::bitset *x, const bool *buf, size_t size)
+    {
+        size_t count = 0;
+        for (size_t i=0; i<size; ++i)
+        {
+            UTEST_ASSERT_MSG(x->get(i) == buf[i], "bit at index %d is %d but expected to be %d", int(i), int(x->get(i)), int(buf[i]));
+            if (buf[i])
+                ++count;
+        }
+        UTEST_ASSERT(x->count() == count);
+    }
+
+    void test_bulk_ops()
+    {
+        lltl::bitset x, y;
+        bool bx[0x400], by[0x400], bz[0x400];
+
+        UTEST_FOREACH(size, 10, 64, 100, 255, 640, 1000)
+        {
+            UTEST_FOREACH(ysize, 10, 64, 300, 1000)
+            {
+                printf("Testing bulk operations for sizes %d, %d...\n", int(size), int(ysize));
+
+                UTEST_ASSERT(x.resize(size));
+                UTEST_ASSERT(y.resize(ysize));
+                fill_random(&y, by, ysize, 50);
+                for (size_t i=ysize; i<size; ++i)
+                    by[i]       = false;
+
+                // AND
+                fill_random(&x, bx, size, 50);
+                x.bitwise_and(&y);
+                for (size_t i=0; i<size; ++i)
+                    bz[i]       = bx[i] && by[i];
+                check_bits(&x, bz, size);
+
+                // OR
+                fill_random(&x, bx, size, 50);
+                x.bitwise_or(&y);
+                for (size_t i=0; i<size; ++i)
+                    bz[i]       = bx[i] || by[i];
+                check_bits(&x, bz, size);
+
+                // XOR
+                fill_random(&x, bx, size, 50);
+                x.bitwise_xor(&y);
+                for (size_t i=0; i<size; ++i)
+                    bz[i]       = bx[i] != by[i];
+                check_bits(&x, bz, size);
+
+                // ANDNOT
+                fill_random(&x, bx, size, 50);
+                x.bitwise_andnot(&y);
+                for (size_t i=0; i<size; ++i)
+                    bz[i]       = bx[i] && (!by[i]);
+                check_bits(&x, bz, size);
+            }
+        }
+    }
+
+    void test_find()
+    {
+        lltl::bitset x;
+        bool buf[0x400];
+
+        UTEST_FOREACH(size, 1, 10, 64, 100, 255, 640, 1000)
+        {
+            UTEST_FOREACH(density, 0, 1, 50, 99, 100)
+            {
+                printf("Testing find for size %d, density %d...\n", int(size), int(density));
+
+                UTEST_ASSERT(x.resize(size));
+                fill_random(&x, buf, size, density);
+                check_bits(&x, buf, size);
+
+                // Enumerate set bits
+                ssize_t expected = size;
+                for (size_t i=0; i<size; ++i)
+                    if (buf[i])
+                    {
+                        expected = i;
+                        break;
+                    }
+
+                for (ssize_t i = x.find_first(); i >= 0; i = x.find_next(i))
+                {
+                    UTEST_ASSERT_MSG(i == expected, "found set bit %d, expected %d", int(i), int(expected));
+                    for (expected = i + 1; (expected < ssize_t(size)) && (!buf[expected]); ++expected)
+                        /* nothing */ ;
+                }
+                UTEST_ASSERT(expected >= ssize_t(size));
+
+                // Enumerate unset bits
+                expected = size;
+                for (size_t i=0; i<size; ++i)
+                    if (!buf[i])
+                    {
+                        expected = i;
+                        break;
+                    }
+
+                for (ssize_t i = x.find_first_unset(); i >= 0; i = x.find_next_unset(i))
+                {
+                    UTEST_ASSERT_MSG(i == expected, "found unset bit %d, expected %d", int(i), int(expected));
+                    for (expected = i + 1; (expected < ssize_t(size)) && (buf[expected]); ++expected)
+                        /* nothing */ ;
+                }
+                UTEST_ASSERT(expected >= ssize_t(size));
+            }
+        }
+
+        x.flush();
+        UTEST_ASSERT(x.find_first() < 0);
+        UTEST_ASSERT(x.find_first_unset() < 0);
+        UTEST_ASSERT(x.count() == 0);
+    }
+
     UTEST_MAIN
     {
         test_resize();
@@ -311,6 +437,8 @@ UTEST_BEGIN("lltl", bitset)
         test_multi_unset();
         test_multi_toggle();
         test_set_random();
+        test_bulk_ops();
+        test_find();
     }
 
 UTEST_END;
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/concurrent_hash_index.h>
+
+#include "../helpers/thread.h"
+
+inline namespace
+{
+    typedef struct payload_t
+    {
+    } payload_t;
+
+    static inline payload_t * make_payload(size_t value)
+    {
+        return reinterpret_cast<payload_t *>(value);
+    }
+
+    size_t payload_hash_func(const void *ptr, size_t size)
+    {
+        return size_t(ptr);
+    }
+
+    ssize_t payload_cmp_func(const void *a, const void *b, size_t size)
+    {
+        return intptr_t(a) - intptr_t(b);
+    }
+
+    static constexpr size_t STABLE_KEYS     = 0x400;
+    static constexpr size_t WRITER_KEYS     = 0x2000;
+    static constexpr size_t WRITERS         = 2;
+    static constexpr size_t READERS         = 3;
+    static constexpr size_t ROUNDS          = 4;
+}
+
+namespace lsp
+{
+    namespace lltl
+    {
+        template <>
+        struct hash_spec<payload_t>: public hash_iface
+        {
+            inline hash_spec(): hash_iface()
+            {
+                hash        = payload_hash_func;
+            }
+        };
+
+        template <>
+        struct compare_spec<payload_t>: public compare_iface
+        {
+            inline compare_spec()
+            {
+                compare     = payload_cmp_func;
+            }
+        };
+    } /* namespace lltl */
+} /* namespace lsp */
+
+UTEST_BEGIN("lltl", concurrent_hash_index)
+
+    typedef lltl::concurrent_hash_index<payload_t, payload_t> index_t;
+
+    typedef struct concurrent_t
+    {
+        index_t    *index;
+        uatomic_t   done;           // Number of finished writers
+        uatomic_t   errors;         // Number of failed writer operations
+        uatomic_t   mismatches;     // Number of wrong values observed by readers
+        uatomic_t   reads;          // Overall number of lookups
+    } concurrent_t;
+
+    typedef struct worker_t
+    {
+        concurrent_t   *ctx;
+        size_t          id;
+    } worker_t;
+
+    static inline size_t stable_key(size_t i)                   { return 0x100000 + i;                      }
+    static inline size_t writer_key(size_t writer, size_t i)    { return 0x200000 + (writer << 16) + i;     }
+    static inline size_t key_value(size_t key, size_t gen)      { return (key << 2) | gen;                  }
+
+    static void writer_main(void *arg)
+    {
+        worker_t *w         = static_cast<worker_t *>(arg);
+        concurrent_t *ctx   = w->ctx;
+        index_t *index      = ctx->index;
+        payload_t *ov       = NULL;
+
+        for (size_t round=0; round<ROUNDS; ++round)
+        {
+            // Insert keys, this forces the table to grow
+            for (size_t i=0; i<WRITER_KEYS; ++i)
+            {
+                const size_t k = writer_key(w->id, i);
+                if (!index->create(make_payload(k), make_payload(key_value(k, 1))))
+                    atomic_add(&ctx->errors, 1);
+            }
+
+            // Update values
+            for (size_t i=0; i<WRITER_KEYS; ++i)
+            {
+                const size_t k = writer_key(w->id, i);
+                if ((!index->put(make_payload(k), make_payload(key_value(k, 2)), &ov)) ||
+                    (ov != make_payload(key_value(k, 1))))
+                    atomic_add(&ctx->errors, 1);
+            }
+
+            // Remove keys
+            for (size_t i=0; i<WRITER_KEYS; ++i)
+            {
+                const size_t k = writer_key(w->id, i);
+                if ((!index->remove(make_payload(k), &ov)) ||
+                    (ov != make_payload(key_value(k, 2))))
+                    atomic_add(&ctx->errors, 1);
+            }
+
+            lltl::test::thread::yield();
+        }
+
+        atomic_add(&ctx->done, 1);
+    }
+
+    static void reader_main(void *arg)
+    {
+        worker_t *w         = static_cast<worker_t *>(arg);
+        concurrent_t *ctx   = w->ctx;
+        const index_t *index= ctx->index;
+        size_t seed         = w->id + 1;
+
+        while (size_t(atomic_load(&ctx->done)) < WRITERS)
+        {
+            for (size_t j=0; j<0x100; ++j)
+            {
+                seed                = seed * 1103515245 + 12345;
+
+                // Stable keys should always be present with the same value
+                const size_t sk     = stable_key((seed >> 8) % STABLE_KEYS);
+                if ((!index->contains(make_payload(sk))) ||
+                    (index->get(make_payload(sk)) != make_payload(key_value(sk, 0))))
+                    atomic_add(&ctx->mismatches, 1);
+
+                // Keys modified by writers should be missing or hold a value of the same key
+                const size_t wk     = writer_key((seed >> 4) % WRITERS, (seed >> 8) % WRITER_KEYS);
+                const size_t v      = size_t(index->get(make_payload(wk)));
+                if ((v != 0) && ((v >> 2) != wk))
+                    atomic_add(&ctx->mismatches, 1);
+            }
+
+            atomic_add(&ctx->reads, 0x100);
+            lltl::test::thread::yield();
+        }
+    }
+
+    void test_concurrent()
+    {
+        index_t index;
+
+        printf("Testing %d writers and %d readers...\n", int(WRITERS), int(READERS));
+
+        for (size_t i=0; i<STABLE_KEYS; ++i)
+        {
+            const size_t k = stable_key(i);
+            UTEST_ASSERT(index.create(make_payload(k), make_payload(key_value(k, 0))));
+        }
+
+        concurrent_t ctx;
+        ctx.index       = &index;
+        ctx.done        = 0;
+        ctx.errors      = 0;
+        ctx.mismatches  = 0;
+        ctx.reads       = 0;
+
+        worker_t workers[WRITERS + READERS];
+        lltl::test::thread threads[WRITERS + READERS];
+        for (size_t i=0; i<WRITERS + READERS; ++i)
+        {
+            workers[i].ctx      = &ctx;
+            workers[i].id       = (i < WRITERS) ? i : i - WRITERS;
+        }
+        for (size_t i=0; i<READERS; ++i)
+            UTEST_ASSERT(threads[WRITERS + i].start(reader_main, &workers[WRITERS + i]));
+        for (size_t i=0; i<WRITERS; ++i)
+            UTEST_ASSERT(threads[i].start(writer_main, &workers[i]));
+        for (size_t i=0; i<WRITERS + READERS; ++i)
+            threads[i].join();
+
+        printf("  performed %d lookups\n", int(ctx.reads));
+        UTEST_ASSERT_MSG(ctx.errors == 0, "%d writer operations failed", int(ctx.errors));
+        UTEST_ASSERT_MSG(ctx.mismatches == 0, "%d wrong lookup results", int(ctx.mismatches));
+
+        // Only stable keys should remain
+        UTEST_ASSERT(index.size() == STABLE_KEYS);
+        for (size_t i=0; i<STABLE_KEYS; ++i)
+        {
+            const size_t k = stable_key(i);
+            UTEST_ASSERT(index.get(make_payload(k)) == make_payload(key_value(k, 0)));
+        }
+        for (size_t i=0; i<WRITERS; ++i)
+            UTEST_ASSERT(!index.contains(make_payload(writer_key(i, 0))));
+
+        index.gc();
+    }
+
+    void test_basic()
+    {
+        lltl::concurrent_hash_index<payload_t, payload_t> index;
+        payload_t *ov = NULL;
+
+        printf("Testing basic functions...\n");
+
+        UTEST_ASSERT(index.size() == 0);
+        UTEST_ASSERT(index.is_empty());
+        UTEST_ASSERT(index.get(make_payload(1)) == NULL);
+        UTEST_ASSERT(index.dget(make_payload(1), make_payload(42)) == make_payload(42));
+        UTEST_ASSERT(!index.remove(make_payload(1), &ov));
+        UTEST_ASSERT(!index.replace(make_payload(1), make_payload(2), &ov));
+
+        // Create items
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(index.create(make_payload(0x10000 + i), make_payload(0x20000 + i)));
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(!index.create(make_payload(0x10000 + i), make_payload(0x20000 + i)));
+        UTEST_ASSERT(index.size() == 0x1000);
+
+        for (size_t i=0; i<0x1000; ++i)
+        {
+            UTEST_ASSERT(index.contains(make_payload(0x10000 + i)));
+            UTEST_ASSERT(index.get(make_payload(0x10000 + i)) == make_payload(0x20000 + i));
+            UTEST_ASSERT(index.key(make_payload(0x10000 + i)) == make_payload(0x10000 + i));
+        }
+        UTEST_ASSERT(!index.contains(make_payload(0x20000)));
+
+        // Replace and put items
+        for (size_t i=0; i<0x1000; i += 2)
+        {
+            UTEST_ASSERT(index.replace(make_payload(0x10000 + i), make_payload(0x30000 + i), &ov));
+            UTEST_ASSERT(ov == make_payload(0x20000 + i));
+        }
+        for (size_t i=0; i<0x2000; i += 2)
+        {
+            UTEST_ASSERT(index.put(make_payload(0x10000 + i), make_payload(0x40000 + i), &ov));
+            UTEST_ASSERT(ov == ((i < 0x1000) ? make_payload(0x30000 + i) : NULL));
+        }
+        UTEST_ASSERT(index.size() == 0x1800);
+
+        // Remove items
+        for (size_t i=1; i<0x1000; i += 2)
+        {
+            UTEST_ASSERT(index.remove(make_payload(0x10000 + i), &ov));
+            UTEST_ASSERT(ov == make_payload(0x20000 + i));
+        }
+        UTEST_ASSERT(index.size() == 0x1000);
+        for (size_t i=0; i<0x2000; ++i)
+            UTEST_ASSERT(index.get(make_payload(0x10000 + i)) == ((i & 1) ? NULL : make_payload(0x40000 + i)));
+
+        // Check snapshots
+        lltl::parray<payload_t> vk, vv;
+        UTEST_ASSERT(index.items(&vk, &vv));
+        UTEST_ASSERT(vk.size() == 0x1000);
+        UTEST_ASSERT(vv.size() == 0x1000);
+        for (size_t i=0; i<vk.size(); ++i)
+        {
+            const size_t k = size_t(vk.uget(i));
+            UTEST_ASSERT(vv.uget(i) == make_payload(k - 0x10000 + 0x40000));
+        }
+        UTEST_ASSERT(index.keys(&vk));
+        UTEST_ASSERT(vk.size() == 0x1000);
+        UTEST_ASSERT(index.values(&vv));
+        UTEST_ASSERT(vv.size() == 0x1000);
+
+        // Clear the index and reuse it
+        index.clear();
+        UTEST_ASSERT(index.is_empty());
+        UTEST_ASSERT(index.get(make_payload(0x10000)) == NULL);
+        UTEST_ASSERT(index.create(make_payload(0x10000), make_payload(1)));
+        UTEST_ASSERT(index.get(make_payload(0x10000)) == make_payload(1));
+
+        index.gc();
+        index.flush();
+        UTEST_ASSERT(index.is_empty());
+        UTEST_ASSERT(index.put(make_payload(0x10000), make_payload(2), &ov));
+        UTEST_ASSERT(ov == NULL);
+    }
+
+    void test_null_key()
+    {
+        lltl::concurrent_hash_index<payload_t, payload_t> index;
+        payload_t *ov = NULL;
+
+        printf("Testing NULL key...\n");
+
+        UTEST_ASSERT(!index.contains(NULL));
+        UTEST_ASSERT(index.create(NULL, make_payload(1)));
+        UTEST_ASSERT(index.create(make_payload(1), make_payload(2)));
+        UTEST_ASSERT(index.contains(NULL));
+        UTEST_ASSERT(index.get(NULL) == make_payload(1));
+        UTEST_ASSERT(index.remove(NULL, &ov));
+        UTEST_ASSERT(ov == make_payload(1));
+        UTEST_ASSERT(!index.contains(NULL));
+        UTEST_ASSERT(index.get(make_payload(1)) == make_payload(2));
+    }
+
+    UTEST_MAIN
+    {
+        test_basic();
+        test_null_key();
+        test_concurrent();
+    }
+
+UTEST_END
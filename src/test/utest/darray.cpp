@@ -22,6 +22,8 @@
 #include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
+#include "../helpers/executor.h"
+
 namespace
 {
     static ssize_t test_int_cmp(const int *a, const int *b)
@@ -35,6 +37,27 @@ namespace
         const int *_b = static_cast<const int *>(b);
         return *_b - *_a;
     }
+
+    typedef struct record_t
+    {
+        uint32_t    seq;
+        int16_t     key;
+    } record_t;
+
+    static ssize_t test_record_cmp(const record_t *a, const record_t *b)
+    {
+        return ssize_t(a->key) - ssize_t(b->key);
+    }
+
+    typedef struct triple_t
+    {
+        uint8_t     v[3];
+    } triple_t;
+
+    static ssize_t test_triple_cmp(const triple_t *a, const triple_t *b)
+    {
+        return memcmp(a->v, b->v, sizeof(a->v));
+    }
 }
 
 UTEST_BEGIN("lltl", darray)
@@ -809,6 +832,132 @@ UTEST_BEGIN("lltl", darray)
         printf("\n");
     }
 
+    void test_rsort()
+    {
+        printf("Testing rsort...\n");
+
+        // Sort signed integers
+        for (size_t n=0; n<1000; n = n*2 + 1)
+        {
+            lltl::darray<int> a;
+            for (size_t i=0; i<n; ++i)
+                UTEST_ASSERT(a.add(int(rand()) - RAND_MAX/2));
+            UTEST_ASSERT(a.rsort());
+            UTEST_ASSERT(a.size() == n);
+            for (size_t i=1; i<n; ++i)
+                UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+        }
+
+        // Sort floating-point numbers
+        {
+            lltl::darray<float> a;
+            for (size_t i=0; i<10000; ++i)
+                UTEST_ASSERT(a.add(float(rand() - RAND_MAX/2) / 1000.0f));
+            UTEST_ASSERT(a.add(-0.0f));
+            UTEST_ASSERT(a.add(0.0f));
+            UTEST_ASSERT(a.rsort());
+            for (size_t i=1, n=a.size(); i<n; ++i)
+                UTEST_ASSERT_MSG(*a.uget(i-1) <= *a.uget(i), "Failed at index %d: %f > %f", int(i), *a.uget(i-1), *a.uget(i));
+        }
+
+        // Sort unsigned 64-bit numbers with the same high bytes
+        {
+            lltl::darray<uint64_t> a;
+            for (size_t i=0; i<10000; ++i)
+                UTEST_ASSERT(a.add(uint64_t(0x1234567800000000ULL) | uint64_t(rand() & 0xffff)));
+            UTEST_ASSERT(a.rsort());
+            for (size_t i=1, n=a.size(); i<n; ++i)
+                UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+        }
+
+        // Sort records by key and check stability
+        {
+            lltl::darray<record_t> a;
+            for (size_t i=0; i<10000; ++i)
+            {
+                record_t *r = a.add();
+                UTEST_ASSERT(r != NULL);
+                r->seq      = i;
+                r->key      = int16_t(rand() % 200 - 100);
+            }
+            UTEST_ASSERT(a.rsort<int16_t>(offsetof(record_t, key)));
+            for (size_t i=1, n=a.size(); i<n; ++i)
+            {
+                const record_t *r1 = a.uget(i-1), *r2 = a.uget(i);
+                UTEST_ASSERT(r1->key <= r2->key);
+                if (r1->key == r2->key)
+                    UTEST_ASSERT(r1->seq < r2->seq);
+            }
+
+            // Invalid key offset
+            UTEST_ASSERT(!a.rsort<uint64_t>(offsetof(record_t, key)));
+        }
+    }
+
+    void test_psort()
+    {
+        printf("Testing pqsort and pssort...\n");
+
+        lltl::executor_iface executor;
+        executor.workers    = 6;
+        executor.execute    = lltl::test::execute_reverse;
+
+        for (size_t n=0; n<200000; n = n*3 + 1)
+        {
+            printf("  sorting %d elements\n", int(n));
+
+            // Unstable sort
+            lltl::darray<int> a;
+            for (size_t i=0; i<n; ++i)
+                UTEST_ASSERT(a.add(int(rand()) - RAND_MAX/2));
+            a.pqsort(test_int_cmp, &executor);
+            UTEST_ASSERT(a.size() == n);
+            for (size_t i=1; i<n; ++i)
+                UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+
+            // Stable sort
+            lltl::darray<record_t> b;
+            for (size_t i=0; i<n; ++i)
+            {
+                record_t *r = b.add();
+                UTEST_ASSERT(r != NULL);
+                r->seq      = i;
+                r->key      = int16_t(rand() % 200 - 100);
+            }
+            b.pssort(test_record_cmp, &executor);
+            UTEST_ASSERT(b.size() == n);
+            for (size_t i=1; i<n; ++i)
+            {
+                const record_t *r1 = b.uget(i-1), *r2 = b.uget(i);
+                UTEST_ASSERT(r1->key <= r2->key);
+                if (r1->key == r2->key)
+                    UTEST_ASSERT(r1->seq < r2->seq);
+            }
+        }
+
+        // Elements which size is not multiple of the word size
+        lltl::darray<triple_t> c;
+        for (size_t i=0; i<100003; ++i)
+        {
+            triple_t *t = c.add();
+            UTEST_ASSERT(t != NULL);
+            for (size_t j=0; j<3; ++j)
+                t->v[j]     = uint8_t(rand());
+        }
+        c.pqsort(test_triple_cmp, &executor);
+        UTEST_ASSERT(c.size() == 100003);
+        for (size_t i=1; i<c.size(); ++i)
+            UTEST_ASSERT(test_triple_cmp(c.uget(i-1), c.uget(i)) <= 0);
+
+        // Sequential fallback
+        lltl::darray<int> a;
+        for (size_t i=0; i<1000; ++i)
+            UTEST_ASSERT(a.add(int(rand())));
+        a.pqsort(test_int_cmp, NULL);
+        for (size_t i=1; i<a.size(); ++i)
+            UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+    }
+
     void test_iterator()
     {
         static const ssize_t N = 8;
@@ -930,6 +1079,83 @@ UTEST_BEGIN("lltl", darray)
         UTEST_ASSERT(n == N);
     }
 
+    void test_aligned()
+    {
+        printf("Testing aligned storage...\n");
+
+        lltl::darray<float> x(0x40);
+        UTEST_ASSERT(x.alignment() == 0x40);
+
+        // Grow the array and check alignment on each reallocation
+        for (int i=0; i<10000; ++i)
+        {
+            float v = i;
+            UTEST_ASSERT(x.add(&v));
+            UTEST_ASSERT((uintptr_t(x.array()) % 0x40) == 0);
+        }
+
+        // Insert and remove items
+        for (int i=0; i<100; ++i)
+        {
+            float v = -i;
+            UTEST_ASSERT(x.insert(i * 3, &v));
+            UTEST_ASSERT((uintptr_t(x.array()) % 0x40) == 0);
+        }
+        for (int i=99; i>=0; --i)
+        {
+            UTEST_ASSERT(x.remove(i * 3));
+        }
+        for (int i=0; i<10000; ++i)
+        {
+            UTEST_ASSERT(*x.uget(i) == float(i));
+        }
+
+        // Truncate the array
+        UTEST_ASSERT(x.truncate(1000));
+        UTEST_ASSERT((uintptr_t(x.array()) % 0x40) == 0);
+        UTEST_ASSERT(x.size() == 1000);
+        for (int i=0; i<1000; ++i)
+        {
+            UTEST_ASSERT(*x.uget(i) == float(i));
+        }
+
+        // Overwrite contents
+        float data[100];
+        for (int i=0; i<100; ++i)
+            data[i] = i * 2;
+        UTEST_ASSERT(x.set_n(100, data));
+        UTEST_ASSERT((uintptr_t(x.array()) % 0x40) == 0);
+        UTEST_ASSERT(x.size() == 100);
+
+        // Swap alignment with non-aligned array
+        lltl::darray<float> y;
+        UTEST_ASSERT(y.swap(x));
+        UTEST_ASSERT(y.alignment() == 0x40);
+        UTEST_ASSERT(x.alignment() == 0);
+        UTEST_ASSERT((uintptr_t(y.array()) % 0x40) == 0);
+        UTEST_ASSERT(y.size() == 100);
+        UTEST_ASSERT(x.size() == 0);
+
+        // Release the data
+        float *ptr = y.release();
+        UTEST_ASSERT(ptr != NULL);
+        for (int i=0; i<100; ++i)
+        {
+            UTEST_ASSERT(ptr[i] == float(i * 2));
+        }
+        free(ptr);
+        UTEST_ASSERT(y.size() == 0);
+        UTEST_ASSERT(y.alignment() == 0x40);
+
+        // Check that array is usable after release
+        for (int i=0; i<100; ++i)
+        {
+            float v = i;
+            UTEST_ASSERT(y.add(&v));
+            UTEST_ASSERT((uintptr_t(y.array()) % 0x40) == 0);
+        }
+    }
+
     UTEST_MAIN
     {
         test_single();
@@ -940,7 +1166,10 @@ UTEST_BEGIN("lltl", darray)
         test_xswap();
         test_long_xswap();
         test_sort();
+        test_rsort();
+        test_psort();
         test_iterator();
+        test_aligned();
     }
 
 UTEST_END
@@ -845,6 +845,129 @@ UTEST_BEGIN("lltl", ddeque)
         }
     }
 
+    void check_random_access(lltl::ddeque<int> &v, const int *ref, size_t n)
+    {
+        const int *ptr;
+
+        UTEST_ASSERT(v.size() == n);
+        for (size_t i=0; i<n; ++i)
+        {
+            UTEST_ASSERT(ptr = v.get(i));
+            UTEST_ASSERT_MSG(*ptr == ref[i], "Invalid value at index %d: %d, expected %d", int(i), *ptr, ref[i]);
+            UTEST_ASSERT(v.index_of(ptr) == ssize_t(i));
+        }
+        UTEST_ASSERT(v.get(n) == NULL);
+
+        // Check iterators with jumps
+        lltl::iterator<int> it = v.values();
+        for (size_t i=0; i<n; i += 7)
+        {
+            UTEST_ASSERT(it.valid());
+            UTEST_ASSERT(it.index() == i);
+            UTEST_ASSERT(*it.get() == ref[i]);
+            it     += 7;
+        }
+        UTEST_ASSERT(!it.valid());
+
+        it = v.rvalues();
+        for (size_t i=0; i<n; i += 5)
+        {
+            UTEST_ASSERT(it.valid());
+            UTEST_ASSERT(it.index() == n - i - 1);
+            UTEST_ASSERT(*it.get() == ref[n - i - 1]);
+            it     += 5;
+        }
+        UTEST_ASSERT(!it.valid());
+    }
+
+    void test_random_access()
+    {
+        static const size_t N = 0x4000;
+        printf("Testing ddeque random access...\n");
+
+        int *buf = static_cast<int *>(malloc(N * 2 * sizeof(int)));
+        UTEST_ASSERT(buf != NULL);
+        lsp_finally { free(buf); };
+
+        int data[0x40];
+        int value;
+        size_t head = N, tail = N;
+        lltl::ddeque<int> v(16);
+
+        for (size_t iter=0; iter<2000; ++iter)
+        {
+            const size_t count = rand() % 0x40;
+            for (size_t i=0; i<count; ++i)
+                data[i]     = int(iter * 0x40 + i);
+
+            switch (rand() % 9)
+            {
+                case 0: // Single push back
+                    if (tail >= N * 2)
+                        break;
+                    UTEST_ASSERT(v.push_back(data[0]));
+                    buf[tail++] = data[0];
+                    break;
+                case 1: // Single push front
+                    if (head <= 0)
+                        break;
+                    UTEST_ASSERT(v.push_front(data[0]));
+                    buf[--head] = data[0];
+                    break;
+                case 2: // Bulk push back
+                    if ((tail + count) > N * 2)
+                        break;
+                    UTEST_ASSERT(v.push_back(data, count));
+                    memcpy(&buf[tail], data, count * sizeof(int));
+                    tail       += count;
+                    break;
+                case 3: // Bulk push front
+                    if (head < count)
+                        break;
+                    UTEST_ASSERT(v.put_front(data, count));
+                    head       -= count;
+                    memcpy(&buf[head], data, count * sizeof(int));
+                    break;
+                case 4: // Single pop back
+                    UTEST_ASSERT(v.pop_back(value) == (head < tail));
+                    if (head < tail)
+                        UTEST_ASSERT(value == buf[--tail]);
+                    break;
+                case 5: // Single pop front
+                    UTEST_ASSERT(v.pop_front(value) == (head < tail));
+                    if (head < tail)
+                        UTEST_ASSERT(value == buf[head++]);
+                    break;
+                case 6: // Bulk pop back
+                {
+                    const size_t n = lsp_min(count, tail - head);
+                    UTEST_ASSERT(v.take_back(data, count) == n);
+                    tail       -= n;
+                    UTEST_ASSERT(memcmp(data, &buf[tail], n * sizeof(int)) == 0);
+                    break;
+                }
+                case 7: // Bulk pop front
+                {
+                    const size_t n = lsp_min(count, tail - head);
+                    UTEST_ASSERT(v.pop_front(data, count) == n);
+                    UTEST_ASSERT(memcmp(data, &buf[head], n * sizeof(int)) == 0);
+                    head       += n;
+                    break;
+                }
+                default:
+                    if ((rand() % 8) == 0)
+                    {
+                        v.clear();
+                        head        = N;
+                        tail        = N;
+                    }
+                    break;
+            }
+
+            check_random_access(v, &buf[head], tail - head);
+        }
+    }
+
     UTEST_MAIN
     {
         test_simple_single_operations();
@@ -854,6 +977,7 @@ UTEST_BEGIN("lltl", ddeque)
         test_bulk_add_operations();
         test_bulk_extract_operations();
         test_iterators();
+        test_random_access();
     }
 
 UTEST_END
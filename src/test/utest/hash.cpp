@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/pphash.h>
+#include <lsp-plug.in/lltl/ptrset.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+UTEST_BEGIN("lltl", hash)
+
+    void test_alignment()
+    {
+        uint8_t src[256], buf[256 + 8];
+
+        printf("Testing independence of data alignment...\n");
+        for (size_t i=0; i<sizeof(src); ++i)
+            src[i]      = uint8_t(rand());
+
+        for (size_t len=0; len<=sizeof(src); ++len)
+        {
+            const size_t hash = lltl::fast_hash_func(src, len);
+            for (size_t off=1; off<8; ++off)
+            {
+                memcpy(&buf[off], src, len);
+                UTEST_ASSERT_MSG(lltl::fast_hash_func(&buf[off], len) == hash,
+                    "Hash mismatch for length=%d, offset=%d", int(len), int(off));
+            }
+        }
+    }
+
+    void test_lengths()
+    {
+        uint8_t buf[256];
+        size_t hashes[sizeof(buf) + 1];
+
+        printf("Testing hashes of zero-filled data of different length...\n");
+        memset(buf, 0, sizeof(buf));
+        for (size_t len=0; len<=sizeof(buf); ++len)
+        {
+            hashes[len]     = lltl::fast_hash_func(buf, len);
+            for (size_t i=0; i<len; ++i)
+                UTEST_ASSERT_MSG(hashes[i] != hashes[len], "Collision of lengths %d and %d", int(i), int(len));
+        }
+    }
+
+    void test_bit_flips()
+    {
+        uint8_t buf[128];
+
+        printf("Testing hashes of data with single bit changed...\n");
+        for (size_t i=0; i<sizeof(buf); ++i)
+            buf[i]      = uint8_t(rand());
+
+        UTEST_FOREACH(len, 1, 3, 4, 7, 8, 15, 16, 17, 33, 48, 49, 96, 100)
+        {
+            const size_t hash   = lltl::fast_hash_func(buf, len);
+            for (size_t bit=0; bit < len * 8; ++bit)
+            {
+                buf[bit >> 3]  ^= uint8_t(1 << (bit & 7));
+                UTEST_ASSERT_MSG(lltl::fast_hash_func(buf, len) != hash,
+                    "Collision for length=%d, bit=%d", int(len), int(bit));
+                buf[bit >> 3]  ^= uint8_t(1 << (bit & 7));
+            }
+        }
+    }
+
+    void test_strings()
+    {
+        static const char *strings[] = { "", "a", "b", "ab", "abc", "preset", "preset_0", "preset_1",
+            "a long string which does not fit into single block of data processed by hash function" };
+
+        printf("Testing hashes of strings...\n");
+        for (size_t i=0; i<sizeof(strings)/sizeof(const char *); ++i)
+        {
+            const char *s = strings[i];
+            UTEST_ASSERT(lltl::fast_char_hash_func(s, sizeof(char)) == lltl::fast_hash_func(s, strlen(s)));
+            for (size_t j=0; j<i; ++j)
+                UTEST_ASSERT(lltl::fast_char_hash_func(s, sizeof(char)) != lltl::fast_char_hash_func(strings[j], sizeof(char)));
+        }
+    }
+
+    void test_containers()
+    {
+        char key[32];
+        lltl::fast_hash_spec<char> chash;
+        lltl::compare_spec<char> ccmp;
+        lltl::allocator_spec<char> calloc_spec;
+        lltl::fast_hash_spec<int> ihash;
+        lltl::compare_spec<int> icmp;
+        lltl::allocator_spec<int> ialloc;
+
+        lltl::pphash<char, char> h(chash, ccmp, calloc_spec);
+        lltl::pphash<int, int> hi(ihash, icmp, ialloc);
+
+        printf("Testing containers with fast hash functions...\n");
+        for (int i=0; i<10000; ++i)
+        {
+            snprintf(key, sizeof(key), "preset_%d", i);
+            UTEST_ASSERT(h.create(key, ::strdup(key)) != NULL);
+            UTEST_ASSERT(hi.create(&i, NULL) != NULL);
+        }
+
+        for (int i=0; i<10000; ++i)
+        {
+            snprintf(key, sizeof(key), "preset_%d", i);
+            const char *v = h.get(key);
+            UTEST_ASSERT(v != NULL);
+            UTEST_ASSERT(strcmp(v, key) == 0);
+            UTEST_ASSERT(hi.contains(&i));
+        }
+
+        lltl::parray<char> vv;
+        UTEST_ASSERT(h.values(&vv));
+        for (size_t i=0, n=vv.size(); i<n; ++i)
+            free(vv.uget(i));
+    }
+
+    void test_seeded()
+    {
+        char key[32];
+
+        printf("Testing seeded hash functions...\n");
+
+        // Unseeded interface should use plain hash function
+        lltl::fast_hash_spec<char> plain;
+        UTEST_ASSERT(plain.compute("preset", sizeof(char)) == lltl::fast_char_hash_func("preset", sizeof(char)));
+        UTEST_ASSERT(plain.seeded == NULL);
+
+        // Interface initialized as aggregate should not use seeded function
+        lltl::hash_iface agg = { lltl::fast_char_hash_func };
+        UTEST_ASSERT(agg.seeded == NULL);
+        UTEST_ASSERT(agg.seed == 0);
+        UTEST_ASSERT(agg.compute("preset", sizeof(char)) == lltl::fast_char_hash_func("preset", sizeof(char)));
+
+        // Explicit seeds should give reproducible results
+        lltl::seeded_hash_spec<char> s1(1), s2(1), s3(2);
+        UTEST_ASSERT(s1.compute("preset", sizeof(char)) == s2.compute("preset", sizeof(char)));
+        UTEST_ASSERT(s1.compute("preset", sizeof(char)) != s3.compute("preset", sizeof(char)));
+        UTEST_ASSERT(s1.compute("preset", sizeof(char)) == lltl::fast_seeded_char_hash_func("preset", sizeof(char), 1));
+        UTEST_ASSERT(s1.compute("preset", sizeof(char)) == lltl::fast_seeded_hash_func("preset", 6, 1));
+
+        lltl::seeded_hash_spec<int *> p1(1), p2(2);
+        UTEST_ASSERT(p1.compute(key, sizeof(int *)) == lltl::ptr_seeded_hash_func(key, sizeof(int *), 1));
+        UTEST_ASSERT(p1.compute(key, sizeof(int *)) != p2.compute(key, sizeof(int *)));
+
+        // Random seeds should differ
+        lltl::seeded_hash_spec<char> r1, r2;
+        UTEST_ASSERT(r1.seed != r2.seed);
+        UTEST_ASSERT(lltl::make_hash_seed() != lltl::make_hash_seed());
+
+        // Keys colliding for one seed should not collide for another seed
+        static const size_t mask = 0xfff;
+        const size_t target = s1.compute("preset_0", sizeof(char)) & mask;
+        size_t found = 0, spread = 0;
+        for (int i=1; (i < 0x400000) && (found < 16); ++i)
+        {
+            snprintf(key, sizeof(key), "preset_%d", i);
+            if ((s1.compute(key, sizeof(char)) & mask) != target)
+                continue;
+            ++found;
+            if ((s3.compute(key, sizeof(char)) & mask) != (s3.compute("preset_0", sizeof(char)) & mask))
+                ++spread;
+        }
+        printf("  found %d colliding keys, %d of them do not collide with another seed\n", int(found), int(spread));
+        UTEST_ASSERT(found == 16);
+        UTEST_ASSERT(spread >= 15);
+    }
+
+    void test_seeded_containers()
+    {
+        char key[32];
+        int items[0x100];
+        lltl::seeded_hash_spec<char> chash;
+        lltl::compare_spec<char> ccmp;
+        lltl::allocator_spec<char> calloc_spec;
+        lltl::seeded_hash_spec<void *> phash;
+
+        lltl::pphash<char, int> h(chash, ccmp, calloc_spec);
+        lltl::ptrset<int> ps(phash);
+
+        printf("Testing containers with seeded hash functions...\n");
+        for (int i=0; i<0x100; ++i)
+        {
+            snprintf(key, sizeof(key), "preset_%d", i);
+            UTEST_ASSERT(h.create(key, &items[i]) != NULL);
+            UTEST_ASSERT(ps.put(&items[i]));
+        }
+
+        for (int i=0; i<0x100; ++i)
+        {
+            snprintf(key, sizeof(key), "preset_%d", i);
+            UTEST_ASSERT(h.get(key) == &items[i]);
+            UTEST_ASSERT(ps.contains(&items[i]));
+        }
+        UTEST_ASSERT(h.get("preset") == NULL);
+    }
+
+    UTEST_MAIN
+    {
+        test_alignment();
+        test_lengths();
+        test_bit_flips();
+        test_strings();
+        test_containers();
+        test_seeded();
+        test_seeded_containers();
+    }
+
+UTEST_END;
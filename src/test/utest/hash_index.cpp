@@ -53,7 +53,7 @@ namespace lsp
         template <>
         struct hash_spec<payload_t>: public hash_iface
         {
-            inline hash_spec()
+            inline hash_spec(): hash_iface()
             {
                 hash        = payload_hash_func;
             }
@@ -352,10 +352,112 @@ UTEST_BEGIN("lltl", hash_index)
         }
     }
 
+    void test_batch()
+    {
+        lltl::hash_index<payload_t, payload_t> index;
+        payload_t *keys[0x1000];
+        payload_t *values[0x1000];
+        bool found[0x1000];
+        payload_t *dfl = make_payload(42);
+
+        // Lookup in empty index
+        for (size_t i=0; i<0x1000; ++i)
+            keys[i]     = make_payload(0x10000 + i);
+        UTEST_ASSERT(index.contains_n(0x1000, keys, found) == 0);
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(!found[i]);
+
+        // Fill index with even keys
+        for (size_t i=0; i<0x1000; i += 2)
+        {
+            payload_t *payload = make_payload(0x10000 + i);
+            UTEST_ASSERT(index.create(payload, make_payload(0x20000 + i)));
+        }
+
+        // Check batched calls
+        UTEST_ASSERT(index.get_n(0x1000, keys, values) == 0x800);
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(values[i] == ((i & 1) ? NULL : make_payload(0x20000 + i)));
+
+        UTEST_ASSERT(index.dget_n(0x1000, keys, values, dfl) == 0x800);
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(values[i] == ((i & 1) ? dfl : make_payload(0x20000 + i)));
+
+        UTEST_ASSERT(index.contains_n(0x1000, keys, found) == 0x800);
+        for (size_t i=0; i<0x1000; ++i)
+            UTEST_ASSERT(found[i] == !(i & 1));
+
+        // Single lookups should return default value too
+        UTEST_ASSERT(index.dget(make_payload(0x10001), dfl) == dfl);
+    }
+
+    void test_reserve()
+    {
+        lltl::hash_index<payload_t, payload_t> index;
+
+        printf("Testing reserve and shrink_to_fit...\n");
+
+        UTEST_ASSERT(index.reserve(0x1000));
+        const size_t cap = index.capacity();
+        UTEST_ASSERT(cap > 0);
+        UTEST_ASSERT(index.reserve(0x100));
+        UTEST_ASSERT(index.capacity() == cap);
+
+        // Perform insert/remove churn, the capacity should not change
+        for (size_t k=0; k<4; ++k)
+        {
+            for (size_t i=0; i<0x1000; ++i)
+            {
+                payload_t *payload = make_payload(0x10000 + i);
+                UTEST_ASSERT(index.create(payload, payload));
+            }
+            UTEST_ASSERT(index.size() == 0x1000);
+            UTEST_ASSERT(index.capacity() == cap);
+
+            for (size_t i=k & 1; i<0x1000; i += 2)
+            {
+                payload_t *payload = make_payload(0x10000 + i);
+                UTEST_ASSERT(index.remove(payload, NULL));
+            }
+            UTEST_ASSERT(index.size() == 0x800);
+
+            for (size_t i=0; i<0x1000; ++i)
+            {
+                payload_t *payload = make_payload(0x10000 + i);
+                UTEST_ASSERT(index.contains(payload) == ((i & 1) != (k & 1)));
+            }
+
+            index.clear();
+            UTEST_ASSERT(index.capacity() == cap);
+        }
+
+        // Shrink the collection
+        for (size_t i=0; i<0x20; ++i)
+        {
+            payload_t *payload = make_payload(0x10000 + i);
+            UTEST_ASSERT(index.create(payload, payload));
+        }
+        UTEST_ASSERT(index.shrink_to_fit());
+        UTEST_ASSERT(index.capacity() < cap);
+        UTEST_ASSERT(index.size() == 0x20);
+        for (size_t i=0; i<0x40; ++i)
+        {
+            payload_t *payload = make_payload(0x10000 + i);
+            UTEST_ASSERT(index.get(payload) == ((i < 0x20) ? payload : NULL));
+        }
+
+        // Shrink empty collection
+        index.clear();
+        UTEST_ASSERT(index.shrink_to_fit());
+        UTEST_ASSERT(index.capacity() == 0);
+    }
+
     UTEST_MAIN
     {
         test_reallocation();
         test_large();
+        test_reserve();
+        test_batch();
         test_iterator_partial();
         test_iterator_full();
     }
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/hstring.h>
+#include <lsp-plug.in/lltl/pphash.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+UTEST_BEGIN("lltl", hstring)
+
+    void test_basic()
+    {
+        printf("Testing basic functions...\n");
+
+        lltl::hstring *a = lltl::hstring_create("preset");
+        UTEST_ASSERT(a != NULL);
+        lsp_finally { lltl::hstring_free(a); };
+        UTEST_ASSERT(a->length == 6);
+        UTEST_ASSERT(strcmp(a->data, "preset") == 0);
+        UTEST_ASSERT(a->hash == lltl::fast_char_hash_func("preset", sizeof(char)));
+
+        lltl::hstring *b = lltl::hstring_create("preset_name", 6);
+        UTEST_ASSERT(b != NULL);
+        lsp_finally { lltl::hstring_free(b); };
+        UTEST_ASSERT(b->length == 6);
+        UTEST_ASSERT(strcmp(b->data, "preset") == 0);
+        UTEST_ASSERT(b->hash == a->hash);
+        UTEST_ASSERT(lltl::hstring_cmp_func(a, b, sizeof(lltl::hstring)) == 0);
+
+        lltl::hstring *c = static_cast<lltl::hstring *>(lltl::hstring_clone_func(a, sizeof(lltl::hstring)));
+        UTEST_ASSERT(c != NULL);
+        lsp_finally { lltl::hstring_free(c); };
+        UTEST_ASSERT(c != a);
+        UTEST_ASSERT(c->hash == a->hash);
+        UTEST_ASSERT(c->length == a->length);
+        UTEST_ASSERT(strcmp(c->data, a->data) == 0);
+
+        size_t buf[8];
+        UTEST_ASSERT(lltl::hstring_size(6) <= sizeof(buf));
+        lltl::hstring *d = lltl::hstring_init(buf, "preset", 6);
+        UTEST_ASSERT(d == reinterpret_cast<lltl::hstring *>(buf));
+        UTEST_ASSERT(lltl::hstring_cmp_func(a, d, sizeof(lltl::hstring)) == 0);
+        UTEST_ASSERT(lltl::hstring_hash_func(d, sizeof(lltl::hstring)) == a->hash);
+
+        lltl::hstring *e = lltl::hstring_create("", 0);
+        UTEST_ASSERT(e != NULL);
+        lsp_finally { lltl::hstring_free(e); };
+        UTEST_ASSERT(e->length == 0);
+        UTEST_ASSERT(e->data[0] == '\0');
+    }
+
+    void test_compare()
+    {
+        static const char *sorted[] = { "", "a", "b", "z", "aa", "ab", "ba", "abc", "preset" };
+        static const size_t count   = sizeof(sorted) / sizeof(const char *);
+        lltl::hstring *s[count];
+
+        printf("Testing ordering of strings...\n");
+        for (size_t i=0; i<count; ++i)
+        {
+            s[i]    = lltl::hstring_create(sorted[i]);
+            UTEST_ASSERT(s[i] != NULL);
+        }
+        lsp_finally {
+            for (size_t i=0; i<count; ++i)
+                lltl::hstring_free(s[i]);
+        };
+
+        for (size_t i=0; i<count; ++i)
+            for (size_t j=0; j<count; ++j)
+            {
+                const ssize_t res = lltl::hstring_cmp_func(s[i], s[j], sizeof(lltl::hstring));
+                if (i < j)
+                    UTEST_ASSERT_MSG(res < 0, "'%s' should precede '%s'", sorted[i], sorted[j]);
+                else if (i > j)
+                    UTEST_ASSERT_MSG(res > 0, "'%s' should follow '%s'", sorted[i], sorted[j]);
+                else
+                    UTEST_ASSERT(res == 0);
+            }
+    }
+
+    void test_hash(lltl::pphash<lltl::hstring, int> & h)
+    {
+        static const size_t count = 10000;
+        char key[32];
+        size_t buf[8];
+        int *items = static_cast<int *>(malloc(count * sizeof(int)));
+        UTEST_ASSERT(items != NULL);
+        lsp_finally { free(items); };
+
+        for (size_t i=0; i<count; ++i)
+        {
+            const int len       = snprintf(key, sizeof(key), "preset_%d", int(i));
+            lltl::hstring *k    = lltl::hstring_init(buf, key, len);
+            UTEST_ASSERT(h.create(k, &items[i]) != NULL);
+            UTEST_ASSERT(h.create(k, &items[i]) == NULL);
+        }
+        UTEST_ASSERT(h.size() == count);
+
+        for (size_t i=0; i<count; ++i)
+        {
+            const int len       = snprintf(key, sizeof(key), "preset_%d", int(i));
+            lltl::hstring *k    = lltl::hstring_init(buf, key, len);
+            UTEST_ASSERT(h.get(k) == &items[i]);
+
+            // The stored key is a copy
+            lltl::hstring *sk   = h.key(k);
+            UTEST_ASSERT(sk != NULL);
+            UTEST_ASSERT(sk != k);
+            UTEST_ASSERT(sk->length == size_t(len));
+            UTEST_ASSERT(strcmp(sk->data, key) == 0);
+        }
+
+        lltl::hstring *k    = lltl::hstring_init(buf, "preset_", 7);
+        UTEST_ASSERT(h.get(k) == NULL);
+
+        for (size_t i=0; i<count; i += 2)
+        {
+            const int len       = snprintf(key, sizeof(key), "preset_%d", int(i));
+            lltl::hstring *k    = lltl::hstring_init(buf, key, len);
+            UTEST_ASSERT(h.remove(k, NULL));
+        }
+        UTEST_ASSERT(h.size() == count / 2);
+    }
+
+    void test_containers()
+    {
+        printf("Testing hash with string keys...\n");
+        lltl::pphash<lltl::hstring, int> h;
+        test_hash(h);
+
+        printf("Testing hash with seeded string keys...\n");
+        lltl::seeded_hash_spec<lltl::hstring> hash;
+        lltl::compare_spec<lltl::hstring> cmp;
+        lltl::allocator_spec<lltl::hstring> alloc;
+        lltl::pphash<lltl::hstring, int> sh(hash, cmp, alloc);
+        test_hash(sh);
+    }
+
+    UTEST_MAIN
+    {
+        test_basic();
+        test_compare();
+        test_containers();
+    }
+
+UTEST_END;
@@ -0,0 +1,251 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/mpmc_queue.h>
+
+#include "../helpers/thread.h"
+
+namespace
+{
+    static constexpr size_t PRODUCERS       = 4;
+    static constexpr size_t CONSUMERS       = 3;
+    static constexpr size_t ITEMS           = 100000;
+    static constexpr size_t BATCH           = 32;
+}
+
+UTEST_BEGIN("lltl", mpmc_queue)
+
+    typedef struct job_t
+    {
+        uint32_t    id;
+        double      value;
+    } job_t;
+
+    typedef struct stress_t
+    {
+        lltl::mpmc_queue<uint32_t> *queue;
+        uatomic_t          *hits;       // Number of times each element has been popped
+        uatomic_t           popped;     // Overall number of popped elements
+        uatomic_t           errors;     // Number of elements popped out of per-producer order
+    } stress_t;
+
+    typedef struct worker_t
+    {
+        stress_t           *stress;
+        uint32_t            id;
+    } worker_t;
+
+    static void producer_main(void *arg)
+    {
+        worker_t *w         = static_cast<worker_t *>(arg);
+        lltl::mpmc_queue<uint32_t> *q = w->stress->queue;
+        uint32_t buf[BATCH];
+        uint32_t seed       = w->id + 1;
+        const uint32_t base = w->id * ITEMS;
+
+        for (uint32_t sent = 0; sent < ITEMS; )
+        {
+            seed                = seed * 1103515245 + 12345;
+            const uint32_t n    = lsp_min(uint32_t((seed >> 16) % BATCH) + 1, uint32_t(ITEMS - sent));
+            for (uint32_t i=0; i<n; ++i)
+                buf[i]              = base + sent + i;
+
+            // The queue may accept only part of the batch
+            for (uint32_t off = 0; off < n; )
+            {
+                const size_t k      = q->push(&buf[off], n - off);
+                if (k == 0)
+                    lltl::test::thread::yield();
+                off                += k;
+            }
+            sent               += n;
+        }
+    }
+
+    static void consumer_main(void *arg)
+    {
+        worker_t *w         = static_cast<worker_t *>(arg);
+        stress_t *s         = w->stress;
+        uint32_t buf[BATCH];
+        uint32_t next[PRODUCERS];
+        for (size_t i=0; i<PRODUCERS; ++i)
+            next[i]             = 0;
+
+        while (size_t(atomic_load(&s->popped)) < PRODUCERS * ITEMS)
+        {
+            const size_t n      = s->queue->pop(buf, BATCH);
+            if (n == 0)
+            {
+                lltl::test::thread::yield();
+                continue;
+            }
+
+            for (size_t i=0; i<n; ++i)
+            {
+                // Elements of each producer should come in order of pushing
+                const uint32_t v    = buf[i];
+                const uint32_t p    = v / ITEMS;
+                const uint32_t seq  = v % ITEMS;
+                if ((p >= PRODUCERS) || (seq < next[p]))
+                {
+                    atomic_add(&s->errors, 1);
+                    continue;
+                }
+                next[p]             = seq + 1;
+                atomic_add(&s->hits[v], 1);
+            }
+            atomic_add(&s->popped, n);
+        }
+    }
+
+    void test_single()
+    {
+        printf("Testing single element operations...\n");
+
+        lltl::mpmc_queue<job_t> q;
+        job_t job;
+
+        // Queue is not initialized
+        UTEST_ASSERT(q.capacity() == 0);
+        UTEST_ASSERT(!q.push(job));
+        UTEST_ASSERT(!q.pop(job));
+
+        UTEST_ASSERT(q.init(100));
+        UTEST_ASSERT(q.capacity() == 128);
+        UTEST_ASSERT(q.is_empty());
+
+        for (uint32_t round=0; round<4; ++round)
+        {
+            // Fill the queue
+            for (uint32_t i=0; i<q.capacity(); ++i)
+            {
+                job.id      = round * 1000 + i;
+                job.value   = i * 0.25;
+                UTEST_ASSERT(q.push(job));
+                UTEST_ASSERT(q.size() == i + 1);
+            }
+            UTEST_ASSERT(!q.push(job));
+
+            // Drain the queue
+            for (uint32_t i=0; i<q.capacity(); ++i)
+            {
+                UTEST_ASSERT(q.pop(job));
+                UTEST_ASSERT(job.id == round * 1000 + i);
+                UTEST_ASSERT(job.value == i * 0.25);
+            }
+            UTEST_ASSERT(!q.pop(job));
+            UTEST_ASSERT(q.is_empty());
+        }
+    }
+
+    void test_bulk()
+    {
+        printf("Testing bulk operations...\n");
+
+        lltl::mpmc_queue<uint32_t> q;
+        uint32_t buf[100];
+        uint32_t pushed = 0, popped = 0;
+
+        UTEST_ASSERT(q.init(64));
+        UTEST_ASSERT(q.push(buf, 0) == 0);
+        UTEST_ASSERT(q.pop(buf, 10) == 0);
+
+        for (size_t iter=0; iter<1000; ++iter)
+        {
+            // Push random number of elements
+            const size_t n_push = rand() % 100;
+            const size_t free   = q.capacity() - q.size();
+            for (size_t i=0; i<n_push; ++i)
+                buf[i]      = pushed + i;
+            const size_t n      = q.push(buf, n_push);
+            UTEST_ASSERT(n == lsp_min(n_push, free));
+            pushed     += n;
+            UTEST_ASSERT(q.size() == pushed - popped);
+
+            // Pop random number of elements
+            const size_t n_pop  = rand() % 100;
+            const size_t k      = q.pop(buf, n_pop);
+            UTEST_ASSERT(k == lsp_min(n_pop, size_t(pushed - popped)));
+            for (size_t i=0; i<k; ++i)
+                UTEST_ASSERT(buf[i] == popped + i);
+            popped     += k;
+            UTEST_ASSERT(q.size() == pushed - popped);
+        }
+
+        // Re-initialize the queue
+        UTEST_ASSERT(q.init(16));
+        UTEST_ASSERT(q.capacity() == 16);
+        UTEST_ASSERT(q.is_empty());
+
+        q.flush();
+        UTEST_ASSERT(q.capacity() == 0);
+    }
+
+    void test_stress()
+    {
+        printf("Testing %d producers and %d consumers...\n", int(PRODUCERS), int(CONSUMERS));
+
+        lltl::mpmc_queue<uint32_t> q;
+        UTEST_ASSERT(q.init(256));
+
+        stress_t s;
+        s.queue     = &q;
+        s.hits      = static_cast<uatomic_t *>(malloc(PRODUCERS * ITEMS * sizeof(uatomic_t)));
+        UTEST_ASSERT(s.hits != NULL);
+        lsp_finally { free(s.hits); };
+        for (size_t i=0; i<PRODUCERS * ITEMS; ++i)
+            s.hits[i]   = 0;
+        s.popped    = 0;
+        s.errors    = 0;
+
+        worker_t workers[PRODUCERS + CONSUMERS];
+        lltl::test::thread threads[PRODUCERS + CONSUMERS];
+        for (size_t i=0; i<PRODUCERS + CONSUMERS; ++i)
+        {
+            workers[i].stress   = &s;
+            workers[i].id       = (i < PRODUCERS) ? i : i - PRODUCERS;
+        }
+        for (size_t i=0; i<CONSUMERS; ++i)
+            UTEST_ASSERT(threads[PRODUCERS + i].start(consumer_main, &workers[PRODUCERS + i]));
+        for (size_t i=0; i<PRODUCERS; ++i)
+            UTEST_ASSERT(threads[i].start(producer_main, &workers[i]));
+        for (size_t i=0; i<PRODUCERS + CONSUMERS; ++i)
+            threads[i].join();
+
+        // Each element should be popped exactly once
+        UTEST_ASSERT_MSG(s.errors == 0, "%d elements popped out of order", int(s.errors));
+        UTEST_ASSERT(size_t(s.popped) == PRODUCERS * ITEMS);
+        for (size_t i=0; i<PRODUCERS * ITEMS; ++i)
+            UTEST_ASSERT_MSG(s.hits[i] == 1, "Element %d has been popped %d times", int(i), int(s.hits[i]));
+        UTEST_ASSERT(q.is_empty());
+    }
+
+    UTEST_MAIN
+    {
+        test_single();
+        test_bulk();
+        test_stress();
+    }
+
+UTEST_END
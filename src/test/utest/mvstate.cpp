@@ -0,0 +1,358 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/common/atomic.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/mvstate.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+#include "../helpers/thread.h"
+
+namespace
+{
+    static constexpr size_t SNAPSHOTS       = 20000;
+    static constexpr size_t READERS         = 4;
+    static constexpr size_t PAYLOAD         = 16;
+    static constexpr uint32_t MAGIC_ALIVE   = 0x600dcafe;
+    static constexpr uint32_t MAGIC_DEAD    = 0xdeadbeef;
+}
+
+UTEST_BEGIN("lltl", mvstate)
+
+    typedef struct state_t
+    {
+        size_t id;
+        size_t check;
+    } state_t;
+
+    static void deleter1(state_t *st)
+    {
+        ++st->check;
+    }
+
+    static void deleter2(state_t *st, size_t *value)
+    {
+        st->check      += *value;
+    }
+
+    typedef struct snapshot_t
+    {
+        uint32_t    magic;              // Poisoned by deleter
+        uint32_t    id;                 // Identifier of the snapshot
+        uatomic_t   holders;            // Number of readers currently holding the snapshot
+        uatomic_t   deleted;            // Number of times the snapshot has been deleted
+        uint32_t    payload[PAYLOAD];   // Data that should remain consistent while snapshot is held
+    } snapshot_t;
+
+    typedef struct concurrent_t
+    {
+        lltl::mvstate<snapshot_t>  *state;
+        uatomic_t   done;               // Publisher has finished
+        uatomic_t   violations;         // Number of snapshots deleted while being held
+        uatomic_t   corrupted;          // Number of corrupted snapshots observed by readers
+        uatomic_t   reordered;          // Number of snapshots observed out of publishing order
+        uatomic_t   reads;              // Overall number of acquired snapshots
+    } concurrent_t;
+
+    static void poison_snapshot(snapshot_t *st, concurrent_t *ctx)
+    {
+        if (atomic_load(&st->holders) != 0)
+            atomic_add(&ctx->violations, 1);
+
+        st->magic       = MAGIC_DEAD;
+        for (size_t i=0; i<PAYLOAD; ++i)
+            st->payload[i]  = 0;
+        atomic_add(&st->deleted, 1);
+    }
+
+    static bool check_snapshot(const snapshot_t *st)
+    {
+        if (st->magic != MAGIC_ALIVE)
+            return false;
+        for (size_t i=0; i<PAYLOAD; ++i)
+            if (st->payload[i] != st->id * PAYLOAD + i)
+                return false;
+        return true;
+    }
+
+    static void reader_main(void *arg)
+    {
+        concurrent_t *ctx   = static_cast<concurrent_t *>(arg);
+        lltl::mvstate<snapshot_t>::reader_t *r = ctx->state->attach();
+        if (r == NULL)
+        {
+            atomic_add(&ctx->corrupted, 1);
+            return;
+        }
+
+        uint32_t last       = 0;
+        while (!atomic_load(&ctx->done))
+        {
+            snapshot_t *st      = ctx->state->acquire(r);
+            if (st != NULL)
+            {
+                atomic_add(&st->holders, 1);
+
+                // Snapshot should remain intact for the whole time it is held
+                for (size_t i=0; i<4; ++i)
+                {
+                    if (!check_snapshot(st))
+                    {
+                        atomic_add(&ctx->corrupted, 1);
+                        break;
+                    }
+                    lltl::test::thread::yield();
+                }
+                if (st->id < last)
+                    atomic_add(&ctx->reordered, 1);
+                last                = st->id;
+
+                atomic_add(&st->holders, -1);
+                atomic_add(&ctx->reads, 1);
+            }
+            ctx->state->release(r);
+        }
+
+        ctx->state->detach(r);
+    }
+
+    bool init_states(lltl::darray<state_t> & states)
+    {
+        for (size_t i=0; i<10; ++i)
+        {
+            state_t *st = states.add();
+            if (st == NULL)
+                return false;
+
+            st->id      = i + 1;
+            st->check   = 0;
+        }
+
+        return true;
+    }
+
+    void test_publish_no_readers()
+    {
+        printf("Testing test_publish_no_readers...\n");
+
+        lltl::darray<state_t> st;
+        UTEST_ASSERT(init_states(st));
+
+        {
+            lltl::mvstate<state_t> state(deleter1);
+
+            UTEST_ASSERT(state.get() == NULL);
+            for (size_t i=0; i<5; ++i)
+            {
+                UTEST_ASSERT(state.publish(st[i]));
+                UTEST_ASSERT(state.get() == st[i]);
+                UTEST_ASSERT(st[i]->check == 0);
+                if (i > 0)
+                    UTEST_ASSERT(st[i-1]->check == 1);
+            }
+        }
+
+        // Last state should be destroyed by destructor
+        for (size_t i=0; i<5; ++i)
+            UTEST_ASSERT(st[i]->check == 1);
+        for (size_t i=5; i<st.size(); ++i)
+            UTEST_ASSERT(st[i]->check == 0);
+    }
+
+    void test_snapshots()
+    {
+        printf("Testing test_snapshots...\n");
+
+        lltl::darray<state_t> st;
+        UTEST_ASSERT(init_states(st));
+        size_t value = 10;
+
+        {
+            lltl::mvstate<state_t> state(deleter2, &value);
+
+            lltl::mvstate<state_t>::reader_t *r1 = state.attach();
+            lltl::mvstate<state_t>::reader_t *r2 = state.attach();
+            UTEST_ASSERT(r1 != NULL);
+            UTEST_ASSERT(r2 != NULL);
+            UTEST_ASSERT(r1 != r2);
+
+            UTEST_ASSERT(state.acquire(r1) == NULL);
+            state.release(r1);
+
+            // Reader 1 holds the first state
+            UTEST_ASSERT(state.publish(st[0]));
+            UTEST_ASSERT(state.acquire(r1) == st[0]);
+
+            // Publishing is never refused while reader holds the snapshot
+            UTEST_ASSERT(state.publish(st[1]));
+            UTEST_ASSERT(state.acquire(r2) == st[1]);
+            UTEST_ASSERT(state.publish(st[2]));
+            UTEST_ASSERT(state.publish(st[3]));
+            UTEST_ASSERT(state.get() == st[3]);
+
+            UTEST_ASSERT(st[0]->check == 0);
+            UTEST_ASSERT(st[1]->check == 0);
+            UTEST_ASSERT(st[2]->check == 10);
+            UTEST_ASSERT(st[3]->check == 0);
+
+            // Snapshot of reader 1 is destroyed after release
+            state.release(r1);
+            UTEST_ASSERT(st[0]->check == 0);
+            state.gc();
+            UTEST_ASSERT(st[0]->check == 10);
+            UTEST_ASSERT(st[1]->check == 0);
+
+            // Acquiring new snapshot releases the previous one
+            UTEST_ASSERT(state.acquire(r2) == st[3]);
+            UTEST_ASSERT(state.publish(st[4]));
+            UTEST_ASSERT(st[1]->check == 10);
+            UTEST_ASSERT(st[3]->check == 0);
+
+            state.detach(r1);
+            state.detach(r2);
+            state.gc();
+            UTEST_ASSERT(st[3]->check == 10);
+            UTEST_ASSERT(st[4]->check == 0);
+        }
+
+        for (size_t i=0; i<5; ++i)
+            UTEST_ASSERT(st[i]->check == 10);
+    }
+
+    void test_retired_on_clear()
+    {
+        printf("Testing test_retired_on_clear...\n");
+
+        lltl::darray<state_t> st;
+        UTEST_ASSERT(init_states(st));
+
+        {
+            lltl::mvstate<state_t> state(deleter1);
+            lltl::mvstate<state_t>::reader_t *r = state.attach();
+            UTEST_ASSERT(r != NULL);
+
+            UTEST_ASSERT(state.publish(st[0]));
+            UTEST_ASSERT(state.acquire(r) == st[0]);
+            UTEST_ASSERT(state.publish(st[1]));
+            UTEST_ASSERT(st[0]->check == 0);
+
+            // Destructor destroys both current and retired states
+        }
+
+        UTEST_ASSERT(st[0]->check == 1);
+        UTEST_ASSERT(st[1]->check == 1);
+    }
+
+    void test_reader_slots()
+    {
+        printf("Testing test_reader_slots...\n");
+
+        lltl::mvstate<state_t> state;
+        lltl::mvstate<state_t>::reader_t *r[lltl::raw_mvstate_readers];
+
+        for (size_t i=0; i<lltl::raw_mvstate_readers; ++i)
+        {
+            r[i]        = state.attach();
+            UTEST_ASSERT(r[i] != NULL);
+        }
+        UTEST_ASSERT(state.attach() == NULL);
+
+        state.detach(r[3]);
+        lltl::mvstate<state_t>::reader_t *x = state.attach();
+        UTEST_ASSERT(x == r[3]);
+        UTEST_ASSERT(state.attach() == NULL);
+
+        for (size_t i=0; i<lltl::raw_mvstate_readers; ++i)
+            state.detach(r[i]);
+    }
+
+    void test_concurrent()
+    {
+        printf("Testing %d concurrent readers with publisher...\n", int(READERS));
+
+        snapshot_t *st = static_cast<snapshot_t *>(malloc(SNAPSHOTS * sizeof(snapshot_t)));
+        UTEST_ASSERT(st != NULL);
+        lsp_finally { free(st); };
+
+        for (size_t i=0; i<SNAPSHOTS; ++i)
+        {
+            snapshot_t *s   = &st[i];
+            s->magic        = MAGIC_ALIVE;
+            s->id           = i;
+            s->holders      = 0;
+            s->deleted      = 0;
+            for (size_t j=0; j<PAYLOAD; ++j)
+                s->payload[j]   = i * PAYLOAD + j;
+        }
+
+        concurrent_t ctx;
+        ctx.done        = 0;
+        ctx.violations  = 0;
+        ctx.corrupted   = 0;
+        ctx.reordered   = 0;
+        ctx.reads       = 0;
+
+        {
+            lltl::mvstate<snapshot_t> state(poison_snapshot, &ctx);
+            ctx.state       = &state;
+
+            lltl::test::thread readers[READERS];
+            for (size_t i=0; i<READERS; ++i)
+                UTEST_ASSERT(readers[i].start(reader_main, &ctx));
+
+            // Publish snapshots as fast as possible
+            for (size_t i=0; i<SNAPSHOTS; ++i)
+            {
+                UTEST_ASSERT(state.publish(&st[i]));
+                if (!(i & 0x0f))
+                {
+                    state.gc();
+                    lltl::test::thread::yield();
+                }
+            }
+            atomic_store(&ctx.done, 1);
+
+            for (size_t i=0; i<READERS; ++i)
+                readers[i].join();
+            UTEST_ASSERT(state.get() == &st[SNAPSHOTS - 1]);
+        }
+
+        printf("  performed %d reads\n", int(ctx.reads));
+        UTEST_ASSERT_MSG(ctx.violations == 0, "%d snapshots have been deleted while held", int(ctx.violations));
+        UTEST_ASSERT_MSG(ctx.corrupted == 0, "%d corrupted snapshots have been observed", int(ctx.corrupted));
+        UTEST_ASSERT_MSG(ctx.reordered == 0, "%d snapshots have been observed out of order", int(ctx.reordered));
+
+        // Each snapshot should be deleted exactly once
+        for (size_t i=0; i<SNAPSHOTS; ++i)
+            UTEST_ASSERT_MSG(st[i].deleted == 1, "Snapshot %d has been deleted %d times", int(i), int(st[i].deleted));
+    }
+
+    UTEST_MAIN
+    {
+        test_publish_no_readers();
+        test_snapshots();
+        test_retired_on_clear();
+        test_reader_slots();
+        test_concurrent();
+    }
+
+UTEST_END
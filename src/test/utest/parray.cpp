@@ -22,6 +22,8 @@
 #include <lsp-plug.in/lltl/parray.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
+#include "../helpers/executor.h"
+
 namespace
 {
     static ssize_t test_int_cmp(const int *a, const int *b)
@@ -779,6 +781,78 @@ UTEST_BEGIN("lltl", parray)
         printf("\n");
     }
 
+    void test_rsort()
+    {
+        static const size_t N = 10000;
+        printf("Testing rsort...\n");
+
+        // Sort pointers by referenced values
+        int *v = static_cast<int *>(malloc(N * sizeof(int)));
+        UTEST_ASSERT(v != NULL);
+        lsp_finally { free(v); };
+
+        lltl::parray<int> a;
+        for (size_t i=0; i<N; ++i)
+        {
+            v[i]    = int(rand()) - RAND_MAX/2;
+            UTEST_ASSERT(a.add(&v[i]));
+            if ((i % 1000) == 0)
+                UTEST_ASSERT(a.add(static_cast<int *>(NULL)));
+        }
+        UTEST_ASSERT(a.rsort());
+
+        // NULL pointers should be placed first
+        size_t nulls = 0;
+        while ((nulls < a.size()) && (a.uget(nulls) == NULL))
+            ++nulls;
+        UTEST_ASSERT(nulls == N / 1000);
+        UTEST_ASSERT(a.size() == N + nulls);
+
+        for (size_t i=nulls+1, n=a.size(); i<n; ++i)
+        {
+            UTEST_ASSERT(a.uget(i) != NULL);
+            UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+        }
+    }
+
+    void test_psort()
+    {
+        static const size_t N = 100000;
+        printf("Testing pqsort and pssort...\n");
+
+        lltl::executor_iface executor;
+        executor.workers    = 4;
+        executor.execute    = lltl::test::execute_reverse;
+
+        int *v = static_cast<int *>(malloc(N * sizeof(int)));
+        UTEST_ASSERT(v != NULL);
+        lsp_finally { free(v); };
+
+        lltl::parray<int> a;
+        for (size_t i=0; i<N; ++i)
+        {
+            v[i]    = rand() % 1000;
+            UTEST_ASSERT(a.add(&v[i]));
+        }
+
+        a.pqsort(test_int_cmp, &executor);
+        UTEST_ASSERT(a.size() == N);
+        for (size_t i=1; i<N; ++i)
+            UTEST_ASSERT(*a.uget(i-1) <= *a.uget(i));
+
+        // Stable sort should keep order of pointers for equal values
+        for (size_t i=0; i<N; ++i)
+            *a.pget(i)  = &v[i];
+        a.pssort(test_int_cmp, &executor);
+        for (size_t i=1; i<N; ++i)
+        {
+            int *p1 = a.uget(i-1), *p2 = a.uget(i);
+            UTEST_ASSERT(*p1 <= *p2);
+            if (*p1 == *p2)
+                UTEST_ASSERT(p1 < p2);
+        }
+    }
+
     void test_iterator()
     {
         static const ssize_t N = 8;
@@ -911,6 +985,8 @@ UTEST_BEGIN("lltl", parray)
         test_multiple_parray();
         test_xswap();
         test_sort();
+        test_rsort();
+        test_psort();
         test_iterator();
     }
 
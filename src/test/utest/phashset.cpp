@@ -316,10 +316,75 @@ UTEST_BEGIN("lltl", phashset)
             free(*it);
     }
 
+    void test_reserve()
+    {
+        lltl::phashset<item_t> s;
+        lltl::parray<item_t> items;
+
+        printf("Testing reserve and tuple reuse...\n");
+
+        for (size_t i=0; i<1000; ++i)
+        {
+            item_t *item = new item_t(i);
+            UTEST_ASSERT(items.add(item));
+        }
+
+        UTEST_ASSERT(s.reserve(1000));
+        const size_t cap = s.capacity();
+        UTEST_ASSERT(cap > 0);
+        UTEST_ASSERT(s.reserve(10));
+        UTEST_ASSERT(s.capacity() == cap);
+
+        // Perform add/remove churn
+        for (size_t k=0; k<10; ++k)
+        {
+            for (size_t i=0; i<1000; ++i)
+                UTEST_ASSERT(s.create(items.uget(i)));
+            UTEST_ASSERT(s.size() == 1000);
+
+            for (size_t i=0; i<1000; ++i)
+                UTEST_ASSERT(s.contains(items.uget(i)));
+
+            for (size_t i=k & 1; i<1000; i += 2)
+                UTEST_ASSERT(s.toggle(items.uget(i)));
+            UTEST_ASSERT(s.size() == 500);
+
+            for (size_t i=0; i<1000; ++i)
+                UTEST_ASSERT(s.contains(items.uget(i)) == ((i & 1) != (k & 1)));
+
+            if (k & 1)
+                s.clear();
+            else
+            {
+                for (size_t i=(k & 1) ^ 1; i<1000; i += 2)
+                    UTEST_ASSERT(s.remove(items.uget(i)));
+            }
+            UTEST_ASSERT(s.is_empty());
+        }
+
+        UTEST_ASSERT(s.capacity() == cap);
+
+        // Shrink the set
+        for (size_t i=0; i<10; ++i)
+            UTEST_ASSERT(s.create(items.uget(i)));
+        UTEST_ASSERT(s.shrink_to_fit());
+        UTEST_ASSERT(s.capacity() < cap);
+        for (size_t i=0; i<20; ++i)
+            UTEST_ASSERT(s.contains(items.uget(i)) == (i < 10));
+
+        s.flush();
+        UTEST_ASSERT(s.create(items.uget(0)));
+        UTEST_ASSERT(s.size() == 1);
+
+        for (size_t i=0; i<items.size(); ++i)
+            delete items.uget(i);
+    }
+
     UTEST_MAIN
     {
         test_basic();
         test_large();
+        test_reserve();
         test_iterator(10);
         test_iterator(100);
         test_iterator(1000);
@@ -553,10 +553,261 @@ UTEST_BEGIN("lltl", pphash)
             free(*it);
     }
 
+    void test_batch()
+    {
+        char buf[32];
+        lltl::pphash<char, char> h;
+        lltl::parray<char> vk;
+        char *values[100];
+        bool found[100];
+
+        printf("Testing batched lookup...\n");
+
+        // Lookup in empty hash
+        const char *missing[] = { "a", NULL, "b" };
+        values[0] = values[1] = values[2] = buf;
+        UTEST_ASSERT(h.get_n(3, missing, values) == 0);
+        UTEST_ASSERT((values[0] == NULL) && (values[1] == NULL) && (values[2] == NULL));
+
+        // Fill hash with even keys
+        for (size_t i=0; i<1000; i += 2)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.put(buf, ::strdup(buf), NULL));
+        }
+        UTEST_ASSERT(h.put(NULL, ::strdup("null"), NULL));
+
+        // Form batch of keys, every third key does not exist, last key is NULL
+        for (size_t i=0; i<99; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i * 3));
+            UTEST_ASSERT(vk.add(::strdup(buf)));
+        }
+        UTEST_ASSERT(vk.add(static_cast<char *>(NULL)));
+        const char * const *keys = vk.array();
+
+        // Check batched calls
+        UTEST_ASSERT(h.get_n(100, keys, values) == 51);
+        for (size_t i=0; i<99; ++i)
+        {
+            if ((i * 3) & 1)
+                UTEST_ASSERT(values[i] == NULL);
+            else
+            {
+                UTEST_ASSERT(values[i] != NULL);
+                UTEST_ASSERT(::strcmp(values[i], keys[i]) == 0);
+            }
+        }
+        UTEST_ASSERT(::strcmp(values[99], "null") == 0);
+
+        UTEST_ASSERT(h.dget_n(100, keys, values, buf) == 51);
+        for (size_t i=0; i<99; ++i)
+            UTEST_ASSERT((values[i] == buf) == bool((i * 3) & 1));
+
+        UTEST_ASSERT(h.contains_n(100, keys, found) == 51);
+        for (size_t i=0; i<99; ++i)
+            UTEST_ASSERT(found[i] == !((i * 3) & 1));
+        UTEST_ASSERT(found[99]);
+        UTEST_ASSERT(h.contains_n(100, keys, NULL) == 51);
+
+        // Cleanup
+        for (size_t i=0; i<vk.size(); ++i)
+            ::free(vk.uget(i));
+        for (lltl::iterator<char> it = h.values(); it; ++it)
+            ::free(*it);
+    }
+
+    void test_incremental()
+    {
+        char buf[32], *s;
+        lltl::pphash<char, char> h;
+        lltl::parray<char> vk, vv;
+        size_t rehashes = 0;
+
+        printf("Testing incremental rehash...\n");
+        h.set_rehash_step(1);
+        UTEST_ASSERT(h.rehash_step() == 1);
+
+        for (size_t i=0; i<100000; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            const bool was_rehashing = h.rehashing();
+            UTEST_ASSERT(h.put(buf, ::strdup(buf), NULL));
+
+            if ((!was_rehashing) && (h.rehashing()))
+            {
+                ++rehashes;
+
+                // Validate contents while old and new bins coexist
+                for (size_t j=0; j<=i; j += 7)
+                {
+                    ::snprintf(buf, sizeof(buf), "%08lx", long(j));
+                    UTEST_ASSERT(s = h.get(buf));
+                    UTEST_ASSERT(::strcmp(s, buf) == 0);
+                }
+                UTEST_ASSERT(h.keys(&vk));
+                UTEST_ASSERT(h.items(&vk, &vv));
+                UTEST_ASSERT(vk.size() == i + 1);
+                UTEST_ASSERT(vv.size() == i + 1);
+            }
+        }
+        UTEST_ASSERT(rehashes > 0);
+        UTEST_ASSERT(h.size() == 100000);
+
+        // Remove odd items
+        for (size_t i=1; i<100000; i += 2)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.remove(buf, &s));
+            UTEST_ASSERT(::strcmp(s, buf) == 0);
+            ::free(s);
+        }
+        UTEST_ASSERT(!h.rehashing());
+        UTEST_ASSERT(h.capacity() == 0x8000);
+
+        // Validate contents
+        for (size_t i=0; i<100000; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            s = h.get(buf);
+            if (i & 1)
+                UTEST_ASSERT(s == NULL);
+            else
+            {
+                UTEST_ASSERT(s != NULL);
+                UTEST_ASSERT(::strcmp(s, buf) == 0);
+            }
+        }
+
+        // Iterator should complete the pending rehash
+        for (size_t i=100000; h.size() <= 0x20000; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.put(buf, ::strdup(buf), NULL));
+        }
+        UTEST_ASSERT(h.rehashing());
+
+        // Lookups should not advance the pending rehash
+        for (size_t i=0; i<h.capacity(); ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.contains(buf) == !(i & 1));
+        }
+        UTEST_ASSERT(h.rehashing());
+
+        size_t count = 0;
+        for (lltl::iterator<char> it = h.values(); it; ++it)
+        {
+            ::free(*it);
+            ++count;
+        }
+        UTEST_ASSERT(!h.rehashing());
+        UTEST_ASSERT(count == h.size());
+
+        // Clear during rehash
+        h.clear();
+        UTEST_ASSERT(h.size() == 0);
+        size_t limit = h.capacity() * 4;
+        for (size_t i=0; i<=limit; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.put(buf, NULL, NULL));
+        }
+        UTEST_ASSERT(h.capacity() == limit / 2);
+        UTEST_ASSERT(h.rehashing());
+        h.clear();
+        UTEST_ASSERT(!h.rehashing());
+        UTEST_ASSERT(h.is_empty());
+        UTEST_ASSERT(h.get("00000000") == NULL);
+
+        // Disabling incremental mode completes the rehash
+        limit = h.capacity() * 4;
+        for (size_t i=0; i<=limit; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "%08lx", long(i));
+            UTEST_ASSERT(h.put(buf, NULL, NULL));
+        }
+        UTEST_ASSERT(h.rehashing());
+        h.set_rehash_step(0);
+        UTEST_ASSERT(!h.rehashing());
+        UTEST_ASSERT(h.size() == limit + 1);
+        ::snprintf(buf, sizeof(buf), "%08lx", long(limit));
+        UTEST_ASSERT(h.contains(buf));
+    }
+
+    void test_reserve()
+    {
+        char buf[32], *s;
+        lltl::pphash<char, char> h;
+
+        printf("Testing reserve and tuple reuse...\n");
+        UTEST_ASSERT(h.reserve(1000));
+        const size_t cap = h.capacity();
+        UTEST_ASSERT(cap > 0);
+        UTEST_ASSERT(h.reserve(100));
+        UTEST_ASSERT(h.capacity() == cap);
+
+        // Perform insert/remove churn
+        for (size_t k=0; k<10; ++k)
+        {
+            for (size_t i=0; i<1000; ++i)
+            {
+                ::snprintf(buf, sizeof(buf), "%d-%d", int(k), int(i));
+                UTEST_ASSERT(h.create(buf, NULL));
+            }
+            UTEST_ASSERT(h.size() == 1000);
+
+            for (size_t i=0; i<1000; i += 2)
+            {
+                ::snprintf(buf, sizeof(buf), "%d-%d", int(k), int(i));
+                UTEST_ASSERT(h.remove(buf, NULL));
+            }
+            UTEST_ASSERT(h.size() == 500);
+
+            for (size_t i=0; i<1000; ++i)
+            {
+                ::snprintf(buf, sizeof(buf), "%d-%d", int(k), int(i));
+                UTEST_ASSERT(h.contains(buf) == bool(i & 1));
+            }
+
+            UTEST_ASSERT(h.capacity() == cap);
+            h.clear();
+            UTEST_ASSERT(h.is_empty());
+        }
+
+        // Shrink the hash
+        for (size_t i=0; i<10; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "key-%d", int(i));
+            UTEST_ASSERT(h.create(buf, NULL));
+        }
+        UTEST_ASSERT(h.shrink_to_fit());
+        UTEST_ASSERT(h.capacity() < cap);
+        for (size_t i=0; i<20; ++i)
+        {
+            ::snprintf(buf, sizeof(buf), "key-%d", int(i));
+            UTEST_ASSERT(h.contains(buf) == (i < 10));
+        }
+
+        // Shrink empty hash
+        h.clear();
+        UTEST_ASSERT(h.shrink_to_fit());
+        UTEST_ASSERT(h.capacity() == 0);
+
+        // Reuse the hash after flush
+        h.flush();
+        UTEST_ASSERT(h.put("key", NULL, NULL));
+        UTEST_ASSERT(s = h.key("key"));
+        UTEST_ASSERT(::strcmp(s, "key") == 0);
+    }
+
     UTEST_MAIN
     {
         test_basic();
         test_large();
+        test_batch();
+        test_incremental();
+        test_reserve();
         test_iterator(10);
         test_iterator(100);
         test_iterator(1000);
@@ -331,10 +331,63 @@ UTEST_BEGIN("lltl", ptrset)
             delete *it;
     }
 
+    void test_reserve()
+    {
+        constexpr size_t N = 0x1000;
+
+        lltl::ptrset<int> s;
+        int *xv = new int[N];
+        lsp_finally { delete [] xv; };
+
+        printf("Testing reserve and shrink_to_fit...\n");
+
+        UTEST_ASSERT(s.reserve(N));
+        const size_t cap = s.capacity();
+        UTEST_ASSERT(cap > 0);
+        UTEST_ASSERT(s.reserve(0x10));
+        UTEST_ASSERT(s.capacity() == cap);
+
+        // Perform put/remove churn
+        for (size_t k=0; k<4; ++k)
+        {
+            for (size_t i=0; i<N; ++i)
+                UTEST_ASSERT(s.put(&xv[i]));
+            UTEST_ASSERT(s.size() == N);
+
+            for (size_t i=k & 1; i<N; i += 2)
+                UTEST_ASSERT(s.remove(&xv[i]));
+            UTEST_ASSERT(s.size() == N/2);
+
+            for (size_t i=0; i<N; ++i)
+                UTEST_ASSERT(s.contains(&xv[i]) == ((i & 1) != (k & 1)));
+
+            s.clear();
+            UTEST_ASSERT(s.is_empty());
+        }
+
+        // Shrink the set
+        for (size_t i=0; i<0x20; ++i)
+            UTEST_ASSERT(s.put(&xv[i]));
+        UTEST_ASSERT(s.shrink_to_fit());
+        UTEST_ASSERT(s.capacity() <= cap);
+        UTEST_ASSERT(s.size() == 0x20);
+        for (size_t i=0; i<0x40; ++i)
+            UTEST_ASSERT(s.contains(&xv[i]) == (i < 0x20));
+        for (size_t i=0x20; i<0x40; ++i)
+            UTEST_ASSERT(s.put(&xv[i]));
+        for (size_t i=0; i<0x40; ++i)
+            UTEST_ASSERT(s.remove(&xv[i]));
+
+        // Shrink empty set
+        UTEST_ASSERT(s.shrink_to_fit());
+        UTEST_ASSERT(s.capacity() == 0);
+    }
+
     UTEST_MAIN
     {
         test_basic();
         test_large();
+        test_reserve();
         test_iterator(10);
         test_iterator(100);
         test_iterator(1000);
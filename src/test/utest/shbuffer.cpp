@@ -21,8 +21,11 @@
 
 #include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/lltl/shbuffer.h>
+#include <lsp-plug.in/lltl/spsc_queue.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
+#include "../helpers/thread.h"
+
 namespace lsp
 {
     static uatomic_t deleter_calls;
@@ -42,10 +45,65 @@ namespace lsp
         atomic_add(&deleter_calls, 1);
         free(ptr);
     }
+
+    static constexpr size_t HANDOFF_SLOTS   = 16;
+    static constexpr size_t HANDOFF_ITEMS   = 20000;
+    static constexpr size_t HANDOFF_LENGTH  = 16;
 } /* namespace lsp */
 
 UTEST_BEGIN("lltl", shbuffer)
 
+    typedef struct handoff_t
+    {
+        lltl::shbuffer<int>         slots[HANDOFF_SLOTS];   // Buffers passed from producer to consumer
+        const int                  *live[HANDOFF_SLOTS];    // Data of buffers which are in use
+        lltl::spsc_queue<uint32_t> *ready;                  // Slots filled by producer
+        lltl::spsc_queue<uint32_t> *vacant;                 // Slots released by consumer
+        uint32_t                    received;               // Number of buffers received by consumer
+        uint32_t                    corrupted;              // Number of buffers with unexpected contents
+        uint32_t                    failed;                 // Number of failed queue operations
+    } handoff_t;
+
+    static void handoff_consumer(void *arg)
+    {
+        handoff_t *h        = static_cast<handoff_t *>(arg);
+        uint32_t slot;
+
+        while (h->received < HANDOFF_ITEMS)
+        {
+            if (!h->ready->pop(slot))
+            {
+                lltl::test::thread::yield();
+                continue;
+            }
+
+            // Check contents of the buffer
+            lltl::shbuffer<int> *buf = &h->slots[slot];
+            const int seq       = h->received;
+            if ((buf->references() != 1) || (buf->count() != HANDOFF_LENGTH))
+                ++h->corrupted;
+            else
+            {
+                for (size_t i=0; i<HANDOFF_LENGTH; ++i)
+                {
+                    if (*(*buf)[i] != int(seq + i))
+                    {
+                        ++h->corrupted;
+                        break;
+                    }
+                }
+            }
+
+            // Drop the last reference, the memory is returned to the pool by this thread
+            atomic_store(&h->live[slot], static_cast<const int *>(NULL));
+            buf->reset();
+            ++h->received;
+
+            if (!h->vacant->push(slot))
+                ++h->failed;
+        }
+    }
+
     void test_copy()
     {
         const int v = 42;
@@ -113,6 +171,30 @@ UTEST_BEGIN("lltl", shbuffer)
         UTEST_ASSERT(p.references() == 0);
         UTEST_ASSERT(!p);
         UTEST_ASSERT(p == NULL);
+
+        // Move assignment should release the previous reference
+        reset_calls();
+        int *v1 = static_cast<int *>(malloc(sizeof(int)));
+        int *v2 = static_cast<int *>(malloc(sizeof(int)));
+        UTEST_ASSERT(v1 != NULL);
+        UTEST_ASSERT(v2 != NULL);
+
+        p.map(v1, 1, deleter);
+        {
+            lltl::shbuffer<int> q(v2, 1, deleter);
+            p = lsp::move(q);
+            UTEST_ASSERT(num_calls() == 1);
+            UTEST_ASSERT(p.references() == 1);
+            UTEST_ASSERT(*p == v2);
+            UTEST_ASSERT(!q);
+
+            p = lsp::move(p);
+            UTEST_ASSERT(p.references() == 1);
+            UTEST_ASSERT(*p == v2);
+        }
+
+        p = NULL;
+        UTEST_ASSERT(num_calls() == 2);
     }
 
     void test_reset()
@@ -261,6 +343,379 @@ UTEST_BEGIN("lltl", shbuffer)
         UTEST_ASSERT(p == NULL);
     }
 
+    void test_slice()
+    {
+        int v[16];
+        for (int i=0; i<16; ++i)
+            v[i] = i;
+
+        lltl::shbuffer<int> p(v, 16);
+        UTEST_ASSERT(!p.is_slice());
+
+        // Split the buffer into regions
+        lltl::shbuffer<int> q[4];
+        for (int i=0; i<4; ++i)
+        {
+            q[i] = p.slice(i * 4, 4);
+            UTEST_ASSERT(q[i]);
+            UTEST_ASSERT(q[i].is_slice());
+            UTEST_ASSERT(q[i].count() == 4);
+            UTEST_ASSERT(q[i].bytes() == sizeof(int) * 4);
+            UTEST_ASSERT(q[i].references() == size_t(i + 2));
+            UTEST_ASSERT(*q[i] == p[i * 4]);
+            UTEST_ASSERT(q[i] != p);
+            for (int j=0; j<4; ++j)
+                UTEST_ASSERT(*q[i][j] == i*4 + j);
+            UTEST_ASSERT(q[i][4] == NULL);
+        }
+        UTEST_ASSERT(q[0] < q[1]);
+        UTEST_ASSERT(q[0] == p.slice(0, 4));
+        UTEST_ASSERT(q[0] != p.slice(0, 3));
+
+        // Slice of slice, copy and move keep the window
+        lltl::shbuffer<int> r = q[2].slice(1, 2);
+        UTEST_ASSERT(r.count() == 2);
+        UTEST_ASSERT(*r[0] == 9);
+        UTEST_ASSERT(*r[1] == 10);
+        UTEST_ASSERT(r[2] == NULL);
+
+        lltl::shbuffer<int> c(r);
+        UTEST_ASSERT(c == r);
+        UTEST_ASSERT(c.count() == 2);
+        UTEST_ASSERT(*c[0] == 9);
+
+        lltl::shbuffer<int> m(lsp::move(c));
+        UTEST_ASSERT(!c);
+        UTEST_ASSERT(c.count() == 0);
+        UTEST_ASSERT(m.count() == 2);
+        UTEST_ASSERT(*m[1] == 10);
+
+        m.swap(p);
+        UTEST_ASSERT(m.count() == 16);
+        UTEST_ASSERT(p.count() == 2);
+        UTEST_ASSERT(*p[0] == 9);
+        m.swap(p);
+
+        // Truncated and empty ranges
+        lltl::shbuffer<int> t = p.slice(14, 10);
+        UTEST_ASSERT(t.count() == 2);
+        UTEST_ASSERT(*t[1] == 15);
+        UTEST_ASSERT(!p.slice(16, 1));
+        UTEST_ASSERT(!p.slice(0, 0));
+        UTEST_ASSERT(!lltl::shbuffer<int>().slice(0, 1));
+
+        // Assigning the whole buffer resets the window
+        t = p;
+        UTEST_ASSERT(t.count() == 16);
+        UTEST_ASSERT(!t.is_slice());
+        t.set(v, 3);
+        UTEST_ASSERT(t.count() == 3);
+        UTEST_ASSERT(t.references() == 1);
+
+        // Slices keep the buffer alive
+        const size_t refs = p.references();
+        p = NULL;
+        UTEST_ASSERT(q[3].references() == refs - 1);
+        UTEST_ASSERT(*q[3][3] == 15);
+    }
+
+    void test_pool()
+    {
+        lltl::shbuffer_pool pool;
+        int v[16];
+        for (int i=0; i<16; ++i)
+            v[i] = i;
+
+        // Allocate and release buffer, the memory should be reused
+        UTEST_ASSERT(pool.cached() == 0);
+        lltl::shbuffer<int> p;
+        p.set(v, 16, &pool);
+        UTEST_ASSERT(p.references() == 1);
+        UTEST_ASSERT(p.count() == 16);
+        const int *ptr = *p;
+        UTEST_ASSERT(ptr != v);
+        for (int i=0; i<16; ++i)
+            UTEST_ASSERT(*p[i] == i);
+
+        lltl::shbuffer<int> q = p.slice(4, 4);
+        p = NULL;
+        UTEST_ASSERT(pool.cached() == 0);
+        q = NULL;
+        UTEST_ASSERT(pool.cached() == 1);
+
+        p.set(&v[1], 8, &pool);
+        UTEST_ASSERT(pool.cached() == 0);
+        UTEST_ASSERT(*p == ptr);
+        UTEST_ASSERT(p.count() == 8);
+        UTEST_ASSERT(*p[7] == 8);
+
+        // Map external data with pooled header
+        reset_calls();
+        int *x = static_cast<int *>(malloc(sizeof(int)));
+        UTEST_ASSERT(x != NULL);
+        *x = 42;
+        q.map(x, 1, deleter, &pool);
+        UTEST_ASSERT(*q == x);
+        UTEST_ASSERT(**q == 42);
+        q = NULL;
+        UTEST_ASSERT(num_calls() == 1);
+        UTEST_ASSERT(pool.cached() == 1);
+
+        q.map(v, 16, NULL, &pool);
+        UTEST_ASSERT(pool.cached() == 0);
+        UTEST_ASSERT(*q == v);
+        UTEST_ASSERT(q.count() == 16);
+        q = NULL;
+        UTEST_ASSERT(num_calls() == 1);
+
+        // Large buffers are allocated from heap
+        const size_t large = lltl::shbuffer_pool::max_bytes() / sizeof(int) + 1;
+        int *big = static_cast<int *>(malloc(large * sizeof(int)));
+        UTEST_ASSERT(big != NULL);
+        lsp_finally { free(big); };
+        for (size_t i=0; i<large; ++i)
+            big[i] = int(i);
+        q.set(big, large, &pool);
+        UTEST_ASSERT(q.count() == large);
+        UTEST_ASSERT(*q[large - 1] == int(large - 1));
+        q = NULL;
+        UTEST_ASSERT(pool.cached() == 1);
+
+        // Reserve buffers
+        UTEST_ASSERT(!pool.reserve(lltl::shbuffer_pool::max_bytes() + 1, 1));
+        UTEST_ASSERT(pool.reserve(lltl::shbuffer_pool::max_bytes(), 4));
+        UTEST_ASSERT(pool.reserve(0, 2));
+        UTEST_ASSERT(pool.cached() == 7);
+        q.set(big, large - 1, &pool);
+        UTEST_ASSERT(pool.cached() == 6);
+        q = NULL;
+        UTEST_ASSERT(pool.cached() == 7);
+
+        // Flush the pool, the buffer in use is returned after flush
+        pool.flush();
+        UTEST_ASSERT(pool.cached() == 0);
+        p = NULL;
+        UTEST_ASSERT(pool.cached() == 1);
+    }
+
+    void test_pool_handoff()
+    {
+        lltl::shbuffer_pool pool;
+        lltl::spsc_queue<uint32_t> ready(HANDOFF_SLOTS), vacant(HANDOFF_SLOTS);
+        int data[HANDOFF_LENGTH];
+        uint32_t slot;
+
+        handoff_t h;
+        h.ready         = &ready;
+        h.vacant        = &vacant;
+        h.received      = 0;
+        h.corrupted     = 0;
+        h.failed        = 0;
+        for (size_t i=0; i<HANDOFF_SLOTS; ++i)
+        {
+            h.live[i]       = NULL;
+            UTEST_ASSERT(vacant.push(uint32_t(i)));
+        }
+
+        reset_calls();
+        size_t max_cached   = 0;
+        size_t mapped       = 0;
+        size_t duplicates   = 0;
+
+        {
+            lltl::test::thread consumer;
+            UTEST_ASSERT(consumer.start(handoff_consumer, &h));
+
+            for (size_t seq=0; seq<HANDOFF_ITEMS; ++seq)
+            {
+                // Wait for the slot released by consumer
+                while (!vacant.pop(slot))
+                    lltl::test::thread::yield();
+
+                // Allocate buffer from the pool
+                lltl::shbuffer<int> *buf = &h.slots[slot];
+                if (seq & 1)
+                {
+                    int *x = static_cast<int *>(malloc(HANDOFF_LENGTH * sizeof(int)));
+                    if (x == NULL)
+                        break;
+                    for (size_t i=0; i<HANDOFF_LENGTH; ++i)
+                        x[i]            = int(seq + i);
+                    buf->map(x, HANDOFF_LENGTH, deleter, &pool);
+                    ++mapped;
+                }
+                else
+                {
+                    for (size_t i=0; i<HANDOFF_LENGTH; ++i)
+                        data[i]         = int(seq + i);
+                    buf->set(data, HANDOFF_LENGTH, &pool);
+                }
+
+                // The buffer should not share memory with any buffer which is still in use
+                const int *ptr      = *(*buf);
+                for (size_t i=0; i<HANDOFF_SLOTS; ++i)
+                {
+                    if (atomic_load(&h.live[i]) == ptr)
+                        ++duplicates;
+                }
+                atomic_store(&h.live[slot], ptr);
+
+                max_cached          = lsp_max(max_cached, pool.cached());
+                if (!ready.push(slot))
+                    break;
+            }
+        }
+
+        UTEST_ASSERT(h.failed == 0);
+        UTEST_ASSERT_MSG(duplicates == 0, "%d buffers have been handed out twice", int(duplicates));
+        UTEST_ASSERT_MSG(h.corrupted == 0, "%d corrupted buffers", int(h.corrupted));
+        UTEST_ASSERT(h.received == HANDOFF_ITEMS);
+        UTEST_ASSERT(num_calls() == mapped);
+
+        // Released memory should be reused, so the number of cached blocks should not
+        // exceed the number of buffers which can be in use simultaneously
+        UTEST_ASSERT_MSG(max_cached <= HANDOFF_SLOTS * 2, "Too many cached blocks: %d", int(max_cached));
+        UTEST_ASSERT(pool.cached() <= HANDOFF_SLOTS * 2);
+    }
+
+    void test_edit()
+    {
+        int v[8];
+        for (int i=0; i<8; ++i)
+            v[i] = i;
+
+        // Null reference
+        lltl::shbuffer<int> p;
+        UTEST_ASSERT(!p.unique());
+        UTEST_ASSERT(p.edit() == NULL);
+
+        // Unique reference is modified in place
+        p.set(v, 8);
+        UTEST_ASSERT(p.unique());
+        const int *orig = *p;
+        int *w = p.edit();
+        UTEST_ASSERT(w == orig);
+        w[0] = 100;
+        UTEST_ASSERT(*p[0] == 100);
+
+        // Shared reference is copied once
+        lltl::shbuffer<int> q(p);
+        UTEST_ASSERT(!p.unique());
+        w = q.edit();
+        UTEST_ASSERT(w != NULL);
+        UTEST_ASSERT(w != orig);
+        UTEST_ASSERT(q.unique());
+        UTEST_ASSERT(p.unique());
+        UTEST_ASSERT(q.count() == 8);
+        w[1] = 101;
+        UTEST_ASSERT(*q[0] == 100);
+        UTEST_ASSERT(*q[1] == 101);
+        UTEST_ASSERT(*p[1] == 1);
+        UTEST_ASSERT(q.edit() == w);
+
+        // Only the window of slice is copied
+        lltl::shbuffer<int> s = p.slice(2, 3);
+        w = s.edit();
+        UTEST_ASSERT(w != NULL);
+        UTEST_ASSERT(!s.is_slice());
+        UTEST_ASSERT(s.count() == 3);
+        UTEST_ASSERT(s.bytes() == sizeof(int) * 3);
+        w[0] = 102;
+        UTEST_ASSERT(*s[0] == 102);
+        UTEST_ASSERT(*s[2] == 4);
+        UTEST_ASSERT(*p[2] == 2);
+
+        // The only slice of the owned buffer is modified in place
+        s = p.slice(4, 2);
+        p = NULL;
+        UTEST_ASSERT(s.unique());
+        w = s.edit();
+        UTEST_ASSERT(w == &orig[4]);
+        UTEST_ASSERT(s.is_slice());
+        w[1] = 105;
+        UTEST_ASSERT(*s[1] == 105);
+
+        // Mapped data is never modified
+        p.map(v, 8);
+        UTEST_ASSERT(p.unique());
+        lltl::shbuffer_pool pool;
+        w = p.edit(&pool);
+        UTEST_ASSERT(w != NULL);
+        UTEST_ASSERT(w != v);
+        w[7] = 107;
+        UTEST_ASSERT(*p[7] == 107);
+        UTEST_ASSERT(v[7] == 7);
+        UTEST_ASSERT(p.edit() == w);
+
+        p = NULL;
+        UTEST_ASSERT(pool.cached() == 1);
+    }
+
+    void test_map_file()
+    {
+        // Create the file
+        char path[0x400];
+        snprintf(path, sizeof(path), "%s/utest-%s.bin", tempdir(), full_name());
+        static constexpr size_t count = 0x4000;
+
+        FILE *fd = fopen(path, "wb");
+        UTEST_ASSERT(fd != NULL);
+        for (size_t i=0; i<count; ++i)
+        {
+            uint32_t v = i;
+            UTEST_ASSERT(fwrite(&v, sizeof(v), 1, fd) == 1);
+        }
+        fclose(fd);
+        lsp_finally { remove(path); };
+
+        // Map whole file
+        {
+            lltl::shbuffer<uint32_t> p;
+            UTEST_ASSERT(p.map_file(path) == STATUS_OK);
+            UTEST_ASSERT(p.references() == 1);
+            UTEST_ASSERT(p.count() == count);
+            for (size_t i=0; i<count; ++i)
+                UTEST_ASSERT(*p.get(i) == i);
+            UTEST_ASSERT(p.get(count) == NULL);
+
+            // Share the mapping
+            lltl::shbuffer<uint32_t> q = p;
+            UTEST_ASSERT(q.references() == 2);
+            p.reset();
+            UTEST_ASSERT(q.references() == 1);
+            UTEST_ASSERT(*q.get(count - 1) == count - 1);
+        }
+
+        // Map unaligned region with hints
+        {
+            lltl::shbuffer<uint32_t> p;
+            UTEST_ASSERT(p.map_file(path, 0x1234 * sizeof(uint32_t), 0x100 * sizeof(uint32_t),
+                lltl::SHBUFFER_ADVICE_SEQUENTIAL | lltl::SHBUFFER_ADVICE_WILLNEED) == STATUS_OK);
+            UTEST_ASSERT(p.count() == 0x100);
+            for (size_t i=0; i<0x100; ++i)
+                UTEST_ASSERT(*p.get(i) == i + 0x1234);
+
+            // Replace with the tail of the file
+            UTEST_ASSERT(p.map_file(path, (count - 3) * sizeof(uint32_t), 0, lltl::SHBUFFER_ADVICE_RANDOM) == STATUS_OK);
+            UTEST_ASSERT(p.references() == 1);
+            UTEST_ASSERT(p.count() == 3);
+            UTEST_ASSERT(*p.get(0) == count - 3);
+            UTEST_ASSERT(*p.get(2) == count - 1);
+
+            // Errors should keep the reference
+            UTEST_ASSERT(p.map_file(path, count * sizeof(uint32_t) + 1) == STATUS_BAD_ARGUMENTS);
+            UTEST_ASSERT(p.map_file(path, count * sizeof(uint32_t)) == STATUS_NO_DATA);
+            UTEST_ASSERT(p.map_file(path, 0, count * sizeof(uint32_t) + 1) == STATUS_BAD_ARGUMENTS);
+            UTEST_ASSERT(p.count() == 3);
+        }
+
+        // Missing file
+        lltl::shbuffer<uint32_t> p;
+        remove(path);
+        UTEST_ASSERT(p.map_file(path) == STATUS_NOT_FOUND);
+        UTEST_ASSERT(!p);
+    }
+
     UTEST_MAIN
     {
         test_copy();
@@ -270,6 +725,11 @@ UTEST_BEGIN("lltl", shbuffer)
         test_map();
         test_map_autodelete();
         test_indexing();
+        test_slice();
+        test_pool();
+        test_pool_handoff();
+        test_edit();
+        test_map_file();
     }
 
 UTEST_END
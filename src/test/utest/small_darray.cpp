@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/lltl/small_darray.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+namespace
+{
+    static ssize_t test_int_cmp(const int *a, const int *b)
+    {
+        return *a - *b;
+    }
+}
+
+UTEST_BEGIN("lltl", small_darray)
+
+    void check_darray(lltl::darray<int> &x, const int *numbers, size_t n)
+    {
+        UTEST_ASSERT(x.size() == n);
+        UTEST_ASSERT(x.capacity() >= n);
+        for (size_t i=0; i<n; ++i)
+        {
+            int *pv = x.get(i);
+            UTEST_ASSERT_MSG(pv != NULL, "Failed get at index %d", int(i));
+            UTEST_ASSERT_MSG(*pv == numbers[i], "Failed at index %d: got %d, expected %d", int(i), *pv, numbers[i]);
+        }
+        UTEST_ASSERT(x.get(n) == NULL);
+    }
+
+    void test_inline()
+    {
+        printf("Testing inline storage...\n");
+
+        lltl::small_darray<int, 4> x;
+        UTEST_ASSERT(x.size() == 0);
+        UTEST_ASSERT(x.capacity() == 4);
+        UTEST_ASSERT(x.inline_capacity() == 4);
+        UTEST_ASSERT(x.is_inline());
+        UTEST_ASSERT(x.first() == NULL);
+
+        // Fill inline storage
+        UTEST_ASSERT(x.append(1));
+        UTEST_ASSERT(x.append(3));
+        UTEST_ASSERT(x.insert(1, 2));
+        UTEST_ASSERT(x.prepend(0));
+        UTEST_ASSERT(x.is_inline());
+        UTEST_ASSERT(x.capacity() == 4);
+        static const int v1[] = { 0, 1, 2, 3 };
+        check_darray(x, v1, 4);
+
+        // Spill to the heap
+        UTEST_ASSERT(x.append(4));
+        UTEST_ASSERT(!x.is_inline());
+        UTEST_ASSERT(x.capacity() >= 32);
+        static const int v2[] = { 0, 1, 2, 3, 4 };
+        check_darray(x, v2, 5);
+
+        for (int i=5; i<100; ++i)
+            UTEST_ASSERT(x.append(i));
+        for (size_t i=0; i<100; ++i)
+            UTEST_ASSERT(*x.uget(i) == int(i));
+
+        // Remove items and truncate back to inline storage
+        UTEST_ASSERT(x.remove_n(3, 96));
+        UTEST_ASSERT(x.remove(0));
+        static const int v3[] = { 1, 2, 99 };
+        check_darray(x, v3, 3);
+        UTEST_ASSERT(x.truncate(4));
+        UTEST_ASSERT(x.is_inline());
+        check_darray(x, v3, 3);
+
+        // Flush keeps inline storage
+        x.flush();
+        UTEST_ASSERT(x.is_inline());
+        UTEST_ASSERT(x.size() == 0);
+        UTEST_ASSERT(x.capacity() == 4);
+    }
+
+    void test_sort_iterate()
+    {
+        printf("Testing sort and iteration...\n");
+
+        lltl::small_darray<int, 8> x;
+        static const int src[] = { 5, 3, 7, 1, 6, 2, 4, 0 };
+        static const int sorted[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+        UTEST_ASSERT(x.append_n(8, src));
+        UTEST_ASSERT(x.is_inline());
+        x.qsort(test_int_cmp);
+        check_darray(x, sorted, 8);
+
+        int expected = 0;
+        for (lltl::iterator<int> it = x.values(); it; ++it, ++expected)
+            UTEST_ASSERT(*(*it) == expected);
+        UTEST_ASSERT(expected == 8);
+
+        x.qremove(0);
+        UTEST_ASSERT(*x.uget(0) == 7);
+        UTEST_ASSERT(x.size() == 7);
+    }
+
+    void test_swap_release()
+    {
+        printf("Testing swap and release...\n");
+
+        lltl::small_darray<int, 4> a, b;
+        lltl::darray<int> c;
+        static const int v1[] = { 1, 2, 3 };
+        static const int v2[] = { 10, 11, 12, 13, 14, 15 };
+
+        UTEST_ASSERT(a.append_n(3, v1));
+        UTEST_ASSERT(b.append_n(6, v2));
+        UTEST_ASSERT(a.is_inline());
+        UTEST_ASSERT(!b.is_inline());
+
+        // Swap inline and heap data between small arrays
+        UTEST_ASSERT(a.swap(b));
+        check_darray(a, v2, 6);
+        check_darray(b, v1, 3);
+        UTEST_ASSERT(!a.is_inline());
+        UTEST_ASSERT(b.is_inline());
+
+        // Swap with plain array
+        UTEST_ASSERT(b.swap(c));
+        check_darray(c, v1, 3);
+        UTEST_ASSERT(b.size() == 0);
+        UTEST_ASSERT(b.is_inline());
+        UTEST_ASSERT(c.swap(b));
+        check_darray(b, v1, 3);
+        UTEST_ASSERT(b.is_inline());
+        UTEST_ASSERT(c.size() == 0);
+
+        // Swap with aligned array should be rejected
+        lltl::darray<int> d(0x40);
+        UTEST_ASSERT(d.append_n(6, v2));
+        UTEST_ASSERT(!b.swap(d));
+        UTEST_ASSERT(!d.swap(b));
+        check_darray(b, v1, 3);
+        check_darray(d, v2, 6);
+        UTEST_ASSERT(b.is_inline());
+        UTEST_ASSERT(b.alignment() == 0);
+        UTEST_ASSERT(d.alignment() == 0x40);
+        UTEST_ASSERT((uintptr_t(d.first()) & 0x3f) == 0);
+
+        // Aligned arrays without inline storage still can be swapped
+        lltl::darray<int> e(0x20);
+        UTEST_ASSERT(d.swap(e));
+        UTEST_ASSERT(d.is_empty());
+        UTEST_ASSERT(d.alignment() == 0x20);
+        UTEST_ASSERT(e.alignment() == 0x40);
+        check_darray(e, v2, 6);
+
+        // Release data
+        int *data = b.release();
+        UTEST_ASSERT(data != NULL);
+        for (size_t i=0; i<3; ++i)
+            UTEST_ASSERT(data[i] == v1[i]);
+        ::free(data);
+        UTEST_ASSERT(b.is_inline());
+        UTEST_ASSERT(b.size() == 0);
+
+        data = a.release();
+        UTEST_ASSERT(data != NULL);
+        for (size_t i=0; i<6; ++i)
+            UTEST_ASSERT(data[i] == v2[i]);
+        ::free(data);
+        UTEST_ASSERT(a.is_inline());
+        UTEST_ASSERT(a.release() == NULL);
+    }
+
+    UTEST_MAIN
+    {
+        test_inline();
+        test_sort_iterate();
+        test_swap_release();
+    }
+
+UTEST_END
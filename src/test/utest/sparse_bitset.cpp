@@ -0,0 +1,360 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/lltl/bitset.h>
+#include <lsp-plug.in/lltl/sparse_bitset.h>
+#include <lsp-plug.in/test-fw/utest.h>
+
+UTEST_BEGIN("lltl", sparse_bitset)
+
+    static constexpr size_t UNIVERSE    = 0x180000;
+
+    size_t random_index(size_t size)
+    {
+        // Make clusters of bits to test all kinds of chunk containers
+        size_t base = (size_t(rand()) * 0x10000) % size;
+        size_t off  = rand() % ((rand() % 3 == 0) ? 0x10000 : 0x200);
+        return (base + off) % size;
+    }
+
+    void check_equal(const lltl::sparse_bitset & x, const lltl::bitset & y)
+    {
+        UTEST_ASSERT(x.size() == y.size());
+        UTEST_ASSERT_MSG(x.count() == y.count(), "count mismatch: %d vs %d", int(x.count()), int(y.count()));
+
+        ssize_t i = x.find_first(), j = y.find_first();
+        while ((i >= 0) || (j >= 0))
+        {
+            UTEST_ASSERT_MSG(i == j, "set bit mismatch: %d vs %d", int(i), int(j));
+            UTEST_ASSERT(x.get(i));
+            i   = x.find_next(i);
+            j   = y.find_next(j);
+        }
+    }
+
+    void test_single()
+    {
+        printf("Testing single bit operations...\n");
+
+        lltl::sparse_bitset x;
+        lltl::bitset y;
+
+        UTEST_ASSERT(x.is_empty());
+        UTEST_ASSERT(x.resize(UNIVERSE));
+        UTEST_ASSERT(y.resize(UNIVERSE));
+        UTEST_ASSERT(x.size() == UNIVERSE);
+        UTEST_ASSERT(x.count() == 0);
+        UTEST_ASSERT(x.find_first() < 0);
+        UTEST_ASSERT(!x.get(UNIVERSE));
+        UTEST_ASSERT(!x.set(UNIVERSE));
+        UTEST_ASSERT(!x.get(UNIVERSE));
+
+        for (size_t i=0; i<40000; ++i)
+        {
+            size_t index    = random_index(UNIVERSE);
+            bool xv, yv;
+            switch (rand() % 5)
+            {
+                case 0:
+                case 1:
+                    xv = x.set(index);
+                    yv = y.set(index);
+                    break;
+                case 2:
+                    xv = x.unset(index);
+                    yv = y.unset(index);
+                    break;
+                case 3:
+                    xv = x.toggle(index);
+                    yv = y.toggle(index);
+                    break;
+                default:
+                {
+                    bool value  = rand() % 2;
+                    xv = x.set(index, value);
+                    yv = y.set(index, value);
+                    break;
+                }
+            }
+            UTEST_ASSERT_MSG(xv == yv, "previous value mismatch at index %d", int(index));
+            UTEST_ASSERT(x.get(index) == y.get(index));
+        }
+        check_equal(x, y);
+
+        UTEST_ASSERT(x.optimize());
+        check_equal(x, y);
+
+        // Remove all bits one by one
+        for (ssize_t i = y.find_first(); i >= 0; i = y.find_next(i))
+            UTEST_ASSERT(x.unset(i));
+        UTEST_ASSERT(x.count() == 0);
+        UTEST_ASSERT(x.find_first() < 0);
+    }
+
+    void test_ranges()
+    {
+        printf("Testing range operations...\n");
+
+        lltl::sparse_bitset x;
+        lltl::bitset y;
+
+        UTEST_ASSERT(x.resize(UNIVERSE));
+        UTEST_ASSERT(y.resize(UNIVERSE));
+
+        for (size_t i=0; i<2000; ++i)
+        {
+            size_t index    = random_index(UNIVERSE);
+            size_t count    = (rand() % 4 == 0) ? rand() % 0x30000 : rand() % 0x100;
+            size_t xn, yn;
+
+            switch (rand() % 3)
+            {
+                case 0:
+                    xn = x.set(index, count);
+                    yn = y.set(index, count);
+                    break;
+                case 1:
+                    xn = x.unset(index, count);
+                    yn = y.unset(index, count);
+                    break;
+                default:
+                    xn = x.toggle(index, count);
+                    yn = y.toggle(index, count);
+                    break;
+            }
+            UTEST_ASSERT(xn == yn);
+
+            // Mix with single bit operations
+            index           = random_index(UNIVERSE);
+            UTEST_ASSERT(x.toggle(index) == y.toggle(index));
+
+            if ((i % 100) == 0)
+                check_equal(x, y);
+        }
+        check_equal(x, y);
+
+        x.toggle_all();
+        y.toggle_all();
+        check_equal(x, y);
+
+        x.set_all();
+        y.set_all();
+        check_equal(x, y);
+        UTEST_ASSERT(x.capacity() < 0x1000);
+
+        x.unset_all();
+        y.unset_all();
+        check_equal(x, y);
+
+        // Shrink and grow
+        x.set(0, UNIVERSE);
+        y.set(0, UNIVERSE);
+        UTEST_ASSERT(x.resize(UNIVERSE - 1000));
+        UTEST_ASSERT(y.resize(UNIVERSE - 1000));
+        check_equal(x, y);
+        UTEST_ASSERT(x.resize(UNIVERSE));
+        UTEST_ASSERT(y.resize(UNIVERSE));
+        check_equal(x, y);
+        UTEST_ASSERT(!x.get(UNIVERSE - 1));
+
+        // Set values from array
+        bool values[0x300];
+        for (size_t i=0; i<0x300; ++i)
+            values[i]       = rand() % 2;
+        UTEST_ASSERT(x.set(0xff00, 0x300, values) == 0x300);
+        UTEST_ASSERT(y.set(0xff00, 0x300, values) == 0x300);
+        check_equal(x, y);
+
+        // Operations with itself
+        UTEST_ASSERT(x.bitwise_or(&x));
+        check_equal(x, y);
+        UTEST_ASSERT(x.bitwise_xor(&x));
+        UTEST_ASSERT(x.count() == 0);
+
+        x.clear();
+        UTEST_ASSERT(x.size() == 0);
+        UTEST_ASSERT(x.count() == 0);
+    }
+
+    void test_bulk()
+    {
+        lltl::sparse_bitset xa, xb;
+        lltl::bitset ya, yb;
+
+        UTEST_FOREACH(op, 0, 1, 2, 3)
+        {
+            UTEST_FOREACH(density, 10, 500, 30000)
+            {
+                printf("Testing bulk operation %d, density %d...\n", int(op), int(density));
+
+                UTEST_ASSERT(xa.resize(UNIVERSE));
+                UTEST_ASSERT(ya.resize(UNIVERSE));
+                UTEST_ASSERT(xb.resize(UNIVERSE - 0x8000));
+                UTEST_ASSERT(yb.resize(UNIVERSE - 0x8000));
+                xa.unset_all();
+                ya.unset_all();
+                xb.unset_all();
+                yb.unset_all();
+
+                for (size_t i=0; i<size_t(density); ++i)
+                {
+                    size_t index    = random_index(UNIVERSE);
+                    xa.set(index);
+                    ya.set(index);
+                    index           = random_index(UNIVERSE);
+                    xb.set(index);
+                    yb.set(index);
+                }
+                for (size_t i=0; i<10; ++i)
+                {
+                    size_t index    = random_index(UNIVERSE);
+                    size_t count    = rand() % 0x20000;
+                    xa.set(index, count);
+                    ya.set(index, count);
+                    index           = random_index(UNIVERSE);
+                    xb.set(index, count);
+                    yb.set(index, count);
+                }
+                check_equal(xa, ya);
+                check_equal(xb, yb);
+
+                switch (op)
+                {
+                    case 0:
+                        UTEST_ASSERT(xa.bitwise_and(&xb));
+                        ya.bitwise_and(&yb);
+                        UTEST_ASSERT(xb.bitwise_and(&xa));
+                        yb.bitwise_and(&ya);
+                        break;
+                    case 1:
+                        UTEST_ASSERT(xa.bitwise_or(&xb));
+                        ya.bitwise_or(&yb);
+                        UTEST_ASSERT(xb.bitwise_or(&xa));
+                        yb.bitwise_or(&ya);
+                        break;
+                    case 2:
+                        UTEST_ASSERT(xa.bitwise_xor(&xb));
+                        ya.bitwise_xor(&yb);
+                        UTEST_ASSERT(xb.bitwise_xor(&xa));
+                        yb.bitwise_xor(&ya);
+                        break;
+                    default:
+                        UTEST_ASSERT(xa.bitwise_andnot(&xb));
+                        ya.bitwise_andnot(&yb);
+                        UTEST_ASSERT(xb.bitwise_andnot(&xa));
+                        yb.bitwise_andnot(&ya);
+                        break;
+                }
+
+                check_equal(xa, ya);
+                check_equal(xb, yb);
+            }
+        }
+    }
+
+    void test_dense()
+    {
+        printf("Testing dense chunks...\n");
+
+        lltl::sparse_bitset xa, xb;
+        lltl::bitset ya, yb;
+
+        UTEST_ASSERT(xa.resize(UNIVERSE));
+        UTEST_ASSERT(ya.resize(UNIVERSE));
+        UTEST_ASSERT(xb.resize(UNIVERSE));
+        UTEST_ASSERT(yb.resize(UNIVERSE));
+
+        // Randomly fill two chunks, this should convert arrays into bitmaps
+        for (size_t i=0; i<60000; ++i)
+        {
+            size_t index    = 0x10000 + rand() % 0x20000;
+            UTEST_ASSERT(xa.set(index) == ya.set(index));
+            index           = 0x18000 + rand() % 0x20000;
+            UTEST_ASSERT(xb.toggle(index) == yb.toggle(index));
+        }
+        check_equal(xa, ya);
+        check_equal(xb, yb);
+        UTEST_ASSERT(xa.capacity() > 0x4000);
+
+        // Bulk operations on bitmaps
+        UTEST_ASSERT(xa.bitwise_xor(&xb));
+        ya.bitwise_xor(&yb);
+        check_equal(xa, ya);
+        UTEST_ASSERT(xb.bitwise_and(&xa));
+        yb.bitwise_and(&ya);
+        check_equal(xb, yb);
+        UTEST_ASSERT(xa.bitwise_or(&xb));
+        ya.bitwise_or(&yb);
+        check_equal(xa, ya);
+
+        // Remove bits, this should convert bitmaps back into arrays
+        for (size_t i=0; i<0x40000; ++i)
+        {
+            size_t index    = 0x10000 + rand() % 0x20000;
+            UTEST_ASSERT(xa.unset(index) == ya.unset(index));
+        }
+        check_equal(xa, ya);
+        for (ssize_t i = ya.find_first(); i >= 0; i = ya.find_next(i))
+            UTEST_ASSERT(xa.toggle(i));
+        UTEST_ASSERT(xa.count() == 0);
+    }
+
+    void test_memory()
+    {
+        printf("Testing memory usage...\n");
+
+        static constexpr size_t size    = 50000000;
+        lltl::sparse_bitset x;
+        UTEST_ASSERT(x.resize(size));
+
+        for (size_t i=0; i<5000; ++i)
+            x.set((size_t(rand()) * 7919) % size);
+        x.set(size_t(1000000), size_t(10000000));
+
+        size_t count    = x.count();
+        size_t bytes    = x.capacity();
+        printf("  set bits: %d, memory used: %d bytes, dense bitset: %d bytes\n",
+            int(count), int(bytes), int(size / 8));
+        UTEST_ASSERT(count >= 10000000);
+        UTEST_ASSERT(bytes < size / 64);
+
+        // Swap and flush
+        lltl::sparse_bitset y;
+        x.swap(&y);
+        UTEST_ASSERT(x.size() == 0);
+        UTEST_ASSERT(y.size() == size);
+        UTEST_ASSERT(y.count() == count);
+        y.flush();
+        UTEST_ASSERT(y.count() == 0);
+        UTEST_ASSERT(y.capacity() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        test_single();
+        test_ranges();
+        test_bulk();
+        test_dense();
+        test_memory();
+    }
+
+UTEST_END;
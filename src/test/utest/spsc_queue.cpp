@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of lsp-lltl-lib
+ * Created on: 16 окт. 2026 г.
+ *
+ * lsp-lltl-lib is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * lsp-lltl-lib is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/lltl/spsc_queue.h>
+
+#include "../helpers/thread.h"
+
+UTEST_BEGIN("lltl", spsc_queue)
+
+    typedef struct event_t
+    {
+        uint32_t    id;
+        float       value;
+    } event_t;
+
+    typedef struct transfer_t
+    {
+        lltl::spsc_queue<uint32_t> *queue;
+        uint32_t    count;      // Number of elements to transfer
+        uint32_t    received;   // Number of received elements
+        uint32_t    errors;     // Number of elements received out of order
+        bool        failed;     // Producer failed to push data
+    } transfer_t;
+
+    static void producer_main(void *arg)
+    {
+        transfer_t *t = static_cast<transfer_t *>(arg);
+        uint32_t buf[64];
+
+        for (uint32_t sent = 0; sent < t->count; )
+        {
+            // Alternate between single and bulk pushes of random size
+            const uint32_t n = lsp_min(uint32_t(rand() % 64) + 1, t->count - sent);
+            if (n == 1)
+            {
+                if (!t->queue->push(sent))
+                    t->failed   = true;
+            }
+            else
+            {
+                for (uint32_t i=0; i<n; ++i)
+                    buf[i]      = sent + i;
+                if (!t->queue->push(buf, n))
+                    t->failed   = true;
+            }
+            sent       += n;
+
+            if (!(sent & 0x3ff))
+                lltl::test::thread::yield();
+        }
+    }
+
+    static void consumer_main(void *arg)
+    {
+        transfer_t *t = static_cast<transfer_t *>(arg);
+        uint32_t buf[48];
+
+        while (t->received < t->count)
+        {
+            const size_t n = t->queue->pop(buf, 48);
+            if (n == 0)
+            {
+                lltl::test::thread::yield();
+                continue;
+            }
+
+            for (size_t i=0; i<n; ++i)
+            {
+                if (buf[i] != t->received)
+                    ++t->errors;
+                ++t->received;
+            }
+        }
+    }
+
+    void test_single()
+    {
+        printf("Testing single element operations...\n");
+
+        lltl::spsc_queue<event_t> q(16);
+        event_t ev;
+
+        UTEST_ASSERT(q.is_empty());
+        UTEST_ASSERT(q.size() == 0);
+        UTEST_ASSERT(!q.pop(ev));
+
+        for (uint32_t round=0; round<4; ++round)
+        {
+            for (uint32_t i=0; i<100; ++i)
+            {
+                ev.id       = i;
+                ev.value    = i * 0.5f;
+                UTEST_ASSERT(q.push(ev));
+                UTEST_ASSERT(q.size() == i + 1);
+            }
+
+            for (uint32_t i=0; i<100; ++i)
+            {
+                UTEST_ASSERT(q.pop(ev));
+                UTEST_ASSERT(ev.id == i);
+                UTEST_ASSERT(ev.value == i * 0.5f);
+            }
+
+            UTEST_ASSERT(q.is_empty());
+            UTEST_ASSERT(!q.pop(ev));
+        }
+
+        // Chunks should be recycled
+        UTEST_ASSERT(q.chunks() <= 8);
+    }
+
+    void test_bulk()
+    {
+        printf("Testing bulk operations...\n");
+
+        lltl::spsc_queue<uint32_t> q(16);
+        uint32_t buf[100];
+        uint32_t pushed = 0, popped = 0;
+
+        for (size_t iter=0; iter<1000; ++iter)
+        {
+            // Push random number of elements
+            const size_t n_push = rand() % 100;
+            for (size_t i=0; i<n_push; ++i)
+                buf[i]      = pushed + i;
+            UTEST_ASSERT(q.push(buf, n_push));
+            pushed     += n_push;
+            UTEST_ASSERT(q.size() == pushed - popped);
+
+            // Pop random number of elements
+            const size_t n_pop  = rand() % 100;
+            const size_t n      = q.pop(buf, n_pop);
+            UTEST_ASSERT(n == lsp_min(n_pop, size_t(pushed - popped)));
+            for (size_t i=0; i<n; ++i)
+                UTEST_ASSERT(buf[i] == popped + i);
+            popped     += n;
+            UTEST_ASSERT(q.size() == pushed - popped);
+        }
+
+        // Drain the queue
+        while (size_t n = q.pop(buf, 100))
+        {
+            for (size_t i=0; i<n; ++i)
+                UTEST_ASSERT(buf[i] == popped + i);
+            popped     += n;
+        }
+        UTEST_ASSERT(popped == pushed);
+        UTEST_ASSERT(q.is_empty());
+    }
+
+    void test_reserve()
+    {
+        printf("Testing reserve...\n");
+
+        lltl::spsc_queue<uint32_t> q(16);
+        uint32_t buf[40];
+
+        UTEST_ASSERT(q.reserve(100));
+        const size_t chunks = q.chunks();
+        UTEST_ASSERT(chunks * q.chunk_capacity() >= 100);
+
+        // Queue should not allocate chunks while the number of elements does not exceed the reserved one
+        uint32_t pushed = 0, popped = 0;
+        for (size_t iter=0; iter<1000; ++iter)
+        {
+            for (size_t i=0; i<40; ++i)
+                buf[i]      = pushed + i;
+            UTEST_ASSERT(q.push(buf, 40));
+            pushed     += 40;
+
+            if (q.size() > 60)
+            {
+                const size_t n = q.pop(buf, 40);
+                UTEST_ASSERT(n == 40);
+                for (size_t i=0; i<n; ++i)
+                    UTEST_ASSERT(buf[i] == popped + i);
+                popped     += n;
+            }
+            UTEST_ASSERT(q.chunks() == chunks);
+        }
+
+        q.flush();
+        UTEST_ASSERT(q.chunks() == 0);
+        UTEST_ASSERT(q.is_empty());
+    }
+
+    void test_concurrent()
+    {
+        printf("Testing concurrent producer and consumer...\n");
+
+        lltl::spsc_queue<uint32_t> q(16);
+        transfer_t t;
+        t.queue     = &q;
+        t.count     = 1000000;
+        t.received  = 0;
+        t.errors    = 0;
+        t.failed    = false;
+
+        lltl::test::thread producer, consumer;
+        UTEST_ASSERT(consumer.start(consumer_main, &t));
+        UTEST_ASSERT(producer.start(producer_main, &t));
+        producer.join();
+        consumer.join();
+
+        UTEST_ASSERT(!t.failed);
+        UTEST_ASSERT_MSG(t.errors == 0, "%d elements received out of order", int(t.errors));
+        UTEST_ASSERT(t.received == t.count);
+        UTEST_ASSERT(q.is_empty());
+    }
+
+    UTEST_MAIN
+    {
+        test_single();
+        test_bulk();
+        test_reserve();
+        test_concurrent();
+    }
+
+UTEST_END
@@ -19,10 +19,20 @@
  * along with lsp-lltl-lib. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <lsp-plug.in/common/atomic.h>
 #include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/lltl/state.h>
 #include <lsp-plug.in/test-fw/utest.h>
 
+#include "../helpers/thread.h"
+
+namespace
+{
+    static constexpr size_t DEFERRED_STATES     = 20000;
+    static constexpr uint32_t MAGIC_ALIVE       = 0x600dcafe;
+    static constexpr uint32_t MAGIC_DEAD        = 0xdeadbeef;
+}
+
 UTEST_BEGIN("lltl", state)
 
     typedef struct state_t
@@ -41,6 +51,52 @@ UTEST_BEGIN("lltl", state)
         st->check      += *value;
     }
 
+    typedef struct dstate_t
+    {
+        uint32_t    magic;          // Poisoned by deleter
+        uint32_t    id;             // Identifier of the state
+        uatomic_t   deleted;        // Number of times the state has been deleted
+    } dstate_t;
+
+    typedef struct deferred_t
+    {
+        lltl::state<dstate_t>  *state;
+        dstate_t               *states;         // States to push
+        dstate_t               *held;           // State currently held by consumer
+        uatomic_t               done;           // Producer has finished
+        uatomic_t               violations;     // Number of states deleted while being held
+        uatomic_t               failed;         // Number of failed push() calls
+        uatomic_t               collected;      // Number of states destroyed by collect()
+    } deferred_t;
+
+    static void poison_state(dstate_t *st, deferred_t *ctx)
+    {
+        if (atomic_load(&ctx->held) == st)
+            atomic_add(&ctx->violations, 1);
+        st->magic       = MAGIC_DEAD;
+        atomic_add(&st->deleted, 1);
+    }
+
+    static void deferred_producer(void *arg)
+    {
+        deferred_t *ctx     = static_cast<deferred_t *>(arg);
+        dstate_t *states    = ctx->states;
+
+        // Push states and collect the garbage concurrently with the consumer
+        for (size_t i=0; i<DEFERRED_STATES; ++i)
+        {
+            if (!ctx->state->push(&states[i]))
+                atomic_add(&ctx->failed, 1);
+            if (!(i & 0x0f))
+            {
+                atomic_add(&ctx->collected, ctx->state->collect());
+                lltl::test::thread::yield();
+            }
+        }
+
+        atomic_store(&ctx->done, 1);
+    }
+
     bool init_states(lltl::darray<state_t> & states)
     {
         for (size_t i=0; i<10; ++i)
@@ -335,6 +391,161 @@ UTEST_BEGIN("lltl", state)
         UTEST_ASSERT(st[6]->check == 0);
     }
 
+    void test_deferred()
+    {
+        printf("Testing test_deferred...\n");
+
+        lltl::darray<state_t> st;
+        UTEST_ASSERT(init_states(st));
+
+        {
+            lltl::state<state_t> state(deleter1);
+            UTEST_ASSERT(!state.is_deferred());
+            UTEST_ASSERT(state.set_deferred(true));
+            UTEST_ASSERT(state.is_deferred());
+
+            // Step 1: push and pull do not call deleter
+            UTEST_ASSERT(state.pull() == NULL);
+            UTEST_ASSERT(state.push(st[0]));
+            UTEST_ASSERT(state.pull() == st[0]);
+            UTEST_ASSERT(state.current() == st[0]);
+            UTEST_ASSERT(state.push(st[1]));
+            UTEST_ASSERT(state.push(st[2]));
+            UTEST_ASSERT(state.pull() == st[2]);
+            UTEST_ASSERT(state.current() == st[2]);
+            UTEST_ASSERT(st[0]->check == 0);
+            UTEST_ASSERT(st[1]->check == 0);
+            UTEST_ASSERT(st[2]->check == 0);
+
+            // Mode can not be changed for non-empty state
+            UTEST_ASSERT(!state.set_deferred(false));
+
+            // Step 2: collect the garbage
+            UTEST_ASSERT(state.collect() == 2);
+            UTEST_ASSERT(st[0]->check == 1);
+            UTEST_ASSERT(st[1]->check == 1);
+            UTEST_ASSERT(st[2]->check == 0);
+            UTEST_ASSERT(state.collect() == 0);
+            UTEST_ASSERT(state.current() == st[2]);
+
+            // Step 3: get() always updates the state
+            UTEST_ASSERT(state.push(st[3]));        // Recycled item
+            UTEST_ASSERT(state.current() == st[2]);
+            UTEST_ASSERT(state.get() == st[3]);
+            UTEST_ASSERT(state.current() == st[3]);
+            UTEST_ASSERT(state.push(st[4]));
+            UTEST_ASSERT(state.get() == st[4]);
+            UTEST_ASSERT(st[2]->check == 0);
+            UTEST_ASSERT(st[3]->check == 0);
+            state.gc();
+            UTEST_ASSERT(st[2]->check == 1);
+            UTEST_ASSERT(st[3]->check == 1);
+            UTEST_ASSERT(st[4]->check == 0);
+
+            // Step 4: set() uses reserved items, collected items are returned to the reserve
+            UTEST_ASSERT(state.set(st[5]));         // Recycled item
+            UTEST_ASSERT(state.set(st[6]));         // Recycled item
+            UTEST_ASSERT(!state.set(st[7]));
+            UTEST_ASSERT(state.reserve(1));
+            UTEST_ASSERT(state.set(st[7]));
+            UTEST_ASSERT(state.get() == st[7]);
+            UTEST_ASSERT(st[5]->check == 0);
+            UTEST_ASSERT(st[6]->check == 0);
+            UTEST_ASSERT(state.collect() == 3);
+            UTEST_ASSERT(st[4]->check == 1);
+            UTEST_ASSERT(st[5]->check == 1);
+            UTEST_ASSERT(st[6]->check == 1);
+            UTEST_ASSERT(st[7]->check == 0);
+
+            // Step 5: keep some garbage for destructor
+            UTEST_ASSERT(state.push(st[8]));
+            UTEST_ASSERT(state.pull() == st[8]);
+            UTEST_ASSERT(state.push(st[9]));
+            UTEST_ASSERT(st[7]->check == 0);
+        }
+
+        for (size_t i=0; i<st.size(); ++i)
+            UTEST_ASSERT(st[i]->check == 1);
+    }
+
+    void test_deferred_concurrent()
+    {
+        printf("Testing test_deferred_concurrent...\n");
+
+        dstate_t *states = static_cast<dstate_t *>(malloc(DEFERRED_STATES * sizeof(dstate_t)));
+        UTEST_ASSERT(states != NULL);
+        lsp_finally { free(states); };
+        for (size_t i=0; i<DEFERRED_STATES; ++i)
+        {
+            states[i].magic     = MAGIC_ALIVE;
+            states[i].id        = i;
+            states[i].deleted   = 0;
+        }
+
+        deferred_t ctx;
+        ctx.states      = states;
+        ctx.held        = NULL;
+        ctx.done        = 0;
+        ctx.violations  = 0;
+        ctx.failed      = 0;
+        ctx.collected   = 0;
+
+        size_t corrupted    = 0;
+        size_t reordered    = 0;
+        size_t reads        = 0;
+
+        {
+            lltl::state<dstate_t> state(poison_state, &ctx);
+            UTEST_ASSERT(state.set_deferred(true));
+            ctx.state       = &state;
+
+            lltl::test::thread producer;
+            UTEST_ASSERT(producer.start(deferred_producer, &ctx));
+
+            // Consumer: the state returned by get() should stay alive until the next get()
+            uint32_t last   = 0;
+            while (true)
+            {
+                const bool done = atomic_load(&ctx.done);
+                dstate_t *st    = state.get();
+                atomic_store(&ctx.held, st);
+                if (st != NULL)
+                {
+                    for (size_t i=0; i<2; ++i)
+                    {
+                        if ((st->magic != MAGIC_ALIVE) || (state.current() != st))
+                        {
+                            ++corrupted;
+                            break;
+                        }
+                        lltl::test::thread::yield();
+                    }
+                    if (st->id < last)
+                        ++reordered;
+                    last            = st->id;
+                    ++reads;
+                }
+                if (done)
+                    break;
+                lltl::test::thread::yield();
+            }
+
+            producer.join();
+            UTEST_ASSERT(state.current() == &states[DEFERRED_STATES - 1]);
+            atomic_store(&ctx.held, static_cast<dstate_t *>(NULL));
+        }
+
+        printf("  performed %d reads, collected %d states\n", int(reads), int(ctx.collected));
+        UTEST_ASSERT(ctx.failed == 0);
+        UTEST_ASSERT_MSG(ctx.violations == 0, "%d states have been deleted while held", int(ctx.violations));
+        UTEST_ASSERT_MSG(corrupted == 0, "%d corrupted states have been observed", int(corrupted));
+        UTEST_ASSERT_MSG(reordered == 0, "%d states have been observed out of order", int(reordered));
+
+        // Each state should be deleted exactly once
+        for (size_t i=0; i<DEFERRED_STATES; ++i)
+            UTEST_ASSERT_MSG(states[i].deleted == 1, "State %d has been deleted %d times", int(i), int(states[i].deleted));
+    }
+
     UTEST_MAIN
     {
         test_push_pull_no_deleter();
@@ -342,6 +553,8 @@ UTEST_BEGIN("lltl", state)
         test_push_pull_deleter2();
         test_push_get();
         test_set_pull();
+        test_deferred();
+        test_deferred_concurrent();
     }
 
 UTEST_END;